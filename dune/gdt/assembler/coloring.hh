@@ -0,0 +1,141 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_ASSEMBLER_COLORING_HH
+#define DUNE_GDT_ASSEMBLER_COLORING_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <dune/common/dynvector.hh>
+
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/gdt/spaces/interface.hh>
+
+namespace Dune {
+namespace GDT {
+
+
+/**
+ * \brief Splits the codim 0 entities of a grid view into colors, such that no two entities of the same color share a
+ *        global DoF of the given space.
+ *
+ *        If include_neighbors is true, the DoFs of all neighbors of an entity are considered to be DoFs of the entity,
+ *        as is required for local assemblers on intersections, which also write into the rows of the neighbor.
+ *        The entities are colored greedily in the order of the grid view, the colors are stored as entity seeds.
+ */
+template< class GridViewImp >
+class EntityColoring
+{
+public:
+  typedef GridViewImp                                        GridViewType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename EntityType::EntitySeed                    EntitySeedType;
+
+  template< class S, size_t d, size_t r, size_t rC >
+  EntityColoring(const GridViewType& grid_view,
+                 const SpaceInterface< S, d, r, rC >& space,
+                 const bool include_neighbors)
+    : include_neighbors_(include_neighbors)
+  {
+    static const size_t colors_per_pass = 64;
+    const auto& mapper = space.mapper();
+    std::vector< EntitySeedType > remaining;
+    remaining.reserve(grid_view.size(0));
+    for (const auto& entity : DSC::entityRange(grid_view))
+      remaining.push_back(entity.seed());
+    // * we mark the colors used by the entities of each DoF in a bitmask, so we can only use colors_per_pass colors at
+    //   once: entities which cannot be colored in one pass are left for the next pass, which uses the next
+    //   colors_per_pass colors
+    std::vector< std::uint64_t > used_colors(mapper.size());
+    Dune::DynamicVector< size_t > global_indices(mapper.maxNumDofs(), 0);
+    std::vector< size_t > footprint;
+    footprint.reserve(mapper.maxNumDofs());
+    size_t first_color_of_pass = 0;
+    while (!remaining.empty()) {
+      std::fill(used_colors.begin(), used_colors.end(), 0);
+      std::vector< EntitySeedType > postponed;
+      for (const auto& seed : remaining) {
+        const auto entity_ptr = grid_view.grid().entity(seed);
+        const auto& entity = *entity_ptr;
+        // collect all DoFs this entity writes to
+        footprint.clear();
+        append_global_indices(mapper, entity, global_indices, footprint);
+        if (include_neighbors_) {
+          const auto intersection_it_end = grid_view.iend(entity);
+          for (auto intersection_it = grid_view.ibegin(entity);
+               intersection_it != intersection_it_end;
+               ++intersection_it) {
+            const auto& intersection = *intersection_it;
+            if (intersection.neighbor()) {
+              const auto neighbor_ptr = intersection.outside();
+              append_global_indices(mapper, *neighbor_ptr, global_indices, footprint);
+            }
+          }
+        }
+        // find the first color not used by any of these DoFs
+        std::uint64_t forbidden = 0;
+        for (const auto& global_index : footprint)
+          forbidden |= used_colors[global_index];
+        if (forbidden == ~std::uint64_t(0)) {
+          postponed.push_back(seed);
+          continue;
+        }
+        size_t color = 0;
+        while (forbidden & (std::uint64_t(1) << color))
+          ++color;
+        for (const auto& global_index : footprint)
+          used_colors[global_index] |= std::uint64_t(1) << color;
+        if (colors_.size() <= first_color_of_pass + color)
+          colors_.resize(first_color_of_pass + color + 1);
+        colors_[first_color_of_pass + color].push_back(seed);
+      }
+      remaining = std::move(postponed);
+      first_color_of_pass += colors_per_pass;
+    }
+  } // EntityColoring(...)
+
+  bool includes_neighbors() const
+  {
+    return include_neighbors_;
+  }
+
+  size_t colors() const
+  {
+    return colors_.size();
+  }
+
+  /// \brief The seeds of all entities of the given color.
+  const std::vector< EntitySeedType >& color(const size_t cc) const
+  {
+    assert(cc < colors_.size());
+    return colors_[cc];
+  }
+
+private:
+  template< class MapperType, class E >
+  static void append_global_indices(const MapperType& mapper,
+                                    const E& entity,
+                                    Dune::DynamicVector< size_t >& global_indices,
+                                    std::vector< size_t >& ret)
+  {
+    const size_t num_dofs = mapper.numDofs(entity);
+    mapper.globalIndices(entity, global_indices);
+    for (size_t ii = 0; ii < num_dofs; ++ii)
+      ret.push_back(global_indices[ii]);
+  }
+
+  const bool include_neighbors_;
+  std::vector< std::vector< EntitySeedType > > colors_;
+}; // class EntityColoring
+
+
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_ASSEMBLER_COLORING_HH
@@ -0,0 +1,147 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_ASSEMBLER_LOCAL_BOUND_SPACE_HH
+#define DUNE_GDT_ASSEMBLER_LOCAL_BOUND_SPACE_HH
+
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+#include <dune/common/dynvector.hh>
+
+namespace Dune {
+namespace GDT {
+namespace LocalAssembler {
+
+
+/**
+ * \brief The base function set and the global indices of a space on one entity, each computed on first access.
+ *
+ *        The SystemAssembler binds one of these (per thread and space) to the current entity and one to the current
+ *        neighbor of its grid walk and hands them to all registered local assemblers, so that the base function sets
+ *        (and global indices) are computed once per entity instead of once per local assembler. The base function set
+ *        is constructed in place, so rebinding does not allocate.
+ */
+template< class SpaceImp >
+class BoundSpace
+{
+public:
+  typedef SpaceImp                                  SpaceType;
+  typedef typename SpaceType::EntityType            EntityType;
+  typedef typename SpaceType::BaseFunctionSetType   BaseFunctionSetType;
+
+  BoundSpace()
+    : space_(nullptr)
+    , entity_(nullptr)
+    , base_bound_(false)
+    , global_indices_bound_(false)
+    , size_(0)
+  {}
+
+  BoundSpace(const SpaceType& space, const EntityType& entity)
+    : BoundSpace()
+  {
+    bind(space, entity);
+  }
+
+  /// \brief Copies the binding only, the base function set and the global indices are recomputed on demand.
+  BoundSpace(const BoundSpace& other)
+    : BoundSpace()
+  {
+    space_ = other.space_;
+    entity_ = other.entity_;
+  }
+
+  BoundSpace& operator=(const BoundSpace& other) = delete;
+
+  ~BoundSpace()
+  {
+    unbind_base();
+  }
+
+  /**
+   * \brief Binds to the given space and entity, both have to outlive this object (or the next bind).
+   */
+  void bind(const SpaceType& space, const EntityType& entity)
+  {
+    space_ = &space;
+    entity_ = &entity;
+    unbind_base();
+    global_indices_bound_ = false;
+  }
+
+  /// \brief Whether this is bound to the given entity object (not only to an entity with the same index).
+  bool is_bound_to(const EntityType& entity) const
+  {
+    return entity_ == &entity;
+  }
+
+  const SpaceType& space() const
+  {
+    assert(space_);
+    return *space_;
+  }
+
+  const EntityType& entity() const
+  {
+    assert(entity_);
+    return *entity_;
+  }
+
+  const BaseFunctionSetType& base() const
+  {
+    if (!base_bound_) {
+      new (&base_storage_) BaseFunctionSetType(space().base_function_set(entity()));
+      base_bound_ = true;
+    }
+    return *reinterpret_cast< const BaseFunctionSetType* >(&base_storage_);
+  }
+
+  /// \brief The first size() entries are the global indices of the DoFs on the entity.
+  const Dune::DynamicVector< size_t >& global_indices() const
+  {
+    if (!global_indices_bound_) {
+      const auto& mapper = space().mapper();
+      if (global_indices_.size() < mapper.maxNumDofs())
+        global_indices_.resize(mapper.maxNumDofs());
+      mapper.globalIndices(entity(), global_indices_);
+      size_ = mapper.numDofs(entity());
+      global_indices_bound_ = true;
+    }
+    return global_indices_;
+  } // ... global_indices(...)
+
+  size_t size() const
+  {
+    global_indices();
+    return size_;
+  }
+
+private:
+  void unbind_base()
+  {
+    if (base_bound_) {
+      reinterpret_cast< BaseFunctionSetType* >(&base_storage_)->~BaseFunctionSetType();
+      base_bound_ = false;
+    }
+  }
+
+  const SpaceType* space_;
+  const EntityType* entity_;
+  mutable typename std::aligned_storage< sizeof(BaseFunctionSetType),
+                                         std::alignment_of< BaseFunctionSetType >::value >::type base_storage_;
+  mutable bool base_bound_;
+  mutable Dune::DynamicVector< size_t > global_indices_;
+  mutable bool global_indices_bound_;
+  mutable size_t size_;
+}; // class BoundSpace
+
+
+} // namespace LocalAssembler
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_ASSEMBLER_LOCAL_BOUND_SPACE_HH
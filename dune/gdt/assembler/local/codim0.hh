@@ -6,10 +6,12 @@
 #ifndef DUNE_GDT_ASSEMLBER_LOCAL_CODIM0_HH
 #define DUNE_GDT_ASSEMLBER_LOCAL_CODIM0_HH
 
+#include <type_traits>
 #include <vector>
 
 #include <dune/common/dynmatrix.hh>
 #include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
 
 #include <dune/stuff/common/memory.hh>
 #include <dune/stuff/common/exceptions.hh>
@@ -23,6 +25,9 @@
 #include <dune/gdt/localfunctional/interface.hh>
 #include <dune/gdt/spaces/interface.hh>
 
+#include "bound-space.hh"
+#include "scatter.hh"
+
 namespace Dune {
 namespace GDT {
 namespace LocalAssembler {
@@ -37,15 +42,30 @@ class Codim0Matrix
 public:
   typedef LocalOperatorImp LocalOperatorType;
 
-  explicit Codim0Matrix(const LocalOperatorType& op)
+  /**
+   * \param storage If MatrixStorage::upper_triangle, only the upper triangle of the global matrix is assembled, which
+   *                requires a symmetric local operator (\sa LocalOperator::is_symmetric) and coinciding test and
+   *                ansatz spaces.
+   */
+  explicit Codim0Matrix(const LocalOperatorType& op, const MatrixStorage storage = MatrixStorage::full)
     : localOperator_(op)
-  {}
+    , storage_(storage)
+  {
+    if (storage_ == MatrixStorage::upper_triangle && !LocalOperator::is_symmetric< LocalOperatorType >::value)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Only the upper triangle of symmetric local operators may be assembled!");
+  }
 
   const LocalOperatorType& localOperator() const
   {
     return localOperator_;
   }
 
+  MatrixStorage storage() const
+  {
+    return storage_;
+  }
+
 private:
   static const size_t numTmpObjectsRequired_ = 1;
 
@@ -72,42 +92,109 @@ public:
                      Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
                      std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
                      std::vector< Dune::DynamicVector< size_t > >& tmpIndicesContainer) const
+  {
+    assembleLocal(BoundSpace< typename T::derived_type >(testSpace.as_imp(), entity),
+                  BoundSpace< typename A::derived_type >(ansatzSpace.as_imp(), entity),
+                  systemMatrix,
+                  tmpLocalMatricesContainer,
+                  tmpIndicesContainer);
+  } // ... assembleLocal(...)
+
+  /**
+   *  \brief Same as above, but with the base function sets and global indices of the spaces already bound to the
+   *         entity (see SystemAssembler).
+   *
+   *         If both spaces have the same number of DoFs on each entity, known at compile time (\sa fixed_num_dofs),
+   *         and the local operator supports this (\sa LocalOperator::supports_fixed_size), the local matrix is a
+   *         Dune::FieldMatrix on the stack instead of the given temporary Dune::DynamicMatrix.
+   */
+  template< class T, class A, class M, class R >
+  void assembleLocal(const BoundSpace< T >& testSpace,
+                     const BoundSpace< A >& ansatzSpace,
+                     Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
+                     std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
+                     std::vector< Dune::DynamicVector< size_t > >& tmpIndicesContainer) const
+  {
+    const auto& localMatrix = apply_local_operator(testSpace,
+                                                   ansatzSpace,
+                                                   tmpLocalMatricesContainer,
+                                                   use_fixed_size< T, A >());
+    // write local matrix to global
+    const size_t cols = ansatzSpace.size();
+    add_local_to_global(localMatrix, testSpace.global_indices(), testSpace.size(), ansatzSpace.global_indices(), cols,
+                        internal::permutation_storage(tmpIndicesContainer, 2, cols),
+                        systemMatrix,
+                        storage_);
+  } // ... assembleLocal(...)
+
+  /**
+   *  \brief Same as above, but the local matrix is added directly to the values of systemMatrix at the given offsets
+   *         (\sa ScatterOffsets::local()), without looking up any entry in the pattern of systemMatrix.
+   */
+  template< class T, class A, class M, class R >
+  void assembleLocal(const BoundSpace< T >& testSpace,
+                     const BoundSpace< A >& ansatzSpace,
+                     const size_t* offsets,
+                     Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
+                     std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer) const
+  {
+    const auto& localMatrix = apply_local_operator(testSpace,
+                                                   ansatzSpace,
+                                                   tmpLocalMatricesContainer,
+                                                   use_fixed_size< T, A >());
+    add_local_to_global(localMatrix, testSpace.size(), ansatzSpace.size(), offsets, systemMatrix);
+  } // ... assembleLocal(...)
+
+private:
+  template< class T, class A >
+  struct use_fixed_size
+    : public std::integral_constant< bool, (fixed_num_dofs< T >::value > 0)
+                                           && fixed_num_dofs< A >::value == fixed_num_dofs< T >::value
+                                           && LocalOperator::supports_fixed_size< LocalOperatorType >::value >
+  {};
+
+  /// \brief Returns the local matrix, which is one of the given temporary matrices.
+  template< class T, class A, class R >
+  const Dune::DynamicMatrix< R >&
+  apply_local_operator(const BoundSpace< T >& testSpace,
+                       const BoundSpace< A >& ansatzSpace,
+                       std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
+                       std::false_type) const
   {
     // check
     assert(tmpLocalMatricesContainer.size() >= 1);
     assert(tmpLocalMatricesContainer[0].size() >= numTmpObjectsRequired_);
     assert(tmpLocalMatricesContainer[1].size() >= localOperator_.numTmpObjectsRequired());
-    assert(tmpIndicesContainer.size() >= 2);
     // get and clear matrix
     auto& localMatrix = tmpLocalMatricesContainer[0][0];
     localMatrix *= 0.0;
     auto& tmpOperatorMatrices = tmpLocalMatricesContainer[1];
     // apply local operator (result is in localMatrix)
-    localOperator_.apply(testSpace.base_function_set(entity),
-                         ansatzSpace.base_function_set(entity),
-                         localMatrix,
-                         tmpOperatorMatrices);
-    // write local matrix to global
-    auto& globalRows = tmpIndicesContainer[0];
-    auto& globalCols = tmpIndicesContainer[1];
-    const size_t rows = testSpace.mapper().numDofs(entity);
-    const size_t cols = ansatzSpace.mapper().numDofs(entity);
-    assert(globalRows.size() >= rows);
-    assert(globalCols.size() >= cols);
-    testSpace.mapper().globalIndices(entity, globalRows);
-    ansatzSpace.mapper().globalIndices(entity, globalCols);
-    for (size_t ii = 0; ii < rows; ++ii) {
-      const auto& localRow = localMatrix[ii];
-      const size_t globalII = globalRows[ii];
-      for (size_t jj = 0; jj < cols; ++jj) {
-        const size_t globalJJ = globalCols[jj];
-        systemMatrix.add_to_entry(globalII, globalJJ, localRow[jj]);
-      }
-    } // write local matrix to global
-  } // ... assembleLocal(...)
+    localOperator_.apply(testSpace.base(), ansatzSpace.base(), localMatrix, tmpOperatorMatrices);
+    return localMatrix;
+  } // ... apply_local_operator(...)
+
+  /// \brief Returns the local matrix, which lives on the stack.
+  template< class T, class A, class R >
+  Dune::FieldMatrix< R, fixed_num_dofs< T >::value, fixed_num_dofs< T >::value >
+  apply_local_operator(const BoundSpace< T >& testSpace,
+                       const BoundSpace< A >& ansatzSpace,
+                       std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
+                       std::true_type) const
+  {
+    static const size_t size = fixed_num_dofs< T >::value;
+    assert(testSpace.size() == size);
+    assert(ansatzSpace.size() == size);
+    assert(tmpLocalMatricesContainer.size() >= 1);
+    assert(tmpLocalMatricesContainer[1].size() >= localOperator_.numTmpObjectsRequired());
+    // apply local operator (result is in localMatrix, which is cleared by the local operator)
+    Dune::FieldMatrix< R, size, size > localMatrix;
+    localOperator_.apply(testSpace.base(), ansatzSpace.base(), localMatrix, tmpLocalMatricesContainer[1]);
+    return localMatrix;
+  } // ... apply_local_operator(...)
 
-private:
   const LocalOperatorType& localOperator_;
+  const MatrixStorage storage_;
 }; // class Codim0Matrix
 
 
@@ -152,7 +239,21 @@ public:
                      const EntityType& entity,
                      Dune::Stuff::LA::VectorInterface< V, R >& systemVector,
                      std::vector< std::vector< Dune::DynamicVector< R > > >& tmpLocalVectorContainer,
-                     Dune::DynamicVector< size_t >& tmpIndices) const
+                     Dune::DynamicVector< size_t >& /*tmpIndices*/) const
+  {
+    assembleLocal(BoundSpace< typename T::derived_type >(testSpace.as_imp(), entity),
+                  systemVector,
+                  tmpLocalVectorContainer);
+  } // ... assembleLocal(...)
+
+  /**
+   *  \brief Same as above, but with the base function set and global indices of the space already bound to the
+   *         entity (see SystemAssembler).
+   */
+  template< class T, class V, class R >
+  void assembleLocal(const BoundSpace< T >& testSpace,
+                     Dune::Stuff::LA::VectorInterface< V, R >& systemVector,
+                     std::vector< std::vector< Dune::DynamicVector< R > > >& tmpLocalVectorContainer) const
   {
     // check
     assert(tmpLocalVectorContainer.size() >= 2);
@@ -163,15 +264,12 @@ public:
     localVector *= 0.0;
     auto& tmpFunctionalVectors = tmpLocalVectorContainer[1];
     // apply local functional (result is in localVector)
-    localFunctional_.apply(testSpace.base_function_set(entity),
-                           localVector,
-                           tmpFunctionalVectors);
+    localFunctional_.apply(testSpace.base(), localVector, tmpFunctionalVectors);
     // write local vector to global
-    const size_t size = testSpace.mapper().numDofs(entity);
-    assert(tmpIndices.size() >= size);
-    testSpace.mapper().globalIndices(entity, tmpIndices);
+    const auto& globalIndices = testSpace.global_indices();
+    const size_t size = testSpace.size();
     for (size_t ii = 0; ii < size; ++ii) {
-      systemVector.add_to_entry(tmpIndices[ii], localVector[ii]);
+      systemVector.add_to_entry(globalIndices[ii], localVector[ii]);
     } // write local matrix to global
   } // ... assembleLocal(...)
 
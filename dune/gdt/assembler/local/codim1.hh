@@ -6,8 +6,11 @@
 #ifndef DUNE_GDT_ASSEMLBER_LOCAL_CODIM1_HH
 #define DUNE_GDT_ASSEMLBER_LOCAL_CODIM1_HH
 
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 
+#include <dune/stuff/common/exceptions.hh>
 #include <dune/stuff/common/timedlogging.hh>
 #include <dune/stuff/la/container/interfaces.hh>
 #include <dune/stuff/grid/boundaryinfo.hh>
@@ -18,6 +21,9 @@
 #include <dune/gdt/localfunctional/interface.hh>
 #include <dune/gdt/spaces/interface.hh>
 
+#include "bound-space.hh"
+#include "scatter.hh"
+
 namespace Dune {
 namespace GDT {
 namespace LocalAssembler {
@@ -32,15 +38,30 @@ class Codim1CouplingMatrix
 public:
   typedef LocalOperatorImp LocalOperatorType;
 
-  explicit Codim1CouplingMatrix(const LocalOperatorType& op)
+  /**
+   * \param storage If MatrixStorage::upper_triangle, only the upper triangle of the global matrix is assembled, which
+   *                requires a symmetric local operator (\sa LocalOperator::is_symmetric) and coinciding test and
+   *                ansatz spaces.
+   */
+  explicit Codim1CouplingMatrix(const LocalOperatorType& op, const MatrixStorage storage = MatrixStorage::full)
     : localOperator_(op)
-  {}
+    , storage_(storage)
+  {
+    if (storage_ == MatrixStorage::upper_triangle && !LocalOperator::is_symmetric< LocalOperatorType >::value)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Only the upper triangle of symmetric local operators may be assembled!");
+  }
 
   const LocalOperatorType& localOperator() const
   {
     return localOperator_;
   }
 
+  MatrixStorage storage() const
+  {
+    return storage_;
+  }
+
 private:
   static const size_t numTmpObjectsRequired_ = 4;
 
@@ -67,52 +88,52 @@ public:
                      std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
                      std::vector< Dune::DynamicVector< size_t > >& tmpIndicesContainer) const
   {
-    // check
-    assert(tmpLocalMatricesContainer.size() >= 2);
-    assert(tmpLocalMatricesContainer[0].size() >= numTmpObjectsRequired_);
-    assert(tmpLocalMatricesContainer[1].size() >= localOperator_.numTmpObjectsRequired());
-    assert(tmpIndicesContainer.size() >= 4);
-    // get and clear matrix
-    auto& localEntityEntityMatrix = tmpLocalMatricesContainer[0][0];
-    auto& localNeighborNeighborMatrix = tmpLocalMatricesContainer[0][1];
-    auto& localEntityNeighborMatrix = tmpLocalMatricesContainer[0][2];
-    auto& localNeighborEntityMatrix = tmpLocalMatricesContainer[0][3];
-    localEntityEntityMatrix *= 0.0;
-    localNeighborNeighborMatrix *= 0.0;
-    localEntityNeighborMatrix *= 0.0;
-    localNeighborEntityMatrix *= 0.0;
-    auto& tmpOperatorMatrices = tmpLocalMatricesContainer[1];
-    // get entities
     const auto entityPtr = intersection.inside();
-    const auto& entity = *entityPtr;
     const auto neighborPtr = intersection.outside();
-    const auto& neighbor = *neighborPtr;
-    // apply local operator (results are in local*Matrix)
-    localOperator_.apply(testSpaceEntity.base_function_set(entity), ansatzSpaceEntity.base_function_set(entity),
-                         testSpaceNeighbor.base_function_set(neighbor), ansatzSpaceNeighbor.base_function_set(neighbor),
-                         intersection,
-                         localEntityEntityMatrix,
-                         localNeighborNeighborMatrix,
-                         localEntityNeighborMatrix,
-                         localNeighborEntityMatrix,
-                         tmpOperatorMatrices);
+    assembleLocal(BoundSpace< typename TE::derived_type >(testSpaceEntity.as_imp(), *entityPtr),
+                  BoundSpace< typename AE::derived_type >(ansatzSpaceEntity.as_imp(), *entityPtr),
+                  BoundSpace< typename TN::derived_type >(testSpaceNeighbor.as_imp(), *neighborPtr),
+                  BoundSpace< typename AN::derived_type >(ansatzSpaceNeighbor.as_imp(), *neighborPtr),
+                  intersection,
+                  entityEntityMatrix, neighborNeighborMatrix, entityNeighborMatrix, neighborEntityMatrix,
+                  tmpLocalMatricesContainer,
+                  tmpIndicesContainer);
+  } // void assembleLocal(...) const
+
+  /**
+   *  \brief Same as above, but with the base function sets and global indices of the spaces already bound to the
+   *         inside (*Entity) and outside (*Neighbor) entity of the intersection (see SystemAssembler).
+   */
+  template< class TE, class AE, class TN, class AN, class IntersectionType, class MEE, class MNN, class MEN, class MNE,
+            class R >
+  void assembleLocal(const BoundSpace< TE >& testSpaceEntity,
+                     const BoundSpace< AE >& ansatzSpaceEntity,
+                     const BoundSpace< TN >& testSpaceNeighbor,
+                     const BoundSpace< AN >& ansatzSpaceNeighbor,
+                     const IntersectionType& intersection,
+                     Dune::Stuff::LA::MatrixInterface< MEE, R >& entityEntityMatrix,
+                     Dune::Stuff::LA::MatrixInterface< MNN, R >& neighborNeighborMatrix,
+                     Dune::Stuff::LA::MatrixInterface< MEN, R >& entityNeighborMatrix,
+                     Dune::Stuff::LA::MatrixInterface< MNE, R >& neighborEntityMatrix,
+                     std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
+                     std::vector< Dune::DynamicVector< size_t > >& tmpIndicesContainer) const
+  {
+    compute_local_matrices(testSpaceEntity, ansatzSpaceEntity, testSpaceNeighbor, ansatzSpaceNeighbor,
+                           intersection,
+                           tmpLocalMatricesContainer);
+    const auto& localEntityEntityMatrix = tmpLocalMatricesContainer[0][0];
+    const auto& localNeighborNeighborMatrix = tmpLocalMatricesContainer[0][1];
+    const auto& localEntityNeighborMatrix = tmpLocalMatricesContainer[0][2];
+    const auto& localNeighborEntityMatrix = tmpLocalMatricesContainer[0][3];
     // write local matrices to global
-    const size_t rowsEn = testSpaceEntity.mapper().numDofs(entity);
-    const size_t colsEn = ansatzSpaceEntity.mapper().numDofs(entity);
-    const size_t rowsNe = testSpaceNeighbor.mapper().numDofs(neighbor);
-    const size_t colsNe = ansatzSpaceNeighbor.mapper().numDofs(neighbor);
-    auto& globalRowsEn = tmpIndicesContainer[0];
-    auto& globalColsEn = tmpIndicesContainer[1];
-    auto& globalRowsNe = tmpIndicesContainer[2];
-    auto& globalColsNe = tmpIndicesContainer[3];
-    assert(globalRowsEn.size() >= rowsEn);
-    assert(globalColsEn.size() >= colsEn);
-    assert(globalRowsNe.size() >= rowsNe);
-    assert(globalColsNe.size() >= colsNe);
-    testSpaceEntity.mapper().globalIndices(entity, globalRowsEn);
-    ansatzSpaceEntity.mapper().globalIndices(entity, globalColsEn);
-    testSpaceNeighbor.mapper().globalIndices(neighbor, globalRowsNe);
-    ansatzSpaceNeighbor.mapper().globalIndices(neighbor, globalColsNe);
+    const size_t rowsEn = testSpaceEntity.size();
+    const size_t colsEn = ansatzSpaceEntity.size();
+    const size_t rowsNe = testSpaceNeighbor.size();
+    const size_t colsNe = ansatzSpaceNeighbor.size();
+    const auto& globalRowsEn = testSpaceEntity.global_indices();
+    const auto& globalColsEn = ansatzSpaceEntity.global_indices();
+    const auto& globalRowsNe = testSpaceNeighbor.global_indices();
+    const auto& globalColsNe = ansatzSpaceNeighbor.global_indices();
     assert(localEntityEntityMatrix.rows() >= rowsEn);
     assert(localEntityEntityMatrix.cols() >= colsEn);
     assert(localNeighborNeighborMatrix.rows() >= rowsNe);
@@ -121,32 +142,44 @@ public:
     assert(localEntityNeighborMatrix.cols() >= colsNe);
     assert(localNeighborEntityMatrix.rows() >= rowsNe);
     assert(localNeighborEntityMatrix.cols() >= colsEn);
-    for (size_t ii = 0; ii < rowsEn; ++ii) {
-      const auto& localEntityEntityMatrixRow = localEntityEntityMatrix[ii];
-      const auto& localEntityNeighborMatrixRow = localEntityNeighborMatrix[ii];
-      const size_t globalII = globalRowsEn[ii];
-      for (size_t jj = 0; jj < colsEn; ++jj) {
-        const size_t globalJJ = globalColsEn[jj];
-        entityEntityMatrix.add_to_entry(globalII, globalJJ, localEntityEntityMatrixRow[jj]);
-      }
-      for (size_t jj = 0; jj < colsNe; ++jj) {
-        const size_t globalJJ = globalColsNe[jj];
-        entityNeighborMatrix.add_to_entry(globalII, globalJJ, localEntityNeighborMatrixRow[jj]);
-      }
-    }
-    for (size_t ii = 0; ii < rowsNe; ++ii) {
-      const auto& localNeighborEntityMatrixRow = localNeighborEntityMatrix[ii];
-      const auto& localNeighborNeighborMatrixRow = localNeighborNeighborMatrix[ii];
-      const size_t globalII = globalRowsNe[ii];
-      for (size_t jj = 0; jj < colsEn; ++jj) {
-        const size_t globalJJ = globalColsEn[jj];
-        neighborEntityMatrix.add_to_entry(globalII, globalJJ, localNeighborEntityMatrixRow[jj]);
-      }
-      for (size_t jj = 0; jj < colsNe; ++jj) {
-        const size_t globalJJ = globalColsNe[jj];
-        neighborNeighborMatrix.add_to_entry(globalII, globalJJ, localNeighborNeighborMatrixRow[jj]);
-      }
-    }
+    auto& tmpPermutation = internal::permutation_storage(tmpIndicesContainer, 4, std::max(colsEn, colsNe));
+    add_local_to_global(localEntityEntityMatrix, globalRowsEn, rowsEn, globalColsEn, colsEn, tmpPermutation,
+                        entityEntityMatrix, storage_);
+    add_local_to_global(localEntityNeighborMatrix, globalRowsEn, rowsEn, globalColsNe, colsNe, tmpPermutation,
+                        entityNeighborMatrix, storage_);
+    add_local_to_global(localNeighborEntityMatrix, globalRowsNe, rowsNe, globalColsEn, colsEn, tmpPermutation,
+                        neighborEntityMatrix, storage_);
+    add_local_to_global(localNeighborNeighborMatrix, globalRowsNe, rowsNe, globalColsNe, colsNe, tmpPermutation,
+                        neighborNeighborMatrix, storage_);
+  } // void assembleLocal(...) const
+
+  /**
+   *  \brief Same as above, but the four local matrices are added directly to the values of systemMatrix at the given
+   *         offsets (\sa ScatterOffsets::coupling()), without looking up any entry in the pattern of systemMatrix.
+   */
+  template< class TE, class AE, class TN, class AN, class IntersectionType, class CouplingOffsetsType, class M,
+            class R >
+  void assembleLocal(const BoundSpace< TE >& testSpaceEntity,
+                     const BoundSpace< AE >& ansatzSpaceEntity,
+                     const BoundSpace< TN >& testSpaceNeighbor,
+                     const BoundSpace< AN >& ansatzSpaceNeighbor,
+                     const IntersectionType& intersection,
+                     const CouplingOffsetsType& offsets,
+                     Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
+                     std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer) const
+  {
+    compute_local_matrices(testSpaceEntity, ansatzSpaceEntity, testSpaceNeighbor, ansatzSpaceNeighbor,
+                           intersection,
+                           tmpLocalMatricesContainer);
+    const size_t rowsEn = testSpaceEntity.size();
+    const size_t colsEn = ansatzSpaceEntity.size();
+    const size_t rowsNe = testSpaceNeighbor.size();
+    const size_t colsNe = ansatzSpaceNeighbor.size();
+    const auto& localMatrices = tmpLocalMatricesContainer[0];
+    add_local_to_global(localMatrices[0], rowsEn, colsEn, offsets.entity_entity, systemMatrix);
+    add_local_to_global(localMatrices[1], rowsNe, colsNe, offsets.neighbor_neighbor, systemMatrix);
+    add_local_to_global(localMatrices[2], rowsEn, colsNe, offsets.entity_neighbor, systemMatrix);
+    add_local_to_global(localMatrices[3], rowsNe, colsEn, offsets.neighbor_entity, systemMatrix);
   } // void assembleLocal(...) const
 
   template< class T, size_t Td, size_t Tr, size_t TrC,
@@ -167,7 +200,111 @@ public:
   } // void assembleLocal(...) const
 
 private:
+  /// \brief Clears the local matrices and applies the local operator, the results are in tmpLocalMatricesContainer[0].
+  template< class TE, class AE, class TN, class AN, class IntersectionType, class R >
+  void compute_local_matrices(const BoundSpace< TE >& testSpaceEntity,
+                              const BoundSpace< AE >& ansatzSpaceEntity,
+                              const BoundSpace< TN >& testSpaceNeighbor,
+                              const BoundSpace< AN >& ansatzSpaceNeighbor,
+                              const IntersectionType& intersection,
+                              std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer) const
+  {
+    // check
+    assert(tmpLocalMatricesContainer.size() >= 2);
+    assert(tmpLocalMatricesContainer[0].size() >= numTmpObjectsRequired_);
+    assert(tmpLocalMatricesContainer[1].size() >= localOperator_.numTmpObjectsRequired());
+    // get and clear matrix
+    auto& localEntityEntityMatrix = tmpLocalMatricesContainer[0][0];
+    auto& localNeighborNeighborMatrix = tmpLocalMatricesContainer[0][1];
+    auto& localEntityNeighborMatrix = tmpLocalMatricesContainer[0][2];
+    auto& localNeighborEntityMatrix = tmpLocalMatricesContainer[0][3];
+    localEntityEntityMatrix *= 0.0;
+    localNeighborNeighborMatrix *= 0.0;
+    localEntityNeighborMatrix *= 0.0;
+    localNeighborEntityMatrix *= 0.0;
+    auto& tmpOperatorMatrices = tmpLocalMatricesContainer[1];
+    // apply local operator (results are in local*Matrix)
+    apply_local_operator(testSpaceEntity, ansatzSpaceEntity, testSpaceNeighbor, ansatzSpaceNeighbor,
+                         intersection,
+                         localEntityEntityMatrix,
+                         localNeighborNeighborMatrix,
+                         localEntityNeighborMatrix,
+                         localNeighborEntityMatrix,
+                         tmpOperatorMatrices,
+                         std::integral_constant< bool, LocalOperator::is_symmetric< LocalOperatorType >::value >());
+  } // ... compute_local_matrices(...)
+
+  template< class TE, class AE, class TN, class AN, class IntersectionType, class R >
+  void apply_local_operator(const BoundSpace< TE >& testSpaceEntity,
+                            const BoundSpace< AE >& ansatzSpaceEntity,
+                            const BoundSpace< TN >& testSpaceNeighbor,
+                            const BoundSpace< AN >& ansatzSpaceNeighbor,
+                            const IntersectionType& intersection,
+                            Dune::DynamicMatrix< R >& localEntityEntityMatrix,
+                            Dune::DynamicMatrix< R >& localNeighborNeighborMatrix,
+                            Dune::DynamicMatrix< R >& localEntityNeighborMatrix,
+                            Dune::DynamicMatrix< R >& localNeighborEntityMatrix,
+                            std::vector< Dune::DynamicMatrix< R > >& tmpOperatorMatrices,
+                            std::false_type) const
+  {
+    localOperator_.apply(testSpaceEntity.base(), ansatzSpaceEntity.base(),
+                         testSpaceNeighbor.base(), ansatzSpaceNeighbor.base(),
+                         intersection,
+                         localEntityEntityMatrix,
+                         localNeighborNeighborMatrix,
+                         localEntityNeighborMatrix,
+                         localNeighborEntityMatrix,
+                         tmpOperatorMatrices);
+  } // ... apply_local_operator(...)
+
+  /**
+   * \brief If only the upper triangle is assembled, the neighborEntity block is not computed by the local operator but
+   *        transposed from the entityNeighbor block.
+   */
+  template< class TE, class AE, class TN, class AN, class IntersectionType, class R >
+  void apply_local_operator(const BoundSpace< TE >& testSpaceEntity,
+                            const BoundSpace< AE >& ansatzSpaceEntity,
+                            const BoundSpace< TN >& testSpaceNeighbor,
+                            const BoundSpace< AN >& ansatzSpaceNeighbor,
+                            const IntersectionType& intersection,
+                            Dune::DynamicMatrix< R >& localEntityEntityMatrix,
+                            Dune::DynamicMatrix< R >& localNeighborNeighborMatrix,
+                            Dune::DynamicMatrix< R >& localEntityNeighborMatrix,
+                            Dune::DynamicMatrix< R >& localNeighborEntityMatrix,
+                            std::vector< Dune::DynamicMatrix< R > >& tmpOperatorMatrices,
+                            std::true_type) const
+  {
+    if (storage_ != MatrixStorage::upper_triangle) {
+      apply_local_operator(testSpaceEntity, ansatzSpaceEntity, testSpaceNeighbor, ansatzSpaceNeighbor,
+                           intersection,
+                           localEntityEntityMatrix,
+                           localNeighborNeighborMatrix,
+                           localEntityNeighborMatrix,
+                           localNeighborEntityMatrix,
+                           tmpOperatorMatrices,
+                           std::false_type());
+      return;
+    }
+    localOperator_.apply_symmetric(testSpaceEntity.base(), ansatzSpaceEntity.base(),
+                                   testSpaceNeighbor.base(), ansatzSpaceNeighbor.base(),
+                                   intersection,
+                                   localEntityEntityMatrix,
+                                   localNeighborNeighborMatrix,
+                                   localEntityNeighborMatrix,
+                                   tmpOperatorMatrices);
+    const size_t rowsEn = testSpaceEntity.size();
+    const size_t rowsNe = testSpaceNeighbor.size();
+    assert(ansatzSpaceEntity.size() == rowsEn);
+    assert(ansatzSpaceNeighbor.size() == rowsNe);
+    assert(localNeighborEntityMatrix.rows() >= rowsNe);
+    assert(localNeighborEntityMatrix.cols() >= rowsEn);
+    for (size_t ii = 0; ii < rowsNe; ++ii)
+      for (size_t jj = 0; jj < rowsEn; ++jj)
+        localNeighborEntityMatrix[ii][jj] = localEntityNeighborMatrix[jj][ii];
+  } // ... apply_local_operator(...)
+
   const LocalOperatorType& localOperator_;
+  const MatrixStorage storage_;
 }; // class Codim1CouplingMatrix
 
 
@@ -180,15 +317,30 @@ class Codim1BoundaryMatrix
 public:
   typedef LocalOperatorImp LocalOperatorType;
 
-  explicit Codim1BoundaryMatrix(const LocalOperatorType& op)
+  /**
+   * \param storage If MatrixStorage::upper_triangle, only the upper triangle of the global matrix is assembled, which
+   *                requires a symmetric local operator (\sa LocalOperator::is_symmetric) and coinciding test and
+   *                ansatz spaces.
+   */
+  explicit Codim1BoundaryMatrix(const LocalOperatorType& op, const MatrixStorage storage = MatrixStorage::full)
     : localOperator_(op)
-  {}
+    , storage_(storage)
+  {
+    if (storage_ == MatrixStorage::upper_triangle && !LocalOperator::is_symmetric< LocalOperatorType >::value)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Only the upper triangle of symmetric local operators may be assembled!");
+  }
 
   const LocalOperatorType& localOperator() const
   {
     return localOperator_;
   }
 
+  MatrixStorage storage() const
+  {
+    return storage_;
+  }
+
 private:
   static const size_t numTmpObjectsRequired_ = 1;
 
@@ -207,46 +359,83 @@ public:
                      Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
                      std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
                      std::vector< Dune::DynamicVector< size_t > >& tmpIndicesContainer) const
+  {
+    const auto entityPtr = intersection.inside();
+    assembleLocal(BoundSpace< typename T::derived_type >(testSpace.as_imp(), *entityPtr),
+                  BoundSpace< typename A::derived_type >(ansatzSpace.as_imp(), *entityPtr),
+                  intersection,
+                  systemMatrix,
+                  tmpLocalMatricesContainer,
+                  tmpIndicesContainer);
+  } // void assembleLocal(...) const
+
+  /**
+   *  \brief Same as above, but with the base function sets and global indices of the spaces already bound to the
+   *         inside entity of the intersection (see SystemAssembler).
+   */
+  template< class T, class A, class IntersectionType, class M, class R >
+  void assembleLocal(const BoundSpace< T >& testSpace,
+                     const BoundSpace< A >& ansatzSpace,
+                     const IntersectionType& intersection,
+                     Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
+                     std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer,
+                     std::vector< Dune::DynamicVector< size_t > >& tmpIndicesContainer) const
+  {
+    const auto& localMatrix = apply_local_operator(testSpace, ansatzSpace, intersection, tmpLocalMatricesContainer);
+    // write local matrices to global
+    const size_t rows = testSpace.size();
+    const size_t cols = ansatzSpace.size();
+    assert(localMatrix.size() >= rows);
+    assert(localMatrix.size() >= cols);
+    add_local_to_global(localMatrix, testSpace.global_indices(), rows, ansatzSpace.global_indices(), cols,
+                        internal::permutation_storage(tmpIndicesContainer, 2, cols),
+                        systemMatrix,
+                        storage_);
+  } // void assembleLocal(...) const
+
+  /**
+   *  \brief Same as above, but the local matrix is added directly to the values of systemMatrix at the given offsets
+   *         of the inside entity (\sa ScatterOffsets::local()), without looking up any entry in the pattern of
+   *         systemMatrix.
+   */
+  template< class T, class A, class IntersectionType, class M, class R >
+  void assembleLocal(const BoundSpace< T >& testSpace,
+                     const BoundSpace< A >& ansatzSpace,
+                     const IntersectionType& intersection,
+                     const size_t* offsets,
+                     Dune::Stuff::LA::MatrixInterface< M, R >& systemMatrix,
+                     std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer) const
+  {
+    const auto& localMatrix = apply_local_operator(testSpace, ansatzSpace, intersection, tmpLocalMatricesContainer);
+    add_local_to_global(localMatrix, testSpace.size(), ansatzSpace.size(), offsets, systemMatrix);
+  }
+
+private:
+  /// \brief Returns the local matrix, which is one of the given temporary matrices.
+  template< class T, class A, class IntersectionType, class R >
+  const Dune::DynamicMatrix< R >&
+  apply_local_operator(const BoundSpace< T >& testSpace,
+                       const BoundSpace< A >& ansatzSpace,
+                       const IntersectionType& intersection,
+                       std::vector< std::vector< Dune::DynamicMatrix< R > > >& tmpLocalMatricesContainer) const
   {
     // check
     assert(tmpLocalMatricesContainer.size() >= 2);
     assert(tmpLocalMatricesContainer[0].size() >= numTmpObjectsRequired_);
     assert(tmpLocalMatricesContainer[1].size() >= localOperator_.numTmpObjectsRequired());
-    assert(tmpIndicesContainer.size() >= 2);
     // get and clear matrix
     auto& localMatrix = tmpLocalMatricesContainer[0][0];
     localMatrix *= 0.0;
     auto& tmpOperatorMatrices = tmpLocalMatricesContainer[1];
-    // get entity
-    const auto entityPtr = intersection.inside();
-    const auto& entity = *entityPtr;
     // apply local operator (results are in local*Matrix)
-    localOperator_.apply(testSpace.base_function_set(entity), ansatzSpace.base_function_set(entity),
+    localOperator_.apply(testSpace.base(), ansatzSpace.base(),
                          intersection,
                          localMatrix, tmpOperatorMatrices);
-    // write local matrices to global
-    const size_t rows = testSpace.mapper().numDofs(entity);
-    const size_t cols = ansatzSpace.mapper().numDofs(entity);
-    auto& globalRows = tmpIndicesContainer[0];
-    auto& globalCols = tmpIndicesContainer[1];
-    assert(globalRows.size() >= rows);
-    assert(globalCols.size() >= cols);
-    assert(localMatrix.size() >= rows);
-    assert(localMatrix.size() >= cols);
-    testSpace.mapper().globalIndices(entity, globalRows);
-    ansatzSpace.mapper().globalIndices(entity, globalCols);
-    for (size_t ii = 0; ii < rows; ++ii) {
-      const auto& localMatrixRow = localMatrix[ii];
-      const size_t globalII = globalRows[ii];
-      for (size_t jj = 0; jj < cols; ++jj) {
-        const size_t globalJJ = globalCols[jj];
-        systemMatrix.add_to_entry(globalII, globalJJ, localMatrixRow[jj]);
-      }
-    }
-  } // void assembleLocal(...) const
+    return localMatrix;
+  } // ... apply_local_operator(...)
 
-private:
   const LocalOperatorType& localOperator_;
+  const MatrixStorage storage_;
 }; // class Codim1BoundaryMatrix
 
 
@@ -282,7 +471,24 @@ public:
                      const IntersectionType& intersection,
                      Dune::Stuff::LA::VectorInterface< V, R >& systemVector,
                      std::vector< std::vector< Dune::DynamicVector< R > > >& tmpLocalVectorsContainer,
-                     Dune::DynamicVector< size_t >& tmpIndicesContainer) const
+                     Dune::DynamicVector< size_t >& /*tmpIndicesContainer*/) const
+  {
+    const auto entityPtr = intersection.inside();
+    assembleLocal(BoundSpace< typename T::derived_type >(testSpace.as_imp(), *entityPtr),
+                  intersection,
+                  systemVector,
+                  tmpLocalVectorsContainer);
+  } // void assembleLocal(...) const
+
+  /**
+   *  \brief Same as above, but with the base function set and global indices of the space already bound to the
+   *         inside entity of the intersection (see SystemAssembler).
+   */
+  template< class T, class IntersectionType, class V, class R >
+  void assembleLocal(const BoundSpace< T >& testSpace,
+                     const IntersectionType& intersection,
+                     Dune::Stuff::LA::VectorInterface< V, R >& systemVector,
+                     std::vector< std::vector< Dune::DynamicVector< R > > >& tmpLocalVectorsContainer) const
   {
     // check
     assert(tmpLocalVectorsContainer.size() >= 2);
@@ -292,18 +498,14 @@ public:
     auto& localVector = tmpLocalVectorsContainer[0][0];
     localVector *= 0.0;
     auto& tmpFunctionalVectors = tmpLocalVectorsContainer[1];
-    // get entity
-    const auto entityPtr = intersection.inside();
-    const auto& entity = *entityPtr;
     // apply local functional (results are in localVector)
-    localFunctional_.apply(testSpace.base_function_set(entity), intersection, localVector, tmpFunctionalVectors);
+    localFunctional_.apply(testSpace.base(), intersection, localVector, tmpFunctionalVectors);
     // write local vectors to global
-    const size_t size = testSpace.mapper().numDofs(entity);
-    assert(tmpIndicesContainer.size() >= size);
+    const size_t size = testSpace.size();
+    const auto& globalIndices = testSpace.global_indices();
     assert(localVector.size() >= size);
-    testSpace.mapper().globalIndices(entity, tmpIndicesContainer);
     for (size_t ii = 0; ii < size; ++ii) {
-      const size_t globalII = tmpIndicesContainer[ii];
+      const size_t globalII = globalIndices[ii];
       systemVector.add_to_entry(globalII, localVector[ii]);
     }
   } // void assembleLocal(...) const
@@ -0,0 +1,394 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_ASSEMBLER_LOCAL_SCATTER_HH
+#define DUNE_GDT_ASSEMBLER_LOCAL_SCATTER_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <dune/common/dynvector.hh>
+
+#include <dune/stuff/la/container/interfaces.hh>
+#include <dune/stuff/la/container/eigen.hh>
+#include <dune/stuff/la/container/istl.hh>
+
+#include <dune/gdt/assembler/symmetric.hh>
+#include <dune/gdt/la/istl-block.hh>
+
+namespace Dune {
+namespace GDT {
+namespace LocalAssembler {
+namespace internal {
+
+
+/**
+ * \brief Fills the first size entries of permutation with 0, ..., size - 1, sorted such that
+ *        indices[permutation[0]] <= indices[permutation[1]] <= ...
+ */
+inline void sort_permutation(const Dune::DynamicVector< size_t >& indices,
+                             const size_t size,
+                             Dune::DynamicVector< size_t >& permutation)
+{
+  assert(indices.size() >= size);
+  assert(permutation.size() >= size);
+  for (size_t jj = 0; jj < size; ++jj)
+    permutation[jj] = jj;
+  std::sort(permutation.begin(), permutation.begin() + size, [&](const size_t& left, const size_t& right) {
+    return indices[left] < indices[right];
+  });
+} // ... sort_permutation(...)
+
+
+/**
+ * \brief Returns tmp_indices[pos] with at least size entries, which may be used as scratch space by
+ *        add_local_to_global(), after appending to tmp_indices if required.
+ *
+ *        Since tmp_indices is usually thread local storage of the caller, this only allocates on the first call.
+ * \note  Appending invalidates all references into tmp_indices, so call this before taking any.
+ */
+inline Dune::DynamicVector< size_t >& permutation_storage(std::vector< Dune::DynamicVector< size_t > >& tmp_indices,
+                                                          const size_t pos,
+                                                          const size_t size)
+{
+  if (tmp_indices.size() <= pos)
+    tmp_indices.resize(pos + 1, Dune::DynamicVector< size_t >(size));
+  if (tmp_indices[pos].size() < size)
+    tmp_indices[pos].resize(size);
+  return tmp_indices[pos];
+} // ... permutation_storage(...)
+
+
+/**
+ * \brief Adds a dense local matrix to a global matrix, entry by entry.
+ *
+ *        This is the fallback for all matrices whose storage layout we do not know, see the specializations below for
+ *        row-major sparse matrices.
+ */
+template< class MatrixImp >
+struct Scatter
+{
+  template< class LocalMatrixType >
+  static void add(const LocalMatrixType& local_matrix,
+                  const Dune::DynamicVector< size_t >& global_rows,
+                  const size_t rows,
+                  const Dune::DynamicVector< size_t >& global_cols,
+                  const size_t cols,
+                  Dune::DynamicVector< size_t >& /*permutation*/,
+                  MatrixImp& global_matrix,
+                  const bool upper_triangle)
+  {
+    for (size_t ii = 0; ii < rows; ++ii) {
+      const auto& local_row = local_matrix[ii];
+      const size_t global_ii = global_rows[ii];
+      for (size_t jj = 0; jj < cols; ++jj)
+        if (!upper_triangle || global_cols[jj] >= global_ii)
+          global_matrix.add_to_entry(global_ii, global_cols[jj], local_row[jj]);
+    }
+  } // ... add(...)
+}; // struct Scatter
+
+
+#if HAVE_EIGEN
+
+
+/**
+ * \brief Merges each row of the local matrix into the respective CSR row of the global matrix in one linear pass.
+ *
+ *        The column indices are sorted once, the column indices of each row of the backend are sorted anyway.
+ */
+template< class S >
+struct Scatter< Stuff::LA::EigenRowMajorSparseMatrix< S > >
+{
+  typedef Stuff::LA::EigenRowMajorSparseMatrix< S > MatrixType;
+
+  template< class LocalMatrixType >
+  static void add(const LocalMatrixType& local_matrix,
+                  const Dune::DynamicVector< size_t >& global_rows,
+                  const size_t rows,
+                  const Dune::DynamicVector< size_t >& global_cols,
+                  const size_t cols,
+                  Dune::DynamicVector< size_t >& permutation,
+                  MatrixType& global_matrix,
+                  const bool upper_triangle)
+  {
+    sort_permutation(global_cols, cols, permutation);
+    auto& backend = global_matrix.backend();
+    for (size_t ii = 0; ii < rows; ++ii) {
+      const auto& local_row = local_matrix[ii];
+      const size_t global_ii = global_rows[ii];
+      auto kk = backend.outerIndexPtr()[global_ii];
+      auto row_end = end_of_row(backend, global_ii);
+      for (size_t jj = 0; jj < cols; ++jj) {
+        const size_t local_jj = permutation[jj];
+        const size_t global_jj = global_cols[local_jj];
+        if (upper_triangle && global_jj < global_ii)
+          continue;
+        const auto* inner = backend.innerIndexPtr();
+        while (kk < row_end && size_t(inner[kk]) < global_jj)
+          ++kk;
+        if (kk < row_end && size_t(inner[kk]) == global_jj)
+          backend.valuePtr()[kk] += local_row[local_jj];
+        else {
+          // not contained in the pattern, let the container deal with it (this may alter the storage, so start over)
+          global_matrix.add_to_entry(global_ii, global_jj, local_row[local_jj]);
+          kk = backend.outerIndexPtr()[global_ii];
+          row_end = end_of_row(backend, global_ii);
+        }
+      }
+    }
+  } // ... add(...)
+
+private:
+  template< class BackendType >
+  static typename BackendType::Index end_of_row(const BackendType& backend, const size_t row)
+  {
+    return backend.isCompressed() ? backend.outerIndexPtr()[row + 1]
+                                  : backend.outerIndexPtr()[row] + backend.innerNonZeroPtr()[row];
+  }
+}; // struct Scatter< EigenRowMajorSparseMatrix< ... > >
+
+
+#endif // HAVE_EIGEN
+#if HAVE_DUNE_ISTL
+
+
+/**
+ * \brief Merges each row of the local matrix into the respective row of the BCRS backend in one linear pass.
+ */
+template< class S >
+struct Scatter< Stuff::LA::IstlRowMajorSparseMatrix< S > >
+{
+  typedef Stuff::LA::IstlRowMajorSparseMatrix< S > MatrixType;
+
+  template< class LocalMatrixType >
+  static void add(const LocalMatrixType& local_matrix,
+                  const Dune::DynamicVector< size_t >& global_rows,
+                  const size_t rows,
+                  const Dune::DynamicVector< size_t >& global_cols,
+                  const size_t cols,
+                  Dune::DynamicVector< size_t >& permutation,
+                  MatrixType& global_matrix,
+                  const bool upper_triangle)
+  {
+    sort_permutation(global_cols, cols, permutation);
+    auto& backend = global_matrix.backend();
+    for (size_t ii = 0; ii < rows; ++ii) {
+      const auto& local_row = local_matrix[ii];
+      const size_t global_ii = global_rows[ii];
+      auto& global_row = backend[global_ii];
+      auto col_it = global_row.begin();
+      const auto col_end = global_row.end();
+      for (size_t jj = 0; jj < cols; ++jj) {
+        const size_t local_jj = permutation[jj];
+        const size_t global_jj = global_cols[local_jj];
+        if (upper_triangle && global_jj < global_ii)
+          continue;
+        while (col_it != col_end && size_t(col_it.index()) < global_jj)
+          ++col_it;
+        if (col_it != col_end && size_t(col_it.index()) == global_jj)
+          (*col_it)[0][0] += local_row[local_jj];
+        else
+          global_matrix.add_to_entry(global_ii, global_jj, local_row[local_jj]);
+      }
+    }
+  } // ... add(...)
+}; // struct Scatter< IstlRowMajorSparseMatrix< ... > >
+
+
+/**
+ * \brief Merges each row of the local matrix into the respective block row of the BCRS backend in one linear pass,
+ *        the sorted column indices of one block are consecutive.
+ */
+template< class S, size_t blockSize >
+struct Scatter< LA::IstlBlockMatrix< S, blockSize > >
+{
+  typedef LA::IstlBlockMatrix< S, blockSize > MatrixType;
+
+  template< class LocalMatrixType >
+  static void add(const LocalMatrixType& local_matrix,
+                  const Dune::DynamicVector< size_t >& global_rows,
+                  const size_t rows,
+                  const Dune::DynamicVector< size_t >& global_cols,
+                  const size_t cols,
+                  Dune::DynamicVector< size_t >& permutation,
+                  MatrixType& global_matrix,
+                  const bool upper_triangle)
+  {
+    sort_permutation(global_cols, cols, permutation);
+    auto& backend = global_matrix.backend();
+    for (size_t ii = 0; ii < rows; ++ii) {
+      const auto& local_row = local_matrix[ii];
+      const size_t global_ii = global_rows[ii];
+      const size_t component_ii = global_ii % blockSize;
+      auto& global_block_row = backend[global_ii / blockSize];
+      auto block_it = global_block_row.begin();
+      const auto block_end = global_block_row.end();
+      for (size_t jj = 0; jj < cols; ++jj) {
+        const size_t local_jj = permutation[jj];
+        const size_t global_jj = global_cols[local_jj];
+        if (upper_triangle && global_jj < global_ii)
+          continue;
+        const size_t block_jj = global_jj / blockSize;
+        while (block_it != block_end && size_t(block_it.index()) < block_jj)
+          ++block_it;
+        if (block_it != block_end && size_t(block_it.index()) == block_jj)
+          (*block_it)[component_ii][global_jj % blockSize] += local_row[local_jj];
+        else
+          global_matrix.add_to_entry(global_ii, global_jj, local_row[local_jj]);
+      }
+    }
+  } // ... add(...)
+}; // struct Scatter< LA::IstlBlockMatrix< ... > >
+
+
+#endif // HAVE_DUNE_ISTL
+
+
+/// \brief Marks an entry which is not contained in the values of a matrix, \sa CsrValues.
+static const size_t invalid_csr_offset = std::numeric_limits< size_t >::max();
+
+
+/**
+ * \brief Gives direct access to the array of values of a matrix in compressed row storage, and to the position of
+ *        each entry of its pattern in this array.
+ *
+ *        Not available for this matrix, see the specializations below.
+ */
+template< class MatrixImp >
+struct CsrValues
+{
+  static const bool available = false;
+}; // struct CsrValues
+
+
+#if HAVE_EIGEN
+
+
+template< class S >
+struct CsrValues< Stuff::LA::EigenRowMajorSparseMatrix< S > >
+{
+  typedef Stuff::LA::EigenRowMajorSparseMatrix< S > MatrixType;
+  static const bool available = true;
+
+  /// \brief The positions are only stable as long as the backend is compressed.
+  static bool usable(const MatrixType& matrix)
+  {
+    return matrix.backend().isCompressed();
+  }
+
+  /// \brief Returns the position of entry (ii, jj) in values(), or invalid_csr_offset if it is not in the pattern.
+  static size_t offset(const MatrixType& matrix, const size_t ii, const size_t jj)
+  {
+    assert(usable(matrix));
+    const auto& backend = matrix.backend();
+    const auto* inner = backend.innerIndexPtr();
+    const auto* row_begin = inner + backend.outerIndexPtr()[ii];
+    const auto* row_end = inner + backend.outerIndexPtr()[ii + 1];
+    const auto* position = std::lower_bound(row_begin, row_end, typename MatrixType::BackendType::Index(jj));
+    return (position != row_end && size_t(*position) == jj) ? size_t(position - inner) : invalid_csr_offset;
+  } // ... offset(...)
+
+  static size_t nonzeros(const MatrixType& matrix)
+  {
+    return matrix.backend().nonZeros();
+  }
+
+  /// \brief A hash (FNV-1a) of the outer and inner index arrays, i.e. of the pattern, \sa ScatterOffsets::fits().
+  static std::uint64_t pattern_hash(const MatrixType& matrix)
+  {
+    assert(usable(matrix));
+    const auto& backend = matrix.backend();
+    std::uint64_t hash = 14695981039346656037ull;
+    const auto add = [&](const std::uint64_t value) {
+      hash ^= value;
+      hash *= 1099511628211ull;
+    };
+    for (size_t ii = 0; ii <= size_t(backend.outerSize()); ++ii)
+      add(std::uint64_t(backend.outerIndexPtr()[ii]));
+    for (size_t ii = 0; ii < size_t(backend.nonZeros()); ++ii)
+      add(std::uint64_t(backend.innerIndexPtr()[ii]));
+    return hash;
+  } // ... pattern_hash(...)
+
+  static S* values(MatrixType& matrix)
+  {
+    return matrix.backend().valuePtr();
+  }
+}; // struct CsrValues< EigenRowMajorSparseMatrix< ... > >
+
+
+#endif // HAVE_EIGEN
+
+
+} // namespace internal
+
+
+/**
+ * \brief Adds the first rows x cols block of local_matrix to global_matrix at once, i.e.
+ *        global_matrix[global_rows[ii]][global_cols[jj]] += local_matrix[ii][jj].
+ *
+ *        For row-major sparse matrices, the column indices are sorted once and merged into each row of the global
+ *        matrix in a single linear pass, instead of searching each row for each entry as add_to_entry() does. All
+ *        other matrices are filled using add_to_entry().
+ * \param tmp_permutation Scratch space of at least cols entries, see internal::permutation_storage().
+ * \param storage         If MatrixStorage::upper_triangle, only the entries with global_rows[ii] <= global_cols[jj]
+ *                        are added, \sa MatrixStorage.
+ */
+template< class M, class R, class LocalMatrixType >
+void add_local_to_global(const LocalMatrixType& local_matrix,
+                         const Dune::DynamicVector< size_t >& global_rows,
+                         const size_t rows,
+                         const Dune::DynamicVector< size_t >& global_cols,
+                         const size_t cols,
+                         Dune::DynamicVector< size_t >& tmp_permutation,
+                         Stuff::LA::MatrixInterface< M, R >& global_matrix,
+                         const MatrixStorage storage = MatrixStorage::full)
+{
+  assert(global_rows.size() >= rows);
+  assert(global_cols.size() >= cols);
+  internal::Scatter< typename M::derived_type >::add(local_matrix,
+                                                     global_rows, rows,
+                                                     global_cols, cols,
+                                                     tmp_permutation,
+                                                     global_matrix.as_imp(),
+                                                     storage == MatrixStorage::upper_triangle);
+} // ... add_local_to_global(...)
+
+
+/**
+ * \brief Adds the first rows x cols block of local_matrix directly to the values of global_matrix, i.e.
+ *        values[offsets[ii*cols + jj]] += local_matrix[ii][jj], skipping all entries with invalid_csr_offset.
+ *
+ *        The offsets have to be computed for the current pattern of global_matrix, \sa ScatterOffsets.
+ */
+template< class M, class R, class LocalMatrixType >
+void add_local_to_global(const LocalMatrixType& local_matrix,
+                         const size_t rows,
+                         const size_t cols,
+                         const size_t* offsets,
+                         Stuff::LA::MatrixInterface< M, R >& global_matrix)
+{
+  typedef internal::CsrValues< typename M::derived_type > CsrValuesType;
+  static_assert(CsrValuesType::available, "The values of this matrix are not directly accessible!");
+  assert(CsrValuesType::usable(global_matrix.as_imp()));
+  auto* values = CsrValuesType::values(global_matrix.as_imp());
+  for (size_t ii = 0; ii < rows; ++ii) {
+    const auto& local_row = local_matrix[ii];
+    const size_t* row_offsets = offsets + ii*cols;
+    for (size_t jj = 0; jj < cols; ++jj)
+      if (row_offsets[jj] != internal::invalid_csr_offset)
+        values[row_offsets[jj]] += local_row[jj];
+  }
+} // ... add_local_to_global(...)
+
+
+} // namespace LocalAssembler
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_ASSEMBLER_LOCAL_SCATTER_HH
@@ -0,0 +1,270 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_ASSEMBLER_SCATTER_OFFSETS_HH
+#define DUNE_GDT_ASSEMBLER_SCATTER_OFFSETS_HH
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/dynvector.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/la/container/interfaces.hh>
+
+#include <dune/gdt/spaces/interface.hh>
+
+#include "local/scatter.hh"
+#include "symmetric.hh"
+
+namespace Dune {
+namespace GDT {
+
+
+/**
+ * \brief The position of each entry of the local matrix of each entity (and, optionally, of the coupling matrices of
+ *        each pair of neighboring entities) in the values of a matrix in compressed row storage (\sa
+ *        LocalAssembler::internal::CsrValues), i.e. an element-to-CSR-offset map.
+ *
+ *        Computing these requires one search in the pattern per entry of each local matrix, which is what the regular
+ *        scatter does on each assembly. Once computed, the local matrices of all subsequent assemblies are added at the
+ *        precomputed positions without any search (\sa SystemAssembler::precompute_scatter_offsets()). The offsets
+ *        only depend on the grid view, the mappers of the spaces and the pattern of the matrix, so they can be used for
+ *        all matrices with the same pattern (\sa fits()), e.g. for an elliptic operator and a mass matrix of the same
+ *        space pair, and become invalid if the pattern changes. The coupling matrices of each pair of neighbors are
+ *        stored once, with the entity of smaller index. They are never modified after construction, so they may be
+ *        used by several threads at once.
+ */
+template< class GridViewImp >
+class ScatterOffsets
+{
+public:
+  typedef GridViewImp                                        GridViewType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+
+  /// \brief The offsets of the four local matrices of a coupling, \sa LocalAssembler::Codim1CouplingMatrix.
+  struct CouplingOffsets
+  {
+    const size_t* entity_entity;
+    const size_t* neighbor_neighbor;
+    const size_t* entity_neighbor;
+    const size_t* neighbor_entity;
+  }; // struct CouplingOffsets
+
+  /**
+   * \param storage       If MatrixStorage::upper_triangle, the entries below the diagonal are skipped (and need not be
+   *                      contained in the pattern of matrix), \sa MatrixStorage.
+   * \param include_faces If true, the offsets of the coupling matrices of all neighboring entities are computed as
+   *                      well, which requires the pattern of matrix to contain them, \sa
+   *                      SpaceInterface::compute_face_and_volume_pattern().
+   */
+  template< class T, size_t Td, size_t Tr, size_t TrC, class A, size_t Ad, size_t Ar, size_t ArC, class M, class R >
+  ScatterOffsets(const GridViewType& grid_view,
+                 const SpaceInterface< T, Td, Tr, TrC >& test_space,
+                 const SpaceInterface< A, Ad, Ar, ArC >& ansatz_space,
+                 const Stuff::LA::MatrixInterface< M, R >& matrix,
+                 const MatrixStorage storage = MatrixStorage::full,
+                 const bool include_faces = false)
+    : grid_view_(grid_view)
+    , storage_(storage)
+    , include_faces_(include_faces)
+    , rows_(matrix.rows())
+    , cols_(matrix.cols())
+  {
+    typedef LocalAssembler::internal::CsrValues< typename M::derived_type > CsrValuesType;
+    static_assert(CsrValuesType::available, "The values of this matrix are not directly accessible!");
+    if (!CsrValuesType::usable(matrix.as_imp()))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The values of the given matrix are not directly accessible!");
+    nonzeros_ = CsrValuesType::nonzeros(matrix.as_imp());
+    pattern_hash_ = CsrValuesType::pattern_hash(matrix.as_imp());
+    const auto& index_set = grid_view_.indexSet();
+    const auto& test_mapper = test_space.mapper();
+    const auto& ansatz_mapper = ansatz_space.mapper();
+    const size_t num_entities = index_set.size(0);
+    volume_begin_.assign(num_entities, 0);
+    if (include_faces_) {
+      faces_begin_.assign(num_entities, 0);
+      faces_end_.assign(num_entities, 0);
+    }
+    Dune::DynamicVector< size_t > global_rows_inside(test_mapper.maxNumDofs(), 0);
+    Dune::DynamicVector< size_t > global_cols_inside(ansatz_mapper.maxNumDofs(), 0);
+    Dune::DynamicVector< size_t > global_rows_outside(test_mapper.maxNumDofs(), 0);
+    Dune::DynamicVector< size_t > global_cols_outside(ansatz_mapper.maxNumDofs(), 0);
+    for (const auto& entity : DSC::entityRange(grid_view_)) {
+      const size_t entity_index = index_set.index(entity);
+      const size_t rows_inside = test_mapper.numDofs(entity);
+      const size_t cols_inside = ansatz_mapper.numDofs(entity);
+      test_mapper.globalIndices(entity, global_rows_inside);
+      ansatz_mapper.globalIndices(entity, global_cols_inside);
+      volume_begin_[entity_index] = append< CsrValuesType >(matrix.as_imp(),
+                                                            global_rows_inside, rows_inside,
+                                                            global_cols_inside, cols_inside);
+      if (!include_faces_)
+        continue;
+      faces_begin_[entity_index] = faces_.size();
+      const auto intersection_it_end = grid_view_.iend(entity);
+      for (auto intersection_it = grid_view_.ibegin(entity);
+           intersection_it != intersection_it_end;
+           ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        if (!intersection.neighbor())
+          continue;
+        const auto neighbor_ptr = intersection.outside();
+        const auto& neighbor = *neighbor_ptr;
+        const size_t neighbor_index = index_set.index(neighbor);
+        if (neighbor_index < entity_index)
+          continue; // stored with the neighbor
+        if (find_face(entity_index, neighbor_index, faces_.size()))
+          continue; // already seen, e.g. on nonconforming grids
+        const size_t rows_outside = test_mapper.numDofs(neighbor);
+        const size_t cols_outside = ansatz_mapper.numDofs(neighbor);
+        test_mapper.globalIndices(neighbor, global_rows_outside);
+        ansatz_mapper.globalIndices(neighbor, global_cols_outside);
+        Face face;
+        face.upper = neighbor_index;
+        face.lower_upper = append< CsrValuesType >(matrix.as_imp(),
+                                                       global_rows_inside, rows_inside,
+                                                       global_cols_outside, cols_outside);
+        face.upper_lower = append< CsrValuesType >(matrix.as_imp(),
+                                                       global_rows_outside, rows_outside,
+                                                       global_cols_inside, cols_inside);
+        faces_.push_back(face);
+      }
+      faces_end_[entity_index] = faces_.size();
+    }
+  } // ScatterOffsets(...)
+
+  MatrixStorage storage() const
+  {
+    return storage_;
+  }
+
+  bool includes_faces() const
+  {
+    return include_faces_;
+  }
+
+  /**
+   * \brief Returns true if these offsets may be used for matrix, i.e. if matrix has the same shape, number of
+   *        nonzeros and hash of its pattern as the matrix these were computed for.
+   * \note  Hashes the pattern, i.e. is linear in the number of nonzeros of matrix.
+   */
+  template< class M, class R >
+  bool fits(const Stuff::LA::MatrixInterface< M, R >& matrix) const
+  {
+    typedef LocalAssembler::internal::CsrValues< typename M::derived_type > CsrValuesType;
+    return fits(matrix.as_imp(), std::integral_constant< bool, CsrValuesType::available >());
+  }
+
+  /// \brief The offsets of the local matrix of entity, the one of local entry (ii, jj) is at [ii*cols + jj].
+  const size_t* local(const EntityType& entity) const
+  {
+    return offsets_.data() + volume_begin_[grid_view_.indexSet().index(entity)];
+  }
+
+  /**
+   * \brief The offsets of the four local matrices of the coupling of entity and neighbor.
+   * \note  Requires include_faces() and that entity and neighbor are neighbors in the grid view.
+   */
+  CouplingOffsets coupling(const EntityType& entity, const EntityType& neighbor) const
+  {
+    assert(include_faces_);
+    const auto& index_set = grid_view_.indexSet();
+    const size_t entity_index = index_set.index(entity);
+    const size_t neighbor_index = index_set.index(neighbor);
+    const bool entity_is_lower = entity_index < neighbor_index;
+    const size_t lower = entity_is_lower ? entity_index : neighbor_index;
+    const size_t upper = entity_is_lower ? neighbor_index : entity_index;
+    const Face* face = find_face(lower, upper, faces_end_[lower]);
+    if (!face)
+      DUNE_THROW(Stuff::Exceptions::index_out_of_range, "The given entities are not neighbors!");
+    CouplingOffsets ret;
+    ret.entity_entity = offsets_.data() + volume_begin_[entity_index];
+    ret.neighbor_neighbor = offsets_.data() + volume_begin_[neighbor_index];
+    ret.entity_neighbor = offsets_.data() + (entity_is_lower ? face->lower_upper : face->upper_lower);
+    ret.neighbor_entity = offsets_.data() + (entity_is_lower ? face->upper_lower : face->lower_upper);
+    return ret;
+  } // ... coupling(...)
+
+private:
+  /// \brief The coupling of the entity it is stored with (the lower index) and the neighbor of upper index.
+  struct Face
+  {
+    size_t upper;
+    size_t lower_upper;
+    size_t upper_lower;
+  }; // struct Face
+
+  template< class MatrixType >
+  bool fits(const MatrixType& matrix, std::true_type) const
+  {
+    typedef LocalAssembler::internal::CsrValues< MatrixType > CsrValuesType;
+    return matrix.rows() == rows_
+        && matrix.cols() == cols_
+        && CsrValuesType::usable(matrix)
+        && CsrValuesType::nonzeros(matrix) == nonzeros_
+        && CsrValuesType::pattern_hash(matrix) == pattern_hash_;
+  } // ... fits(...)
+
+  template< class MatrixType >
+  bool fits(const MatrixType& /*matrix*/, std::false_type) const
+  {
+    return false;
+  }
+
+  /// \brief Searches the (few) neighbors of lower, which are stored in faces_[faces_begin_[lower], end).
+  const Face* find_face(const size_t lower, const size_t upper, const size_t end) const
+  {
+    for (size_t ff = faces_begin_[lower]; ff < end; ++ff)
+      if (faces_[ff].upper == upper)
+        return &faces_[ff];
+    return nullptr;
+  }
+
+  /// \brief Appends the offsets of a local matrix to offsets_ and returns the position of the first one.
+  template< class CsrValuesType, class MatrixType >
+  size_t append(const MatrixType& matrix,
+                const Dune::DynamicVector< size_t >& global_rows,
+                const size_t rows,
+                const Dune::DynamicVector< size_t >& global_cols,
+                const size_t cols)
+  {
+    const size_t begin = offsets_.size();
+    offsets_.resize(begin + rows*cols, LocalAssembler::internal::invalid_csr_offset);
+    for (size_t ii = 0; ii < rows; ++ii)
+      for (size_t jj = 0; jj < cols; ++jj) {
+        if (storage_ == MatrixStorage::upper_triangle && global_cols[jj] < global_rows[ii])
+          continue;
+        const size_t offset = CsrValuesType::offset(matrix, global_rows[ii], global_cols[jj]);
+        if (offset == LocalAssembler::internal::invalid_csr_offset)
+          DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                     "Entry (" << global_rows[ii] << ", " << global_cols[jj]
+                     << ") is not contained in the pattern of the given matrix!");
+        offsets_[begin + ii*cols + jj] = offset;
+      }
+    return begin;
+  } // ... append(...)
+
+  const GridViewType grid_view_;
+  const MatrixStorage storage_;
+  const bool include_faces_;
+  const size_t rows_;
+  const size_t cols_;
+  size_t nonzeros_;
+  std::uint64_t pattern_hash_;
+  std::vector< size_t > volume_begin_;
+  std::vector< size_t > faces_begin_;
+  std::vector< size_t > faces_end_;
+  std::vector< Face > faces_;
+  std::vector< size_t > offsets_;
+}; // class ScatterOffsets
+
+
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_ASSEMBLER_SCATTER_OFFSETS_HH
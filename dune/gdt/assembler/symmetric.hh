@@ -0,0 +1,93 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_ASSEMBLER_SYMMETRIC_HH
+#define DUNE_GDT_ASSEMBLER_SYMMETRIC_HH
+
+#include <dune/stuff/la/container/interfaces.hh>
+#include <dune/stuff/la/container/pattern.hh>
+
+namespace Dune {
+namespace GDT {
+
+
+/**
+ * \brief Selects which entries of a matrix are assembled.
+ *
+ *        For symmetric operators or products (where test and ansatz space coincide and the local operators are
+ *        symmetric, \sa LocalOperator::is_symmetric), upper_triangle only computes and stores the entries (ii, jj)
+ *        with ii <= jj, which halves the memory footprint of the matrix and the work of the scatter. Such a matrix
+ *        has to be treated as symmetric by whoever uses it, e.g. a Cholesky solver reading the upper triangle.
+ */
+enum class MatrixStorage
+{
+    full
+  , upper_triangle
+}; // enum class MatrixStorage
+
+
+/**
+ * \brief Returns the entries (ii, jj) of pattern with ii <= jj.
+ */
+inline Stuff::LA::SparsityPatternDefault upper_triangular_pattern(const Stuff::LA::SparsityPatternDefault& pattern)
+{
+  Stuff::LA::SparsityPatternDefault ret(pattern.size());
+  for (size_t ii = 0; ii < pattern.size(); ++ii) {
+    auto& row = ret.inner(ii);
+    for (const auto& jj : pattern.inner(ii))
+      if (jj >= ii)
+        row.push_back(jj);
+  }
+  return ret;
+} // ... upper_triangular_pattern(...)
+
+
+/**
+ * \brief Computes range^T * A * source, where only the upper triangle of the symmetric matrix A is stored in matrix,
+ *        i.e. range^T * (U + U^T - D) * source = range^T * U * source + source^T * U * range - range^T * D * source.
+ */
+template< class M, class R, class S, class F >
+F upper_triangular_apply2(const Stuff::LA::MatrixInterface< M, F >& matrix,
+                          const Stuff::LA::VectorInterface< R, F >& range,
+                          const Stuff::LA::VectorInterface< S, F >& source)
+{
+  assert(matrix.rows() == matrix.cols());
+  assert(range.size() == matrix.rows());
+  assert(source.size() == matrix.cols());
+  auto tmp_range = range.copy();
+  matrix.mv(source.as_imp(), tmp_range);
+  auto tmp_source = source.copy();
+  matrix.mv(range.as_imp(), tmp_source);
+  F ret = range.dot(tmp_range) + source.dot(tmp_source);
+  for (size_t ii = 0; ii < matrix.rows(); ++ii)
+    ret -= range.get_entry(ii) * matrix.get_entry(ii, ii) * source.get_entry(ii);
+  return ret;
+} // ... upper_triangular_apply2(...)
+
+
+namespace internal {
+
+
+/// \brief Returns product.matrix_storage() if available and MatrixStorage::full otherwise.
+template< class ProductType >
+auto matrix_storage(const ProductType& product, int) -> decltype(product.matrix_storage())
+{
+  return product.matrix_storage();
+}
+
+template< class ProductType >
+MatrixStorage matrix_storage(const ProductType& /*product*/, ...)
+{
+  return MatrixStorage::full;
+}
+
+
+} // namespace internal
+
+
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_ASSEMBLER_SYMMETRIC_HH
@@ -7,11 +7,19 @@
 #define DUNE_GDT_ASSEMBLER_SYSTEM_HH
 
 #include <type_traits>
+#include <map>
 #include <memory>
 
+#if HAVE_TBB
+# include <tbb/blocked_range.h>
+# include <tbb/parallel_for.h>
+#endif
+
 #include <dune/common/deprecated.hh>
 #include <dune/common/version.hh>
 
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/memory.hh>
 #include <dune/stuff/grid/walker.hh>
 #include <dune/stuff/common/parallel/helper.hh>
 
@@ -20,6 +28,10 @@
 
 #include "local/codim0.hh"
 #include "local/codim1.hh"
+#include "coloring.hh"
+#include "scatter-offsets.hh"
+#include "symmetric.hh"
+#include "traversal.hh"
 #include "wrapper.hh"
 
 namespace Dune {
@@ -50,6 +62,10 @@ public:
   typedef DSG::ApplyOn::WhichEntity< GridViewType >       ApplyOnWhichEntity;
   typedef DSG::ApplyOn::WhichIntersection< GridViewType > ApplyOnWhichIntersection;
 
+  typedef EntityColoring< GridViewType >             EntityColoringType;
+  typedef SpaceFillingCurveTraversal< GridViewType > TraversalType;
+  typedef ScatterOffsets< GridViewType >             ScatterOffsetsType;
+
   SystemAssembler(TestSpaceType test, AnsatzSpaceType ansatz, GridViewType grid_view)
     : BaseType(grid_view)
     , test_space_(test)
@@ -107,10 +123,13 @@ public:
   {
     assert(matrix.rows() == test_space_->mapper().size());
     assert(matrix.cols() == ansatz_space_->mapper().size());
+    check_storage(local_assembler.storage());
     typedef internal::LocalVolumeMatrixAssemblerWrapper< ThisType, LocalAssembler::Codim0Matrix< L >,
                                                          typename M::derived_type >                   WrapperType;
     this->codim0_functors_.emplace_back(
-          new WrapperType(test_space_, ansatz_space_, where, local_assembler, matrix.as_imp()));
+          new WrapperType(test_space_, ansatz_space_, bound_spaces_, where, local_assembler,
+                          thread_local_container(matrix.as_imp()),
+                          matching_scatter_offsets(matrix, local_assembler.storage(), false)));
   } // ... add(...)
 
   template< class Codim0Assembler, class M >
@@ -125,7 +144,8 @@ public:
     typedef internal::LocalVolumeMatrixAssemblerWrapper< ThisType, Codim0Assembler, typename M::derived_type >
         WrapperType;
     this->codim0_functors_.emplace_back(
-          new WrapperType(test_space_, ansatz_space_, where, local_assembler, matrix.as_imp()));
+          new WrapperType(test_space_, ansatz_space_, bound_spaces_, where, local_assembler,
+                          thread_local_container(matrix.as_imp())));
   } // ... add(...)
 
   template< class Codim0Assembler, class V >
@@ -138,7 +158,8 @@ public:
     assert(vector.size() == test_space_->mapper().size());
     typedef internal::LocalVolumeVectorAssemblerWrapper< ThisType, Codim0Assembler, typename V::derived_type >
         WrapperType;
-    this->codim0_functors_.emplace_back(new WrapperType(test_space_, where, local_assembler, vector.as_imp()));
+    this->codim0_functors_.emplace_back(
+          new WrapperType(test_space_, bound_spaces_, where, local_assembler, thread_local_container(vector.as_imp())));
   } // ... add(...)
 
   template< class L, class M >
@@ -148,10 +169,13 @@ public:
   {
     assert(matrix.rows() == test_space_->mapper().size());
     assert(matrix.cols() == ansatz_space_->mapper().size());
+    check_storage(local_assembler.storage());
     typedef internal::LocalFaceMatrixAssemblerWrapper< ThisType, LocalAssembler::Codim1CouplingMatrix< L >,
                                                        typename M::derived_type >                           WrapperType;
     this->codim1_functors_.emplace_back(
-          new WrapperType(test_space_, ansatz_space_, where, local_assembler, matrix.as_imp()));
+          new WrapperType(test_space_, ansatz_space_, bound_spaces_, where, local_assembler,
+                          thread_local_container(matrix.as_imp()),
+                          matching_scatter_offsets(matrix, local_assembler.storage(), true)));
   } // ... add(...)
 
   template< class L, class M >
@@ -161,10 +185,13 @@ public:
   {
     assert(matrix.rows() == test_space_->mapper().size());
     assert(matrix.cols() == ansatz_space_->mapper().size());
+    check_storage(local_assembler.storage());
     typedef internal::LocalFaceMatrixAssemblerWrapper< ThisType, LocalAssembler::Codim1BoundaryMatrix< L >,
                                                        typename M::derived_type >                           WrapperType;
     this->codim1_functors_.emplace_back(
-          new WrapperType(test_space_, ansatz_space_, where, local_assembler, matrix.as_imp()));
+          new WrapperType(test_space_, ansatz_space_, bound_spaces_, where, local_assembler,
+                          thread_local_container(matrix.as_imp()),
+                          matching_scatter_offsets(matrix, local_assembler.storage(), false)));
   } // ... add(...)
 
   template< class L, class V >
@@ -176,7 +203,8 @@ public:
     assert(vector.size() == test_space_->mapper().size());
     typedef internal::LocalVolumeVectorAssemblerWrapper< ThisType, LocalAssembler::Codim0Vector< L >,
                                                          typename V::derived_type >                   WrapperType;
-    this->codim0_functors_.emplace_back(new WrapperType(test_space_, where, local_assembler, vector.as_imp()));
+    this->codim0_functors_.emplace_back(
+          new WrapperType(test_space_, bound_spaces_, where, local_assembler, thread_local_container(vector.as_imp())));
   } // ... add(...)
 
   template< class L, class V >
@@ -188,24 +216,279 @@ public:
     assert(vector.size() == test_space_->mapper().size());
     typedef internal::LocalFaceVectorAssemblerWrapper< ThisType, LocalAssembler::Codim1Vector< L >,
                                                        typename V::derived_type >                   WrapperType;
-    this->codim1_functors_.emplace_back(new WrapperType(test_space_, where, local_assembler, vector.as_imp()));
+    this->codim1_functors_.emplace_back(
+          new WrapperType(test_space_, bound_spaces_, where, local_assembler, thread_local_container(vector.as_imp())));
   } // ... add(...)
 
+  /**
+   * \brief Computes the position of each entry of the local matrix of each entity (and of the coupling matrices of
+   *        neighboring entities, if include_faces is true) in the values of matrix (\sa ScatterOffsets), which are used
+   *        by all local matrix assemblers of the same storage added for matrix from now on.
+   *
+   *        These add their local matrices directly at the precomputed positions, without searching the pattern of
+   *        matrix, which pays off if matrix is assembled repeatedly (\sa Products::AssemblableBase::reassemble()). The
+   *        offsets are kept until they are replaced and have to be recomputed whenever the pattern of matrix changes.
+   *        Only available for matrices in compressed row storage (\sa LocalAssembler::internal::CsrValues), does
+   *        nothing for all other matrices.
+   */
+  template< class M >
+  void precompute_scatter_offsets(const Stuff::LA::MatrixInterface< M, RangeFieldType >& matrix,
+                                  const MatrixStorage storage = MatrixStorage::full,
+                                  const bool include_faces = false)
+  {
+    typedef LocalAssembler::internal::CsrValues< typename M::derived_type > CsrValuesType;
+    precompute_scatter_offsets(matrix.as_imp(),
+                               storage,
+                               include_faces,
+                               std::integral_constant< bool, CsrValuesType::available >());
+  } // ... precompute_scatter_offsets(...)
+
+  /**
+   * \brief Uses the given offsets for matrix from now on, e.g. the ones of another matrix with the same pattern of
+   *        another assembler on the same grid view and spaces, \sa precompute_scatter_offsets().
+   */
+  template< class M >
+  void set_scatter_offsets(const Stuff::LA::MatrixInterface< M, RangeFieldType >& matrix,
+                           const std::shared_ptr< const ScatterOffsetsType >& offsets)
+  {
+    if (!offsets || !offsets->fits(matrix))
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match, "The given offsets do not fit the pattern of matrix!");
+    scatter_offsets_[&matrix.as_imp()] = offsets;
+  }
+
+  /// \brief Returns the offsets used for matrix, if any, \sa precompute_scatter_offsets().
+  template< class M >
+  std::shared_ptr< const ScatterOffsetsType >
+  scatter_offsets(const Stuff::LA::MatrixInterface< M, RangeFieldType >& matrix) const
+  {
+    const auto result = scatter_offsets_.find(&matrix.as_imp());
+    return result == scatter_offsets_.end() ? nullptr : result->second;
+  }
+
+  /**
+   * \brief Binds the spaces to the entity once for all registered local assemblers and applies them.
+   */
+  virtual void apply_local(const EntityType& entity) override
+  {
+    bound_spaces_->bind_inside(*test_space_, *ansatz_space_, entity);
+    BaseType::apply_local(entity);
+  }
+
+  /**
+   * \brief Binds the spaces to the neighbor once for all registered local assemblers and applies them.
+   * \note  The spaces remain bound to the inside entity from apply_local(entity), if the walker called it before.
+   */
+  virtual void apply_local(const IntersectionType& intersection,
+                           const EntityType& inside_entity,
+                           const EntityType& outside_entity) override
+  {
+    auto& bound_spaces = *bound_spaces_;
+    if (!bound_spaces.test_inside.is_bound_to(inside_entity))
+      bound_spaces.bind_inside(*test_space_, *ansatz_space_, inside_entity);
+    bound_spaces.bind_outside(*test_space_, *ansatz_space_, outside_entity);
+    BaseType::apply_local(intersection, inside_entity, outside_entity);
+  } // ... apply_local(...)
+
+  /**
+   * \brief Applies all registered local assemblers, see DSG::Walker::walk().
+   * \note  If use_tbb is true, the entities are distributed among the threads without any further precautions, so two
+   *        threads may write into the same entry of a matrix or vector at the same time. Use assemble_colored() for a
+   *        race free parallel assembly.
+   */
   void assemble(const bool use_tbb = false)
   {
     this->walk(use_tbb);
+    thread_local_containers_.clear();
   }
 
   template< class Partitioning >
   void assemble(const Partitioning& partitioning)
   {
     this->walk(partitioning);
+    thread_local_containers_.clear();
   }
 
+  /**
+   * \brief Applies all registered local assemblers, walking the grid along the space filling curve of the given
+   *        traversal: in parallel (one partition of the curve after another per thread) if TBB is available, in the
+   *        order of the curve otherwise.
+   * \note  As for assemble(true), two threads may write into the same entry of a matrix or vector at the same time.
+   */
+  void assemble(const TraversalType& traversal)
+  {
+    this->prepare();
+    if ((this->codim0_functors_.size() + this->codim1_functors_.size()) > 0) {
+#if HAVE_TBB
+      tbb::parallel_for(tbb::blocked_range< size_t >(0, traversal.partitions(), 1),
+                        [&](const tbb::blocked_range< size_t >& range) {
+        for (size_t pp = range.begin(); pp != range.end(); ++pp)
+          for (const auto& entity : traversal.partition(pp))
+            this->walk_entity(entity);
+      });
+#else // HAVE_TBB
+      for (const auto& entity : traversal)
+        walk_entity(entity);
+#endif // HAVE_TBB
+    }
+    this->finalize();
+    this->clear();
+    thread_local_containers_.clear();
+  } // ... assemble(...)
+
+  /**
+   * \brief Applies all registered local assemblers in parallel (as assemble(true) does), where each thread assembles
+   *        into its own copy of each matrix and vector, and sums all copies up afterwards.
+   *
+   *        The copies are created once per thread and share the sparsity pattern of the given matrices, so no
+   *        synchronization is required during the grid walk, at the price of one copy of each container per thread.
+   *        The copies are summed up pairwise in parallel, which takes log2(#threads) steps.
+   */
+  void assemble_with_thread_local_copies()
+  {
+    for (auto& container : thread_local_containers_)
+      container.second->enable();
+    this->walk(true);
+    for (auto& container : thread_local_containers_)
+      container.second->reduce();
+    thread_local_containers_.clear();
+  } // ... assemble_with_thread_local_copies(...)
+
+  /**
+   * \brief Applies all registered local assemblers, one color of the given coloring after another, where all entities
+   *        of one color are processed concurrently.
+   *
+   *        Since no two entities of the same color share a DoF of the test space, no two threads ever write into the
+   *        same row of a matrix or the same entry of a vector, so no locks or atomics are required. In addition, the
+   *        order in which the local contributions are summed up only depends on the coloring, so the result is
+   *        deterministic.
+   * \note  If local assemblers on intersections are registered, the coloring has to include the neighbors, see
+   *        EntityColoring.
+   */
+  void assemble(const EntityColoringType& coloring)
+  {
+    if (!coloring.includes_neighbors() && this->codim1_functors_.size() > 0)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The coloring has to include the neighbors if local assemblers on intersections are given!");
+    this->prepare();
+    if ((this->codim0_functors_.size() + this->codim1_functors_.size()) > 0) {
+      const auto& grid = this->grid_view().grid();
+      for (size_t cc = 0; cc < coloring.colors(); ++cc) {
+        const auto& seeds = coloring.color(cc);
+#if HAVE_TBB
+        tbb::parallel_for(tbb::blocked_range< size_t >(0, seeds.size()),
+                          [&](const tbb::blocked_range< size_t >& range) {
+          for (size_t ii = range.begin(); ii != range.end(); ++ii) {
+            const auto entity_ptr = grid.entity(seeds[ii]);
+            this->walk_entity(*entity_ptr);
+          }
+        });
+#else // HAVE_TBB
+        for (const auto& seed : seeds) {
+          const auto entity_ptr = grid.entity(seed);
+          walk_entity(*entity_ptr);
+        }
+#endif // HAVE_TBB
+      }
+    }
+    this->finalize();
+    this->clear();
+    thread_local_containers_.clear();
+  } // ... assemble(...)
+
+  /**
+   * \brief Computes a coloring of the grid view w.r.t. the test space (only once) and calls assemble(coloring).
+   */
+  void assemble_colored()
+  {
+    const bool include_neighbors = this->codim1_functors_.size() > 0;
+    if (!coloring_ || (include_neighbors && !coloring_->includes_neighbors()))
+      coloring_ = DSC::make_unique< EntityColoringType >(this->grid_view(), *test_space_, include_neighbors);
+    assemble(*coloring_);
+  } // ... assemble_colored(...)
 
 private:
+  typedef internal::BoundSpaces< TestSpaceType, AnsatzSpaceType > BoundSpacesType;
+
+  /// \brief Only the upper triangle of matrices of coinciding test and ansatz spaces may be assembled.
+  void check_storage(const MatrixStorage storage) const
+  {
+    if (storage == MatrixStorage::upper_triangle
+        && (!std::is_same< TestSpaceType, AnsatzSpaceType >::value
+            || test_space_->mapper().size() != ansatz_space_->mapper().size()))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Only the upper triangle of matrices of coinciding test and ansatz spaces may be assembled!");
+  } // ... check_storage(...)
+
+  template< class MatrixType >
+  void precompute_scatter_offsets(const MatrixType& matrix,
+                                  const MatrixStorage storage,
+                                  const bool include_faces,
+                                  std::true_type)
+  {
+    scatter_offsets_[&matrix] = std::make_shared< const ScatterOffsetsType >(this->grid_view(),
+                                                                             *test_space_,
+                                                                             *ansatz_space_,
+                                                                             matrix,
+                                                                             storage,
+                                                                             include_faces);
+  } // ... precompute_scatter_offsets(...)
+
+  template< class MatrixType >
+  void precompute_scatter_offsets(const MatrixType& /*matrix*/,
+                                  const MatrixStorage /*storage*/,
+                                  const bool /*include_faces*/,
+                                  std::false_type)
+  {}
+
+  /// \brief Returns the offsets of matrix, if they are present and usable by a local assembler of the given storage.
+  template< class M >
+  std::shared_ptr< const ScatterOffsetsType >
+  matching_scatter_offsets(const Stuff::LA::MatrixInterface< M, RangeFieldType >& matrix,
+                           const MatrixStorage storage,
+                           const bool requires_faces) const
+  {
+    const auto offsets = scatter_offsets(matrix);
+    if (offsets && offsets->storage() == storage && (offsets->includes_faces() || !requires_faces))
+      return offsets;
+    return nullptr;
+  } // ... matching_scatter_offsets(...)
+
+  /// \brief Returns the (unique) wrapper of the given matrix or vector, shared by all local assemblers using it.
+  template< class ContainerType >
+  internal::ThreadLocalContainer< ContainerType >& thread_local_container(ContainerType& container)
+  {
+    auto& wrapper = thread_local_containers_[&container];
+    if (!wrapper)
+      wrapper.reset(new internal::ThreadLocalContainer< ContainerType >(container));
+    return static_cast< internal::ThreadLocalContainer< ContainerType >& >(*wrapper);
+  } // ... thread_local_container(...)
+
+  /// \brief Applies all codim 0 functors on the entity and all codim 1 functors on its intersections.
+  void walk_entity(const EntityType& entity)
+  {
+    this->apply_local(entity);
+    if (this->codim1_functors_.size() > 0) {
+      const auto& grid_view = this->grid_view();
+      const auto intersection_it_end = grid_view.iend(entity);
+      for (auto intersection_it = grid_view.ibegin(entity);
+           intersection_it != intersection_it_end;
+           ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        if (intersection.neighbor()) {
+          const auto neighbor_ptr = intersection.outside();
+          this->apply_local(intersection, entity, *neighbor_ptr);
+        } else
+          this->apply_local(intersection, entity, entity);
+      }
+    }
+  } // ... walk_entity(...)
+
   const DS::PerThreadValue< const TestSpaceType > test_space_;
   const DS::PerThreadValue< const AnsatzSpaceType > ansatz_space_;
+  DS::PerThreadValue< BoundSpacesType > bound_spaces_;
+  std::unique_ptr< const EntityColoringType > coloring_;
+  std::map< const void*, std::unique_ptr< internal::ThreadLocalContainerInterface > > thread_local_containers_;
+  std::map< const void*, std::shared_ptr< const ScatterOffsetsType > > scatter_offsets_;
 }; // class SystemAssembler
 
 
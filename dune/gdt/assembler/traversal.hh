@@ -0,0 +1,108 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_ASSEMBLER_TRAVERSAL_HH
+#define DUNE_GDT_ASSEMBLER_TRAVERSAL_HH
+
+#include <vector>
+
+#if HAVE_TBB
+# include <tbb/blocked_range.h>
+# include <tbb/parallel_for.h>
+#endif
+
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/parallel/threadstorage.hh>
+
+#include <dune/gdt/grid/space-filling-curve.hh>
+
+namespace Dune {
+namespace GDT {
+namespace internal {
+
+
+/**
+ * \brief Calls functor(entity) for all codim 0 entities of grid_view, in the order of traversal if given and in the
+ *        order of the grid view otherwise.
+ */
+template< class GridViewType, class FunctorType >
+void for_each_entity(const GridViewType& grid_view,
+                     const SpaceFillingCurveTraversal< GridViewType >* traversal,
+                     const FunctorType& functor)
+{
+  if (traversal) {
+    for (const auto& entity : *traversal)
+      functor(entity);
+  } else {
+    for (const auto& entity : DSC::entityRange(grid_view))
+      functor(entity);
+  }
+} // ... for_each_entity(...)
+
+
+/**
+ * \brief Calls functor(entity) for all codim 0 entities of grid_view, in parallel if TBB is available: one partition
+ *        of traversal after another per thread if given, chunks of the entities of the grid view otherwise. Falls back
+ *        to for_each_entity() without TBB.
+ * \note  functor is called concurrently, so it has to take care of its own thread safety.
+ */
+template< class GridViewType, class FunctorType >
+void parallel_for_each_entity(const GridViewType& grid_view,
+                              const SpaceFillingCurveTraversal< GridViewType >* traversal,
+                              const FunctorType& functor)
+{
+#if HAVE_TBB
+  if (traversal) {
+    tbb::parallel_for(tbb::blocked_range< size_t >(0, traversal->partitions(), 1),
+                      [&](const tbb::blocked_range< size_t >& range) {
+      for (size_t pp = range.begin(); pp != range.end(); ++pp)
+        for (const auto& entity : traversal->partition(pp))
+          functor(entity);
+    });
+  } else {
+    typedef typename GridViewType::template Codim< 0 >::Entity::EntitySeed EntitySeedType;
+    std::vector< EntitySeedType > seeds;
+    seeds.reserve(grid_view.size(0));
+    for (const auto& entity : DSC::entityRange(grid_view))
+      seeds.push_back(entity.seed());
+    const auto& grid = grid_view.grid();
+    tbb::parallel_for(tbb::blocked_range< size_t >(0, seeds.size()), [&](const tbb::blocked_range< size_t >& range) {
+      for (size_t ee = range.begin(); ee != range.end(); ++ee) {
+        const auto entity_ptr = grid.entity(seeds[ee]);
+        functor(*entity_ptr);
+      }
+    });
+  }
+#else // HAVE_TBB
+  for_each_entity(grid_view, traversal, functor);
+#endif // HAVE_TBB
+} // ... parallel_for_each_entity(...)
+
+
+/**
+ * \brief Calls functor(space, entity) for all codim 0 entities of grid_view as parallel_for_each_entity(), where space
+ *        is the copy of the given space of the calling thread (spaces are not thread safe, as in the SystemAssembler).
+ * \note  If functor writes into a copy-on-write container (e.g. by set_entry), the container has to be detached before
+ *        (e.g. by clearing it), since this must not happen concurrently.
+ */
+template< class GridViewType, class SpaceType, class FunctorType >
+void parallel_for_each_entity_with_space(const GridViewType& grid_view,
+                                         const SpaceFillingCurveTraversal< GridViewType >* traversal,
+                                         const SpaceType& space,
+                                         const FunctorType& functor)
+{
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  DS::PerThreadValue< const SpaceType > spaces(space);
+  parallel_for_each_entity(grid_view, traversal, [&](const EntityType& entity) {
+    functor(*spaces, entity);
+  });
+} // ... parallel_for_each_entity_with_space(...)
+
+
+} // namespace internal
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_ASSEMBLER_TRAVERSAL_HH
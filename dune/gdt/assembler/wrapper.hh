@@ -1,10 +1,19 @@
 #ifndef DUNE_GDT_ASSEMBLER_WRAPPER_HH
 #define DUNE_GDT_ASSEMBLER_WRAPPER_HH
 
+#include <memory>
+#include <mutex>
 #include <type_traits>
+#include <vector>
+
+#if HAVE_TBB
+# include <tbb/blocked_range.h>
+# include <tbb/parallel_for.h>
+#endif
 
 #include <dune/common/unused.hh>
 
+#include <dune/stuff/common/parallel/threadstorage.hh>
 #include <dune/stuff/common/tmp-storage.hh>
 #include <dune/stuff/la/container/interfaces.hh>
 #include <dune/stuff/grid/walker.hh>
@@ -17,6 +26,7 @@
 
 #include "local/codim0.hh"
 #include "local/codim1.hh"
+#include "scatter-offsets.hh"
 #include "tmp-storage.hh"
 
 namespace Dune {
@@ -24,6 +34,97 @@ namespace GDT {
 namespace internal {
 
 
+class ThreadLocalContainerInterface
+{
+public:
+  virtual ~ThreadLocalContainerInterface() {}
+
+  /// \brief From now on, each thread assembles into its own (zero initialized) copy of the container.
+  virtual void enable() = 0;
+
+  /// \brief Adds all thread local copies to the container, the container is used directly from now on.
+  virtual void reduce() = 0;
+}; // class ThreadLocalContainerInterface
+
+
+/**
+ * \brief Gives access to a matrix or vector to assemble into, which is either the container itself or a thread local
+ *        copy of it.
+ *
+ *        The copies are created on first access of each thread (thus sharing the sparsity pattern of the container).
+ *        They are summed up pairwise in parallel in reduce() and live as long as this wrapper, i.e. for one assembly
+ *        (the SystemAssembler drops all wrappers along with the local assemblers after each assembly).
+ */
+template< class ContainerImp >
+class ThreadLocalContainer
+  : public ThreadLocalContainerInterface
+{
+public:
+  typedef ContainerImp ContainerType;
+
+  explicit ThreadLocalContainer(ContainerType& container)
+    : container_(container)
+    , enabled_(false)
+    , thread_local_copy_(nullptr)
+  {}
+
+  virtual ~ThreadLocalContainer() {}
+
+  /// \brief Returns the container the calling thread has to assemble into.
+  ContainerType& get()
+  {
+    if (!enabled_)
+      return container_;
+    auto& copy = *thread_local_copy_;
+    if (!copy) {
+      copy = std::make_shared< ContainerType >(container_.copy());
+      copy->scal(0.0);
+      std::lock_guard< std::mutex > DUNE_UNUSED(mutex_guard)(mutex_);
+      copies_.push_back(copy);
+    }
+    return *copy;
+  } // ... get(...)
+
+  virtual void enable() override final
+  {
+    enabled_ = true;
+  }
+
+  virtual void reduce() override final
+  {
+    enabled_ = false;
+    if (copies_.empty())
+      return;
+    // sum up the copies pairwise, the result ends up in the first one
+    for (size_t stride = 1; stride < copies_.size(); stride *= 2) {
+      const size_t num_pairs = (copies_.size() + 2*stride - 1) / (2*stride);
+#if HAVE_TBB
+      tbb::parallel_for(tbb::blocked_range< size_t >(0, num_pairs), [&](const tbb::blocked_range< size_t >& range) {
+        for (size_t pp = range.begin(); pp != range.end(); ++pp)
+          add_pair(2*stride*pp, stride);
+      });
+#else // HAVE_TBB
+      for (size_t pp = 0; pp < num_pairs; ++pp)
+        add_pair(2*stride*pp, stride);
+#endif // HAVE_TBB
+    }
+    container_.axpy(1.0, *copies_[0]);
+  } // ... reduce(...)
+
+private:
+  void add_pair(const size_t first, const size_t stride)
+  {
+    if (first + stride < copies_.size())
+      copies_[first]->axpy(1.0, *copies_[first + stride]);
+  }
+
+  ContainerType& container_;
+  bool enabled_;
+  DS::PerThreadValue< std::shared_ptr< ContainerType > > thread_local_copy_;
+  std::vector< std::shared_ptr< ContainerType > > copies_;
+  std::mutex mutex_;
+}; // class ThreadLocalContainer
+
 
 template< class TestSpaceType, class AnsatzSpaceType, class GridViewType, class ConstraintsType >
 class ConstraintsWrapper
@@ -83,6 +184,38 @@ private:
 }; // class ConstraintsWrapper
 
 
+/**
+ * \brief The test and ansatz space of a SystemAssembler, bound to the entity (inside) and the neighbor (outside) of
+ *        the current step of the grid walk.
+ *
+ *        One of these exists per thread and is shared by all local assemblers, so that each base function set and all
+ *        global indices are computed at most once per entity (and neighbor), no matter how many local assemblers are
+ *        registered.
+ */
+template< class TestSpaceType, class AnsatzSpaceType >
+struct BoundSpaces
+{
+  template< class EntityType >
+  void bind_inside(const TestSpaceType& test_space, const AnsatzSpaceType& ansatz_space, const EntityType& entity)
+  {
+    test_inside.bind(test_space, entity);
+    ansatz_inside.bind(ansatz_space, entity);
+  }
+
+  template< class EntityType >
+  void bind_outside(const TestSpaceType& test_space, const AnsatzSpaceType& ansatz_space, const EntityType& entity)
+  {
+    test_outside.bind(test_space, entity);
+    ansatz_outside.bind(ansatz_space, entity);
+  }
+
+  LocalAssembler::BoundSpace< TestSpaceType >   test_inside;
+  LocalAssembler::BoundSpace< AnsatzSpaceType > ansatz_inside;
+  LocalAssembler::BoundSpace< TestSpaceType >   test_outside;
+  LocalAssembler::BoundSpace< AnsatzSpaceType > ansatz_outside;
+}; // struct BoundSpaces
+
+
 template< class AssemblerType, class LocalVolumeMatrixAssembler, class MatrixType >
 class LocalVolumeMatrixAssemblerWrapper
   : public Stuff::Grid::internal::Codim0Object<typename AssemblerType::GridViewType>
@@ -94,20 +227,30 @@ public:
   typedef typename AssemblerType::AnsatzSpaceType AnsatzSpaceType;
   typedef typename AssemblerType::GridViewType    GridViewType;
   typedef typename AssemblerType::EntityType      EntityType;
+  typedef BoundSpaces< TestSpaceType, AnsatzSpaceType > BoundSpacesType;
+  typedef ScatterOffsets< GridViewType >                ScatterOffsetsType;
 
+  /**
+   * \param scatter_offsets If given, the local matrices of LocalAssembler::Codim0Matrix are added at these offsets,
+   *                        \sa ScatterOffsets.
+   */
   LocalVolumeMatrixAssemblerWrapper(const DS::PerThreadValue< const TestSpaceType >& test_space,
                                     const DS::PerThreadValue< const AnsatzSpaceType >& ansatz_space,
+                                    const DS::PerThreadValue< BoundSpacesType >& bound_spaces,
                                     const Stuff::Grid::ApplyOn::WhichEntity< GridViewType >* where,
                                     const LocalVolumeMatrixAssembler& localAssembler,
-                                    MatrixType& matrix)
+                                    ThreadLocalContainer< MatrixType >& matrix,
+                                    std::shared_ptr< const ScatterOffsetsType > scatter_offsets = nullptr)
     : TmpMatricesProvider(localAssembler.numTmpObjectsRequired(),
                           test_space->mapper().maxNumDofs(),
                           ansatz_space->mapper().maxNumDofs())
     , test_space_(test_space)
     , ansatz_space_(ansatz_space)
+    , bound_spaces_(bound_spaces)
     , where_(where)
     , localMatrixAssembler_(localAssembler)
     , matrix_(matrix)
+    , scatter_offsets_(scatter_offsets)
   {}
 
   virtual ~LocalVolumeMatrixAssemblerWrapper() {}
@@ -119,15 +262,61 @@ public:
 
   virtual void apply_local(const EntityType& entity) override final
   {
-    localMatrixAssembler_.assembleLocal(*test_space_, *ansatz_space_, entity, matrix_, this->matrices(), this->indices());
+    assemble_local(localMatrixAssembler_, entity);
   }
 
 private:
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim0Matrix< L >& localAssembler, const EntityType& entity)
+  {
+    assemble_local(localAssembler,
+                   entity,
+                   std::integral_constant< bool, LocalAssembler::internal::CsrValues< MatrixType >::available >());
+  }
+
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim0Matrix< L >& localAssembler,
+                      const EntityType& entity,
+                      std::true_type)
+  {
+    if (scatter_offsets_) {
+      const auto& bound_spaces = *bound_spaces_;
+      localAssembler.assembleLocal(bound_spaces.test_inside, bound_spaces.ansatz_inside,
+                                   scatter_offsets_->local(entity),
+                                   matrix_.get(),
+                                   this->matrices());
+    } else
+      assemble_local(localAssembler, entity, std::false_type());
+  } // ... assemble_local(...)
+
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim0Matrix< L >& localAssembler,
+                      const EntityType& /*entity*/,
+                      std::false_type)
+  {
+    const auto& bound_spaces = *bound_spaces_;
+    localAssembler.assembleLocal(bound_spaces.test_inside, bound_spaces.ansatz_inside,
+                                 matrix_.get(),
+                                 this->matrices(), this->indices());
+  }
+
+  // for the local assemblers given to SystemAssembler::add_codim0_assembler()
+  template< class LocalAssemblerType >
+  void assemble_local(const LocalAssemblerType& localAssembler, const EntityType& entity)
+  {
+    localAssembler.assembleLocal(*test_space_, *ansatz_space_,
+                                 entity,
+                                 matrix_.get(),
+                                 this->matrices(), this->indices());
+  }
+
   const DS::PerThreadValue< const TestSpaceType >& test_space_;
   const DS::PerThreadValue< const AnsatzSpaceType >& ansatz_space_;
+  const DS::PerThreadValue< BoundSpacesType >& bound_spaces_;
   const std::unique_ptr< const Stuff::Grid::ApplyOn::WhichEntity< GridViewType > > where_;
   const LocalVolumeMatrixAssembler& localMatrixAssembler_;
-  MatrixType& matrix_;
+  ThreadLocalContainer< MatrixType >& matrix_;
+  const std::shared_ptr< const ScatterOffsetsType > scatter_offsets_;
 }; // class LocalVolumeMatrixAssemblerWrapper
 
 
@@ -143,20 +332,28 @@ public:
   typedef typename AssemblerType::GridViewType                                             GridViewType;
   typedef typename AssemblerType::EntityType                                               EntityType;
   typedef typename Stuff::Grid::internal::Codim1Object< GridViewType >::IntersectionType   IntersectionType;
+  typedef BoundSpaces< TestSpaceType, AnsatzSpaceType >                                    BoundSpacesType;
+  typedef ScatterOffsets< GridViewType >                                                   ScatterOffsetsType;
 
+  /**
+   * \param scatter_offsets If given, the local matrices are added at these offsets (\sa ScatterOffsets), which have to
+   *                        include the faces for LocalAssembler::Codim1CouplingMatrix.
+   */
   LocalFaceMatrixAssemblerWrapper(const DS::PerThreadValue< const TestSpaceType >& test_space,
                                   const DS::PerThreadValue< const AnsatzSpaceType >& ansatz_space,
+                                  const DS::PerThreadValue< BoundSpacesType >& bound_spaces,
                                   const Stuff::Grid::ApplyOn::WhichIntersection< GridViewType >* where,
                                   const LocalFaceMatrixAssembler& localAssembler,
-                                  MatrixType& matrix)
+                                  ThreadLocalContainer< MatrixType >& matrix,
+                                  std::shared_ptr< const ScatterOffsetsType > scatter_offsets = nullptr)
     : TmpMatricesProvider(localAssembler.numTmpObjectsRequired(),
                           test_space->mapper().maxNumDofs(),
                           ansatz_space->mapper().maxNumDofs())
-    , test_space_(test_space)
-    , ansatz_space_(ansatz_space)
+    , bound_spaces_(bound_spaces)
     , where_(where)
     , localMatrixAssembler_(localAssembler)
     , matrix_(matrix)
+    , scatter_offsets_(scatter_offsets)
   {}
 
   virtual ~LocalFaceMatrixAssemblerWrapper() {}
@@ -167,21 +364,89 @@ public:
   }
 
   virtual void apply_local(const IntersectionType& intersection,
-                           const EntityType& /*inside_entity*/,
-                           const EntityType& /*outside_entity*/) override final
+                           const EntityType& inside_entity,
+                           const EntityType& outside_entity) override final
   {
-    localMatrixAssembler_.assembleLocal(*test_space_, *ansatz_space_,
-                                        intersection,
-                                        matrix_,
-                                        this->matrices(), this->indices());
+    assemble_local(localMatrixAssembler_,
+                   intersection,
+                   inside_entity,
+                   outside_entity,
+                   std::integral_constant< bool, LocalAssembler::internal::CsrValues< MatrixType >::available >());
   } // ... apply_local(...)
 
 private:
-  const DS::PerThreadValue< const TestSpaceType >& test_space_;
-  const DS::PerThreadValue< const AnsatzSpaceType >& ansatz_space_;
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim1CouplingMatrix< L >& localAssembler,
+                      const IntersectionType& intersection,
+                      const EntityType& inside_entity,
+                      const EntityType& outside_entity,
+                      std::true_type)
+  {
+    if (scatter_offsets_) {
+      const auto& bound_spaces = *bound_spaces_;
+      localAssembler.assembleLocal(bound_spaces.test_inside, bound_spaces.ansatz_inside,
+                                   bound_spaces.test_outside, bound_spaces.ansatz_outside,
+                                   intersection,
+                                   scatter_offsets_->coupling(inside_entity, outside_entity),
+                                   matrix_.get(),
+                                   this->matrices());
+    } else
+      assemble_local(localAssembler, intersection, inside_entity, outside_entity, std::false_type());
+  } // ... assemble_local(...)
+
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim1CouplingMatrix< L >& localAssembler,
+                      const IntersectionType& intersection,
+                      const EntityType& /*inside_entity*/,
+                      const EntityType& /*outside_entity*/,
+                      std::false_type)
+  {
+    const auto& bound_spaces = *bound_spaces_;
+    auto& matrix = matrix_.get();
+    localAssembler.assembleLocal(bound_spaces.test_inside, bound_spaces.ansatz_inside,
+                                 bound_spaces.test_outside, bound_spaces.ansatz_outside,
+                                 intersection,
+                                 matrix, matrix, matrix, matrix,
+                                 this->matrices(), this->indices());
+  } // ... assemble_local(...)
+
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim1BoundaryMatrix< L >& localAssembler,
+                      const IntersectionType& intersection,
+                      const EntityType& inside_entity,
+                      const EntityType& outside_entity,
+                      std::true_type)
+  {
+    if (scatter_offsets_) {
+      const auto& bound_spaces = *bound_spaces_;
+      localAssembler.assembleLocal(bound_spaces.test_inside, bound_spaces.ansatz_inside,
+                                   intersection,
+                                   scatter_offsets_->local(inside_entity),
+                                   matrix_.get(),
+                                   this->matrices());
+    } else
+      assemble_local(localAssembler, intersection, inside_entity, outside_entity, std::false_type());
+  } // ... assemble_local(...)
+
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim1BoundaryMatrix< L >& localAssembler,
+                      const IntersectionType& intersection,
+                      const EntityType& /*inside_entity*/,
+                      const EntityType& /*outside_entity*/,
+                      std::false_type)
+  {
+    const auto& bound_spaces = *bound_spaces_;
+    localAssembler.assembleLocal(bound_spaces.test_inside, bound_spaces.ansatz_inside,
+                                 intersection,
+                                 matrix_.get(),
+                                 this->matrices(), this->indices());
+  } // ... assemble_local(...)
+
+  const DS::PerThreadValue< BoundSpacesType >& bound_spaces_;
   const std::unique_ptr< const Stuff::Grid::ApplyOn::WhichIntersection< GridViewType > > where_;
   const LocalFaceMatrixAssembler& localMatrixAssembler_;
-  MatrixType& matrix_;
+  ThreadLocalContainer< MatrixType >& matrix_;
+  const std::shared_ptr< const ScatterOffsetsType > scatter_offsets_;
 }; // class LocalFaceMatrixAssemblerWrapper
 
 
@@ -192,16 +457,20 @@ class LocalVolumeVectorAssemblerWrapper
 {
   typedef DSC::TmpVectorsStorage< typename AssemblerType::TestSpaceType::RangeFieldType > TmpVectorsProvider;
 public:
-  typedef typename AssemblerType::TestSpaceType TestSpaceType;
-  typedef typename AssemblerType::GridViewType  GridViewType;
-  typedef typename AssemblerType::EntityType    EntityType;
+  typedef typename AssemblerType::TestSpaceType   TestSpaceType;
+  typedef typename AssemblerType::AnsatzSpaceType AnsatzSpaceType;
+  typedef typename AssemblerType::GridViewType    GridViewType;
+  typedef typename AssemblerType::EntityType      EntityType;
+  typedef BoundSpaces< TestSpaceType, AnsatzSpaceType > BoundSpacesType;
 
   LocalVolumeVectorAssemblerWrapper(const DS::PerThreadValue< const TestSpaceType >& space,
+                                    const DS::PerThreadValue< BoundSpacesType >& bound_spaces,
                                     const Stuff::Grid::ApplyOn::WhichEntity< GridViewType >* where,
                                     const LocalVolumeVectorAssembler& localAssembler,
-                                    VectorType& vector)
+                                    ThreadLocalContainer< VectorType >& vector)
     : TmpVectorsProvider(localAssembler.numTmpObjectsRequired(), space->mapper().maxNumDofs())
     , space_(space)
+    , bound_spaces_(bound_spaces)
     , where_(where)
     , localVectorAssembler_(localAssembler)
     , vector_(vector)
@@ -216,14 +485,28 @@ public:
 
   virtual void apply_local(const EntityType& entity) override final
   {
-    localVectorAssembler_.assembleLocal(*space_, entity, vector_, this->vectors(), this->indices());
+    assemble_local(localVectorAssembler_, entity);
   }
 
 private:
+  template< class L >
+  void assemble_local(const LocalAssembler::Codim0Vector< L >& localAssembler, const EntityType& /*entity*/)
+  {
+    localAssembler.assembleLocal(bound_spaces_->test_inside, vector_.get(), this->vectors());
+  }
+
+  // for the local assemblers given to SystemAssembler::add_codim0_assembler()
+  template< class LocalAssemblerType >
+  void assemble_local(const LocalAssemblerType& localAssembler, const EntityType& entity)
+  {
+    localAssembler.assembleLocal(*space_, entity, vector_.get(), this->vectors(), this->indices());
+  }
+
   const DS::PerThreadValue< const TestSpaceType >& space_;
+  const DS::PerThreadValue< BoundSpacesType >& bound_spaces_;
   const std::unique_ptr< const Stuff::Grid::ApplyOn::WhichEntity< GridViewType > > where_;
   const LocalVolumeVectorAssembler& localVectorAssembler_;
-  VectorType& vector_;
+  ThreadLocalContainer< VectorType >& vector_;
 }; // class LocalVolumeVectorAssemblerWrapper
 
 
@@ -235,16 +518,19 @@ class LocalFaceVectorAssemblerWrapper
   typedef DSC::TmpVectorsStorage< typename AssemblerType::TestSpaceType::RangeFieldType > TmpVectorsProvider;
 public:
   typedef typename AssemblerType::TestSpaceType                                          TestSpaceType;
+  typedef typename AssemblerType::AnsatzSpaceType                                        AnsatzSpaceType;
   typedef typename AssemblerType::GridViewType                                           GridViewType;
   typedef typename AssemblerType::EntityType                                             EntityType;
   typedef typename Stuff::Grid::internal::Codim1Object< GridViewType >::IntersectionType IntersectionType;
+  typedef BoundSpaces< TestSpaceType, AnsatzSpaceType >                                  BoundSpacesType;
 
   LocalFaceVectorAssemblerWrapper(const DS::PerThreadValue< const TestSpaceType >& space,
+                                  const DS::PerThreadValue< BoundSpacesType >& bound_spaces,
                                   const Stuff::Grid::ApplyOn::WhichIntersection< GridViewType >* where,
                                   const LocalFaceVectorAssembler& localAssembler,
-                                  VectorType& vector)
+                                  ThreadLocalContainer< VectorType >& vector)
     : TmpVectorsProvider(localAssembler.numTmpObjectsRequired(), space->mapper().maxNumDofs())
-    , space_(space)
+    , bound_spaces_(bound_spaces)
     , where_(where)
     , localVectorAssembler_(localAssembler)
     , vector_(vector)
@@ -261,14 +547,14 @@ public:
                            const EntityType& /*inside_entity*/,
                            const EntityType& /*outside_entity*/) override final
   {
-    localVectorAssembler_.assembleLocal(*space_, intersection, vector_, this->vectors(), this->indices());
+    localVectorAssembler_.assembleLocal(bound_spaces_->test_inside, intersection, vector_.get(), this->vectors());
   }
 
 private:
-  const DS::PerThreadValue< const TestSpaceType >& space_;
+  const DS::PerThreadValue< BoundSpacesType >& bound_spaces_;
   const std::unique_ptr< const Stuff::Grid::ApplyOn::WhichIntersection< GridViewType > > where_;
   const LocalFaceVectorAssembler& localVectorAssembler_;
-  VectorType& vector_;
+  ThreadLocalContainer< VectorType >& vector_;
 }; // class LocalFaceVectorAssemblerWrapper
 
 
@@ -58,6 +58,7 @@ public:
   using typename BaseType::DomainType;
   using typename BaseType::RangeType;
   using typename BaseType::JacobianRangeType;
+  using typename BaseType::QuadratureType;
 
   FiniteVolume(const EntityType& en)
     : BaseType(en)
@@ -101,6 +102,16 @@ public:
 
   using BaseType::jacobian;
 
+  void evaluate_all(const QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    ret.assign(quadrature.size(), RangeType(1));
+  }
+
+  void jacobian_all(const QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    ret.assign(quadrature.size(), JacobianRangeType(0));
+  }
+
 private:
   const BackendType backend_;
 }; // class FiniteVolume< ..., 1, 1 >
@@ -123,6 +134,7 @@ public:
   using BaseType::dimRange;
   using typename BaseType::RangeType;
   using typename BaseType::JacobianRangeType;
+  using typename BaseType::QuadratureType;
 
   FiniteVolume(const EntityType& en)
     : BaseType(en)
@@ -170,6 +182,19 @@ public:
 
   using BaseType::jacobian;
 
+  void evaluate_all(const QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    ret.assign(quadrature.size() * dimRange, RangeType(0));
+    for (size_t qq = 0; qq < quadrature.size(); ++qq)
+      for (size_t ii = 0; ii < dimRange; ++ii)
+        ret[qq * dimRange + ii][ii] = 1.0;
+  } // ... evaluate_all(...)
+
+  void jacobian_all(const QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    ret.assign(quadrature.size() * dimRange, JacobianRangeType(0));
+  }
+
 private:
   const BackendType backend_;
 }; // class FiniteVolume< ..., rangeDim, 1 >
@@ -107,9 +107,21 @@ public:
 
   using BaseType::jacobian;
 
+  void evaluate_all(const typename BaseType::QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    this->evaluate_all_pointwise(quadrature, ret, tmp_values_);
+  }
+
+  void jacobian_all(const typename BaseType::QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    this->jacobian_all_pointwise(quadrature, ret, tmp_jacobians_);
+  }
+
 private:
   const BaseFunctionSetMapImp& baseFunctionSetMap_;
   std::unique_ptr< const BackendType > backend_;
+  mutable std::vector< RangeType > tmp_values_;
+  mutable std::vector< JacobianRangeType > tmp_jacobians_;
 }; // class FemLocalfunctionsWrapper
 
 
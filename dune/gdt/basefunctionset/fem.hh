@@ -6,6 +6,8 @@
 #ifndef DUNE_GDT_BASEFUNCTIONSET_FEM_HH
 #define DUNE_GDT_BASEFUNCTIONSET_FEM_HH
 
+#include <vector>
+
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
 
@@ -123,8 +125,20 @@ public:
 
   using BaseType::jacobian;
 
+  void evaluate_all(const typename BaseType::QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    this->evaluate_all_pointwise(quadrature, ret, tmp_values_);
+  }
+
+  void jacobian_all(const typename BaseType::QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    this->jacobian_all_pointwise(quadrature, ret, tmp_jacobians_);
+  }
+
 private:
   std::unique_ptr< const BackendType > backend_;
+  mutable std::vector< RangeType > tmp_values_;
+  mutable std::vector< JacobianRangeType > tmp_jacobians_;
 }; // class FemWrapper
 
 
@@ -8,6 +8,11 @@
 #ifndef DUNE_GDT_BASEFUNCTIONSET_INTERFACE_HH
 #define DUNE_GDT_BASEFUNCTIONSET_INTERFACE_HH
 
+#include <algorithm>
+#include <vector>
+
+#include <dune/geometry/quadraturerules.hh>
+
 #include <dune/stuff/functions/interfaces.hh>
 #include <dune/stuff/common/crtp.hh>
 
@@ -16,8 +21,9 @@ namespace GDT {
 
 
 /**
- *  \brief  The purpose of this interface is just to be used for template matching and to allow for access to the
- *          backend. All other functionality is enforced by Stuff::LocalfunctionSetInterface.
+ *  \brief  The purpose of this interface is to be used for template matching, to allow for access to the backend and
+ *          to evaluate all functions at all points of a quadrature at once (see evaluate_all() and jacobian_all()).
+ *          All other functionality is enforced by Stuff::LocalfunctionSetInterface.
  *
  *          \see Stuff::LocalfunctionSetInterface for the template parameters D, d, R, r and rC.
  */
@@ -32,6 +38,11 @@ public:
   typedef typename Traits::BackendType  BackendType;
   typedef typename Traits::EntityType   EntityType;
 
+  using typename BaseType::DomainType;
+  using typename BaseType::RangeType;
+  using typename BaseType::JacobianRangeType;
+  typedef Dune::QuadratureRule< D, d > QuadratureType;
+
   explicit BaseFunctionSetInterface(const EntityType& ent)
     : BaseType(ent)
   {}
@@ -41,6 +52,66 @@ public:
     CHECK_CRTP(this->as_imp(*this).backend());
     return this->as_imp(*this).backend();
   }
+
+  /**
+   * \brief Evaluates all functions at all points of the quadrature.
+   *
+   *        Afterwards, ret[qq * size() + ii] is the value of the ii-th function at the qq-th point, i.e. the values of
+   *        all functions at one point are contiguous and the values at all points are stored in one contiguous table.
+   *        ret is resized accordingly, it should thus be reused to avoid allocations.
+   */
+  void evaluate_all(const QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    CHECK_AND_CALL_CRTP(this->as_imp(*this).evaluate_all(quadrature, ret));
+  }
+
+  /**
+   * \brief Evaluates the jacobians of all functions at all points of the quadrature, the layout of ret is the same as
+   *        in evaluate_all().
+   */
+  void jacobian_all(const QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    CHECK_AND_CALL_CRTP(this->as_imp(*this).jacobian_all(quadrature, ret));
+  }
+
+protected:
+  /**
+   * \brief Implements evaluate_all() by evaluating at one point after another into tmp, which is copied into ret.
+   */
+  void evaluate_all_pointwise(const QuadratureType& quadrature,
+                              std::vector< RangeType >& ret,
+                              std::vector< RangeType >& tmp) const
+  {
+    const size_t sz = this->size();
+    if (tmp.size() < sz)
+      tmp.resize(sz, RangeType(0));
+    ret.resize(quadrature.size() * sz);
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      this->evaluate(quadrature_point.position(), tmp);
+      std::copy(tmp.begin(), tmp.begin() + sz, ret.begin() + qq * sz);
+      ++qq;
+    }
+  } // ... evaluate_all_pointwise(...)
+
+  /**
+   * \brief Implements jacobian_all() by evaluating at one point after another into tmp, which is copied into ret.
+   */
+  void jacobian_all_pointwise(const QuadratureType& quadrature,
+                              std::vector< JacobianRangeType >& ret,
+                              std::vector< JacobianRangeType >& tmp) const
+  {
+    const size_t sz = this->size();
+    if (tmp.size() < sz)
+      tmp.resize(sz, JacobianRangeType(0));
+    ret.resize(quadrature.size() * sz);
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      this->jacobian(quadrature_point.position(), tmp);
+      std::copy(tmp.begin(), tmp.begin() + sz, ret.begin() + qq * sz);
+      ++qq;
+    }
+  } // ... jacobian_all_pointwise(...)
 }; // class BaseFunctionSetInterface
 
 
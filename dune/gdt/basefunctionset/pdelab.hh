@@ -6,16 +6,25 @@
 #ifndef DUNE_GDT_BASEFUNCTIONSET_PDELAB_HH
 #define DUNE_GDT_BASEFUNCTIONSET_PDELAB_HH
 
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
+#include <dune/common/unused.hh>
 
 #if HAVE_DUNE_PDELAB
 # include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
 #endif
 
+#include <dune/stuff/common/memory.hh>
 #include <dune/stuff/common/type_utils.hh>
 
 #include "interface.hh"
+#include "tabulation.hh"
 
 namespace Dune {
 namespace GDT {
@@ -46,6 +55,105 @@ class PiolaTransformedPdelabWrapper
 namespace internal {
 
 
+/**
+ * \brief The state of a PdelabWrapper or PiolaTransformedPdelabWrapper which does not depend on the entity: the local
+ *        function space (which is rebound to each entity) and scratch space.
+ */
+template< class PdelabSpaceImp, class RangeImp, class JacobianRangeImp >
+struct PdelabWrapperStorage
+{
+  typedef PdelabSpaceImp                                                      PdelabSpaceType;
+  typedef PDELab::LocalFunctionSpace< PdelabSpaceType, PDELab::TrialSpaceTag > PdelabLFSType;
+
+  explicit PdelabWrapperStorage(const PdelabSpaceType& space)
+    : lfs(space)
+  {}
+
+  PdelabLFSType lfs;
+  std::vector< RangeImp > tmp_ranges;
+  std::vector< JacobianRangeImp > tmp_jacobian_ranges;
+}; // struct PdelabWrapperStorage
+
+
+/**
+ * \brief A thread safe pool of PdelabWrapperStorage objects of one PDELab space.
+ *
+ *        Creating a local function space of a PDELab space requires several allocations. Instead, the base function
+ *        sets of a space acquire one from the pool of the space on construction and give it back on destruction, so
+ *        only as many storages are ever created as base function sets exist at the same time. The pool has to outlive
+ *        all base function sets created from it (as the PDELab space does anyway).
+ */
+template< class StorageImp >
+class PdelabWrapperPool
+{
+public:
+  typedef StorageImp                           StorageType;
+  typedef typename StorageType::PdelabSpaceType PdelabSpaceType;
+
+  class Releaser
+  {
+  public:
+    explicit Releaser(PdelabWrapperPool* pool = nullptr)
+      : pool_(pool)
+    {}
+
+    void operator()(StorageType* storage) const
+    {
+      if (pool_)
+        pool_->release(storage);
+      else
+        delete storage;
+    }
+
+  private:
+    PdelabWrapperPool* pool_;
+  }; // class Releaser
+
+  typedef std::unique_ptr< StorageType, Releaser > StoragePtrType;
+
+  explicit PdelabWrapperPool(const PdelabSpaceType& space)
+    : space_(space)
+  {}
+
+  PdelabWrapperPool(const PdelabWrapperPool& /*other*/) = delete;
+
+  PdelabWrapperPool& operator=(const PdelabWrapperPool& /*other*/) = delete;
+
+  StoragePtrType acquire()
+  {
+    std::unique_ptr< StorageType > storage;
+    {
+      std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+      if (!storages_.empty()) {
+        storage = std::move(storages_.back());
+        storages_.pop_back();
+      }
+    }
+    if (!storage)
+      storage = DSC::make_unique< StorageType >(space_);
+    return StoragePtrType(storage.release(), Releaser(this));
+  } // ... acquire(...)
+
+  /// \brief Creates a storage which is not backed by any pool.
+  static StoragePtrType create(const PdelabSpaceType& space)
+  {
+    return StoragePtrType(new StorageType(space), Releaser());
+  }
+
+private:
+  void release(StorageType* storage)
+  {
+    std::unique_ptr< StorageType > ptr(storage);
+    std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+    storages_.emplace_back(std::move(ptr));
+  }
+
+  const PdelabSpaceType& space_;
+  std::mutex mutex_;
+  std::vector< std::unique_ptr< StorageType > > storages_;
+}; // class PdelabWrapperPool
+
+
 // forward, to allow for specialization
 template< class PdelabSpaceImp, class EntityImp,
           class DomainFieldImp, size_t domainDim,
@@ -67,6 +175,10 @@ private:
 public:
   typedef typename FESwitchType::Basis BackendType;
   typedef EntityImp EntityType;
+  typedef PdelabWrapperStorage< PdelabSpaceImp,
+                                FieldVector< RangeFieldImp, 1 >,
+                                FieldMatrix< RangeFieldImp, 1, domainDim > > StorageType;
+  typedef PdelabWrapperPool< StorageType >                                    PoolType;
 private:
   friend class PdelabWrapper < PdelabSpaceImp, EntityImp, DomainFieldImp, domainDim, RangeFieldImp, 1, 1 >;
 };
@@ -87,6 +199,10 @@ private:
 public:
   typedef typename FESwitchType::Basis BackendType;
   typedef EntityImp EntityType;
+  typedef PdelabWrapperStorage< PdelabSpaceImp,
+                                FieldVector< RangeFieldImp, rangeDim >,
+                                FieldMatrix< RangeFieldImp, rangeDim, domainDim > > StorageType;
+  typedef PdelabWrapperPool< StorageType >                                           PoolType;
 private:
   friend class PiolaTransformedPdelabWrapper < PdelabSpaceImp, EntityImp, DomainFieldImp, domainDim, RangeFieldImp, rangeDim, 1 >;
 };
@@ -122,15 +238,17 @@ public:
   typedef typename BaseType::RangeType         RangeType;
   typedef typename BaseType::JacobianRangeType JacobianRangeType;
 
+  typedef typename Traits::PoolType PoolType;
+
+  /// \brief Creates a base function set with its own local function space, prefer the ctor taking a pool.
   PdelabWrapper(const PdelabSpaceType& space, const EntityType& ent)
-    : BaseType(ent)
-    , tmp_domain_(0)
-  {
-    PdelabLFSType* lfs_ptr = new PdelabLFSType(space);
-    lfs_ptr->bind(this->entity());
-    lfs_ = std::unique_ptr< PdelabLFSType >(lfs_ptr);
-    backend_ = std::unique_ptr< BackendType >(new BackendType(FESwitchType::basis(lfs_->finiteElement())));
-  } // PdelabWrapper(...)
+    : PdelabWrapper(PoolType::create(space), ent)
+  {}
+
+  /// \brief Creates a base function set, using a local function space of the given pool.
+  PdelabWrapper(PoolType& pool, const EntityType& ent)
+    : PdelabWrapper(pool.acquire(), ent)
+  {}
 
   PdelabWrapper(ThisType&& source) = default;
   PdelabWrapper(const ThisType& /*other*/) = delete;
@@ -139,47 +257,110 @@ public:
 
   const BackendType& backend() const
   {
-    return *backend_;
+    return backend_;
   }
 
   virtual size_t size() const override final
   {
-    return backend_->size();
+    return backend_.size();
   }
 
   virtual size_t order() const override final
   {
-    return backend_->order();
+    return backend_.order();
   }
 
   virtual void evaluate(const DomainType& xx, std::vector< RangeType >& ret) const override final
   {
-    assert(ret.size() >= backend_->size());
-    backend_->evaluateFunction(xx, ret);
+    assert(ret.size() >= backend_.size());
+    backend_.evaluateFunction(xx, ret);
   }
 
   using BaseType::evaluate;
 
   virtual void jacobian(const DomainType& xx, std::vector< JacobianRangeType >& ret) const override final
   {
-    assert(ret.size() >= backend_->size());
-    backend_->evaluateJacobian(xx, ret);
-    const auto jacobian_inverse_transposed = this->entity().geometry().jacobianInverseTransposed(xx);
+    assert(ret.size() >= backend_.size());
+    backend_.evaluateJacobian(xx, ret);
+    if (!jacobian_inverse_transposed_valid_) {
+      jacobian_inverse_transposed_ = this->entity().geometry().jacobianInverseTransposed(xx);
+      jacobian_inverse_transposed_valid_ = affine_;
+    }
     for (size_t ii = 0; ii < ret.size(); ++ii) {
-      jacobian_inverse_transposed.mv(ret[ii][0], tmp_domain_);
+      jacobian_inverse_transposed_.mv(ret[ii][0], tmp_domain_);
       ret[ii][0] = tmp_domain_;
     }
   } // ... jacobian(...)
 
   using BaseType::jacobian;
 
+  void evaluate_all(const typename BaseType::QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    this->evaluate_all_pointwise(quadrature, ret, storage_->tmp_ranges);
+  }
+
+  void jacobian_all(const typename BaseType::QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    this->jacobian_all_pointwise(quadrature, ret, storage_->tmp_jacobian_ranges);
+  }
+
+  /// \name Required by Tabulated.
+  /// \{
+
+  /**
+   * \note Assumes that the finite elements of the space are determined by their type, order and geometry type (which
+   *       does not hold for finite element maps with orientation dependent variants), \sa Tabulated::bind().
+   */
+  std::type_index reference_type() const
+  {
+    return std::type_index(typeid(storage_->lfs.finiteElement()));
+  }
+
+  void reference_jacobian(const DomainType& xx, std::vector< JacobianRangeType >& ret) const
+  {
+    assert(ret.size() >= backend_.size());
+    backend_.evaluateJacobian(xx, ret);
+  }
+
+  /// \}
+
 private:
+  typedef typename PoolType::StoragePtrType StoragePtrType;
+
+  PdelabWrapper(StoragePtrType&& storage, const EntityType& ent)
+    : BaseType(ent)
+    , storage_(std::move(storage))
+    , backend_(FESwitchType::basis(bound_lfs(*storage_, ent).finiteElement()))
+    , tmp_domain_(0)
+    , affine_(this->entity().geometry().affine())
+    , jacobian_inverse_transposed_valid_(false)
+    , jacobian_inverse_transposed_(DomainFieldImp(0))
+  {}
+
+  static const PdelabLFSType& bound_lfs(typename PoolType::StorageType& storage, const EntityType& ent)
+  {
+    storage.lfs.bind(ent);
+    return storage.lfs;
+  }
+
+  StoragePtrType storage_;
+  const BackendType backend_;
   mutable DomainType tmp_domain_;
-  std::unique_ptr< const PdelabLFSType > lfs_;
-  std::unique_ptr< const BackendType > backend_;
+  // the jacobian inverse transposed is constant on affine geometries, so it is only computed on first use there
+  const bool affine_;
+  mutable bool jacobian_inverse_transposed_valid_;
+  mutable typename EntityType::Geometry::JacobianInverseTransposed jacobian_inverse_transposed_;
 }; // class PdelabWrapper
 
 
+template< class PdelabSpaceType, class EntityImp,
+          class DomainFieldImp, size_t domainDim,
+          class RangeFieldImp >
+struct is_tabulatable< PdelabWrapper< PdelabSpaceType, EntityImp, DomainFieldImp, domainDim, RangeFieldImp, 1, 1 > >
+  : public std::true_type
+{};
+
+
 template< class PdelabSpaceType, class EntityImp,
           class DomainFieldImp, size_t domainDim,
           class RangeFieldImp, size_t rangeDim >
@@ -213,20 +394,19 @@ public:
   using typename BaseType::DomainType;
   using typename BaseType::RangeType;
   using typename BaseType::JacobianRangeType;
+  using typename BaseType::QuadratureType;
+
+  typedef typename Traits::PoolType PoolType;
 
+  /// \brief Creates a base function set with its own local function space, prefer the ctor taking a pool.
   PiolaTransformedPdelabWrapper(const PdelabSpaceType& space, const EntityType& ent)
-    : BaseType(ent)
-    , tmp_domain_(DomainFieldType(0))
-    , tmp_jacobian_transposed_(DomainFieldType(0))
-    , tmp_jacobian_inverse_transposed_(DomainFieldType(0))
-  {
-    PdelabLFSType* lfs_ptr = new PdelabLFSType(space);
-    lfs_ptr->bind(this->entity());
-    lfs_ = std::unique_ptr< PdelabLFSType >(lfs_ptr);
-    backend_ = std::unique_ptr< BackendType >(new BackendType(FESwitchType::basis(lfs_->finiteElement())));
-    tmp_ranges_ = std::vector< RangeType >(backend_->size(), RangeType(0));
-    tmp_jacobian_ranges_ = std::vector< JacobianRangeType >(backend_->size(), JacobianRangeType(0));
-  } // PdelabWrapper(...)
+    : PiolaTransformedPdelabWrapper(PoolType::create(space), ent)
+  {}
+
+  /// \brief Creates a base function set, using a local function space of the given pool.
+  PiolaTransformedPdelabWrapper(PoolType& pool, const EntityType& ent)
+    : PiolaTransformedPdelabWrapper(pool.acquire(), ent)
+  {}
 
   PiolaTransformedPdelabWrapper(ThisType&& source) = default;
 
@@ -236,32 +416,29 @@ public:
 
   const BackendType& backend() const
   {
-    return *backend_;
+    return backend_;
   }
 
   virtual size_t size() const override final
   {
-    return backend_->size();
+    return backend_.size();
   }
 
   virtual size_t order() const override final
   {
-    return backend_->order();
+    return backend_.order();
   }
 
   virtual void evaluate(const DomainType& xx, std::vector< RangeType >& ret) const override final
   {
-    assert(lfs_);
-    assert(backend_);
-    assert(tmp_ranges_.size() >= backend_->size());
-    assert(ret.size() >= backend_->size());
-    backend_->evaluateFunction(xx, tmp_ranges_);
-    const auto geometry = this->entity().geometry();
-    tmp_jacobian_transposed_ = geometry.jacobianTransposed(xx);
-    const DomainFieldType integration_element = geometry.integrationElement(xx);
-    for (size_t ii = 0; ii < backend_->size(); ++ii) {
-      tmp_jacobian_transposed_.mtv(tmp_ranges_[ii], ret[ii]);
-      ret[ii] /= integration_element;
+    assert(storage_->tmp_ranges.size() >= backend_.size());
+    assert(ret.size() >= backend_.size());
+    backend_.evaluateFunction(xx, storage_->tmp_ranges);
+    if (!affine_)
+      update_geometry(xx, false);
+    for (size_t ii = 0; ii < backend_.size(); ++ii) {
+      tmp_jacobian_transposed_.mtv(storage_->tmp_ranges[ii], ret[ii]);
+      ret[ii] /= tmp_integration_element_;
     }
   } // ... evaluate(...)
 
@@ -269,34 +446,113 @@ public:
 
   virtual void jacobian(const DomainType& xx, std::vector< JacobianRangeType >& ret) const override final
   {
-    assert(lfs_);
-    assert(backend_);
-    assert(ret.size() >= backend_->size());
-    backend_->evaluateJacobian(xx, tmp_jacobian_ranges_);
-    const auto geometry = this->entity().geometry();
-    tmp_jacobian_transposed_ = geometry.jacobianTransposed(xx);
-    tmp_jacobian_inverse_transposed_ = geometry.jacobianInverseTransposed(xx);
-    const DomainFieldType integration_element = geometry.integrationElement(xx);
-    for (size_t ii = 0; ii < backend_->size(); ++ii) {
+    assert(ret.size() >= backend_.size());
+    backend_.evaluateJacobian(xx, storage_->tmp_jacobian_ranges);
+    if (!affine_)
+      update_geometry(xx, true);
+    for (size_t ii = 0; ii < backend_.size(); ++ii) {
       for (size_t jj = 0; jj < dimDomain; ++jj) {
-        tmp_jacobian_inverse_transposed_.mv(tmp_jacobian_ranges_[ii][jj], ret[ii][jj]);
-        tmp_jacobian_transposed_.mv(ret[ii][jj], tmp_jacobian_ranges_[ii][jj]);
-        tmp_jacobian_ranges_[ii][jj] /= integration_element;
-        ret[ii][jj] = tmp_jacobian_ranges_[ii][jj];
+        tmp_jacobian_inverse_transposed_.mv(storage_->tmp_jacobian_ranges[ii][jj], ret[ii][jj]);
+        tmp_jacobian_transposed_.mv(ret[ii][jj], storage_->tmp_jacobian_ranges[ii][jj]);
+        storage_->tmp_jacobian_ranges[ii][jj] /= tmp_integration_element_;
+        ret[ii][jj] = storage_->tmp_jacobian_ranges[ii][jj];
       }
     }
   } // ... jacobian(...)
 
   using BaseType::jacobian;
 
+  void evaluate_all(const QuadratureType& quadrature, std::vector< RangeType >& ret) const
+  {
+    const size_t sz = backend_.size();
+    ret.resize(quadrature.size() * sz);
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      const auto xx = quadrature_point.position();
+      backend_.evaluateFunction(xx, storage_->tmp_ranges);
+      if (!affine_)
+        update_geometry(xx, false);
+      for (size_t ii = 0; ii < sz; ++ii) {
+        auto& value = ret[qq * sz + ii];
+        tmp_jacobian_transposed_.mtv(storage_->tmp_ranges[ii], value);
+        value /= tmp_integration_element_;
+      }
+      ++qq;
+    }
+  } // ... evaluate_all(...)
+
+  void jacobian_all(const QuadratureType& quadrature, std::vector< JacobianRangeType >& ret) const
+  {
+    const size_t sz = backend_.size();
+    ret.resize(quadrature.size() * sz);
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      const auto xx = quadrature_point.position();
+      backend_.evaluateJacobian(xx, storage_->tmp_jacobian_ranges);
+      if (!affine_)
+        update_geometry(xx, true);
+      for (size_t ii = 0; ii < sz; ++ii) {
+        auto& jacobian = ret[qq * sz + ii];
+        for (size_t jj = 0; jj < dimDomain; ++jj) {
+          tmp_jacobian_inverse_transposed_.mv(storage_->tmp_jacobian_ranges[ii][jj], jacobian[jj]);
+          tmp_jacobian_transposed_.mv(jacobian[jj], storage_->tmp_jacobian_ranges[ii][jj]);
+          storage_->tmp_jacobian_ranges[ii][jj] /= tmp_integration_element_;
+          jacobian[jj] = storage_->tmp_jacobian_ranges[ii][jj];
+        }
+      }
+      ++qq;
+    }
+  } // ... jacobian_all(...)
+
 private:
+  typedef typename PoolType::StoragePtrType StoragePtrType;
+
+  PiolaTransformedPdelabWrapper(StoragePtrType&& storage, const EntityType& ent)
+    : BaseType(ent)
+    , storage_(std::move(storage))
+    , backend_(FESwitchType::basis(bound_lfs(*storage_, ent).finiteElement()))
+    , tmp_domain_(DomainFieldType(0))
+    , affine_(false)
+    , tmp_integration_element_(0)
+    , tmp_jacobian_transposed_(DomainFieldType(0))
+    , tmp_jacobian_inverse_transposed_(DomainFieldType(0))
+  {
+    if (storage_->tmp_ranges.size() < backend_.size())
+      storage_->tmp_ranges.resize(backend_.size(), RangeType(0));
+    if (storage_->tmp_jacobian_ranges.size() < backend_.size())
+      storage_->tmp_jacobian_ranges.resize(backend_.size(), JacobianRangeType(0));
+    // the geometric quantities are constant on affine geometries
+    affine_ = this->entity().geometry().affine();
+    if (affine_)
+      update_geometry(tmp_domain_, true);
+  } // PiolaTransformedPdelabWrapper(...)
+
+  static const PdelabLFSType& bound_lfs(typename PoolType::StorageType& storage, const EntityType& ent)
+  {
+    storage.lfs.bind(ent);
+    return storage.lfs;
+  }
+
+  /**
+   * \brief Computes the jacobian transposed, the integration element and (if required) the jacobian inverse transposed
+   *        at xx, which is only done once (in the ctor) for affine geometries.
+   */
+  void update_geometry(const DomainType& xx, const bool jacobian_inverse_transposed_required) const
+  {
+    const auto geometry = this->entity().geometry();
+    tmp_jacobian_transposed_ = geometry.jacobianTransposed(xx);
+    if (jacobian_inverse_transposed_required)
+      tmp_jacobian_inverse_transposed_ = geometry.jacobianInverseTransposed(xx);
+    tmp_integration_element_ = geometry.integrationElement(xx);
+  } // ... update_geometry(...)
+
+  StoragePtrType storage_;
+  const BackendType backend_;
   mutable DomainType tmp_domain_;
+  bool affine_;
+  mutable DomainFieldType tmp_integration_element_;
   mutable typename EntityType::Geometry::JacobianTransposed tmp_jacobian_transposed_;
   mutable typename EntityType::Geometry::JacobianInverseTransposed tmp_jacobian_inverse_transposed_;
-  std::unique_ptr< const PdelabLFSType > lfs_;
-  std::unique_ptr< const BackendType > backend_;
-  mutable std::vector< RangeType > tmp_ranges_;
-  mutable std::vector< JacobianRangeType > tmp_jacobian_ranges_;
 }; // class PiolaTransformedPdelabWrapper
 
 
@@ -0,0 +1,308 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_BASEFUNCTIONSET_TABULATION_HH
+#define DUNE_GDT_BASEFUNCTIONSET_TABULATION_HH
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+
+#include <dune/stuff/common/parallel/threadstorage.hh>
+
+namespace Dune {
+namespace GDT {
+namespace BaseFunctionSet {
+
+
+/**
+ * \brief Marks base function sets which may be used with Tabulated.
+ *
+ *        Such a set has to be scalar, its values must not depend on the entity and its jacobians have to be given by
+ *        the jacobians on the reference element, transformed by the jacobian inverse transposed of the geometry. In
+ *        addition, it has to provide
+\code
+// the type of the basis on the reference element, which (together with the geometry type, the size and the order)
+// has to determine this basis
+std::type_index reference_type() const;
+// the jacobians on the reference element
+void reference_jacobian(const DomainType& xx, std::vector< JacobianRangeType >& ret) const;
+\endcode
+ */
+template< class BaseFunctionSetType >
+struct is_tabulatable
+  : public std::false_type
+{};
+
+
+namespace internal {
+
+
+/**
+ * \brief The values and jacobians of all functions of a reference basis at all points of a quadrature.
+ *
+ *        The values are stored as computed by BaseFunctionSetInterface::evaluate_all(), the jacobians are stored as a
+ *        structure of arrays, see gradients().
+ */
+template< class BaseFunctionSetType >
+class ReferenceTabulation
+{
+public:
+  typedef typename BaseFunctionSetType::DomainFieldType        DomainFieldType;
+  static const size_t                                          dimDomain = BaseFunctionSetType::dimDomain;
+  typedef typename BaseFunctionSetType::RangeFieldType         RangeFieldType;
+  typedef typename BaseFunctionSetType::RangeType              RangeType;
+  typedef typename BaseFunctionSetType::JacobianRangeType      JacobianRangeType;
+  typedef Dune::QuadratureRule< DomainFieldType, dimDomain >   QuadratureType;
+
+  ReferenceTabulation(const BaseFunctionSetType& base, const QuadratureType& quadrature)
+    : num_points_(quadrature.size())
+    , size_(base.size())
+    , gradients_(dimDomain * num_points_ * size_, RangeFieldType(0))
+  {
+    base.evaluate_all(quadrature, values_);
+    std::vector< JacobianRangeType > jacobians(size_, JacobianRangeType(0));
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      base.reference_jacobian(quadrature_point.position(), jacobians);
+      for (size_t kk = 0; kk < dimDomain; ++kk) {
+        RangeFieldType* gradients = &gradients_[(kk * num_points_ + qq) * size_];
+        for (size_t ii = 0; ii < size_; ++ii)
+          gradients[ii] = jacobians[ii][0][kk];
+      }
+      ++qq;
+    }
+  } // ReferenceTabulation(...)
+
+  size_t num_points() const
+  {
+    return num_points_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  /// \brief The values of all functions at the qq-th point, i.e. values(qq)[ii] for 0 <= ii < size().
+  const RangeType* values(const size_t qq) const
+  {
+    assert(qq < num_points_);
+    return &values_[qq * size_];
+  }
+
+  /**
+   * \brief The kk-th component of the reference gradients of all functions at all points, point by point, i.e.
+   *        gradients(kk)[qq * size() + ii] is the kk-th component of the gradient of the ii-th function at the qq-th
+   *        point.
+   */
+  const RangeFieldType* gradients(const size_t kk) const
+  {
+    assert(kk < dimDomain);
+    return &gradients_[kk * num_points_ * size_];
+  }
+
+private:
+  const size_t num_points_;
+  const size_t size_;
+  std::vector< RangeType > values_;
+  std::vector< RangeFieldType > gradients_;
+}; // class ReferenceTabulation
+
+
+} // namespace internal
+
+
+/**
+ * \brief Provides the values and jacobians of a base function set at all points of a quadrature, using tabulated
+ *        values on the reference element.
+ *
+ *        The values and reference jacobians are computed once for each (geometry type, quadrature order, reference
+ *        basis) and cached per thread, there is one such cache for each BaseFunctionSetImp. Binding to a base function
+ *        set thus only requires to transform the jacobians, which is done on demand: for each quadrature point or, on
+ *        affine geometries, for all quadrature points at once. The gradients are stored as a structure of arrays (each
+ *        component of the gradients of all basis functions is contiguous, see gradients()), so that kernels working on
+ *        all basis functions at once (like LocalEvaluation::Elliptic) boil down to contiguous loops the compiler can
+ *        vectorize. Since this object keeps its storage between binds, it should be reused, e.g.
+\code
+static DS::PerThreadValue< Tabulated< BaseFunctionSetType > > tabulated;
+tabulated->bind(base, quadrature);
+\endcode
+ * \sa is_tabulatable
+ */
+template< class BaseFunctionSetImp >
+class Tabulated
+{
+  static_assert(is_tabulatable< BaseFunctionSetImp >::value, "BaseFunctionSetImp has to be tabulatable!");
+  typedef internal::ReferenceTabulation< BaseFunctionSetImp > ReferenceTabulationType;
+public:
+  typedef BaseFunctionSetImp                                    BaseFunctionSetType;
+  typedef typename ReferenceTabulationType::DomainFieldType     DomainFieldType;
+  static const size_t                                           dimDomain = ReferenceTabulationType::dimDomain;
+  typedef typename ReferenceTabulationType::RangeFieldType      RangeFieldType;
+  typedef typename ReferenceTabulationType::RangeType           RangeType;
+  typedef typename ReferenceTabulationType::JacobianRangeType   JacobianRangeType;
+  typedef typename ReferenceTabulationType::QuadratureType      QuadratureType;
+private:
+  typedef Dune::FieldMatrix< DomainFieldType, dimDomain, dimDomain > JacobianInverseTransposedType;
+
+public:
+  Tabulated()
+    : base_(nullptr)
+    , quadrature_(nullptr)
+    , reference_(nullptr)
+    , affine_(false)
+    , jacobian_inverse_transposed_(DomainFieldType(0))
+  {}
+
+  /**
+   * \brief Binds to the given base function set and quadrature, both have to outlive this object (or the next bind).
+   */
+  void bind(const BaseFunctionSetType& base, const QuadratureType& quadrature)
+  {
+    base_ = &base;
+    quadrature_ = &quadrature;
+    reference_ = &lookup(base, quadrature);
+#ifndef NDEBUG
+    // the reference basis has to be determined by the key of the cache, \sa is_tabulatable
+    std::vector< RangeType > values(base.size(), RangeType(0));
+    base.evaluate(quadrature.begin()->position(), values);
+    for (size_t ii = 0; ii < base.size(); ++ii)
+      assert((values[ii] - reference_->values(0)[ii]).two_norm()
+             <= 1e-10 * std::max(typename BaseFunctionSetType::RangeFieldType(1), values[ii].two_norm()));
+#endif // NDEBUG
+    // the jacobian inverse transposed is constant on affine geometries
+    const auto geometry = base.entity().geometry();
+    affine_ = geometry.affine();
+    if (affine_)
+      update_jacobian_inverse_transposed(quadrature.begin()->position());
+    const size_t required_size = dimDomain * reference_->num_points() * reference_->size();
+    if (gradients_.size() < required_size)
+      gradients_.resize(required_size, RangeFieldType(0));
+    transformed_.assign(reference_->num_points(), false);
+  } // ... bind(...)
+
+  const BaseFunctionSetType& base() const
+  {
+    assert(base_);
+    return *base_;
+  }
+
+  size_t size() const
+  {
+    assert(base_);
+    return base_->size();
+  }
+
+  /// \brief The values of all basis functions at the qq-th point, i.e. values(qq)[ii] for 0 <= ii < size().
+  const RangeType* values(const size_t qq) const
+  {
+    assert(reference_);
+    return reference_->values(qq);
+  }
+
+  /**
+   * \brief The kk-th component of the gradients (w.r.t. the entity) of all basis functions at the qq-th point of the
+   *        quadrature, i.e. gradients(qq, kk)[ii] for 0 <= ii < size().
+   */
+  const RangeFieldType* gradients(const size_t qq, const size_t kk) const
+  {
+    assert(reference_);
+    assert(qq < transformed_.size());
+    assert(kk < dimDomain);
+    const size_t num_points = reference_->num_points();
+    if (!transformed_[qq]) {
+      if (affine_) {
+        // the jacobian inverse transposed is the same for all points, so we transform all of them at once
+        transform(0, num_points);
+        transformed_.assign(num_points, true);
+      } else {
+        update_jacobian_inverse_transposed((*quadrature_)[qq].position());
+        transform(qq, 1);
+        transformed_[qq] = true;
+      }
+    }
+    return &gradients_[(kk * num_points + qq) * size()];
+  } // ... gradients(...)
+
+private:
+  static const ReferenceTabulationType& lookup(const BaseFunctionSetType& base, const QuadratureType& quadrature)
+  {
+    // (geometry type id, dimension, quadrature order, number of points, type of the reference basis, size, order),
+    // which does not depend on the lifetime of any basis
+    typedef std::tuple< unsigned int, unsigned int, int, size_t, std::type_index, size_t, size_t > KeyType;
+    typedef std::map< KeyType, std::shared_ptr< const ReferenceTabulationType > > CacheType;
+    static DS::PerThreadValue< CacheType > caches;
+    auto& cache = *caches;
+    const KeyType key(quadrature.type().id(),
+                      quadrature.type().dim(),
+                      quadrature.order(),
+                      quadrature.size(),
+                      base.reference_type(),
+                      base.size(),
+                      base.order());
+    auto result = cache.find(key);
+    if (result == cache.end())
+      result = cache.emplace(key, std::make_shared< const ReferenceTabulationType >(base, quadrature)).first;
+    return *result->second;
+  } // ... lookup(...)
+
+  void update_jacobian_inverse_transposed(const Dune::FieldVector< DomainFieldType, dimDomain >& xx) const
+  {
+    // we copy into a FieldMatrix to be independent of the storage of the geometry
+    const auto jacobian_inverse_transposed = base_->entity().geometry().jacobianInverseTransposed(xx);
+    Dune::FieldVector< DomainFieldType, dimDomain > unit_vector(0);
+    Dune::FieldVector< DomainFieldType, dimDomain > column(0);
+    for (size_t mm = 0; mm < dimDomain; ++mm) {
+      unit_vector[mm] = 1;
+      jacobian_inverse_transposed.mv(unit_vector, column);
+      unit_vector[mm] = 0;
+      for (size_t kk = 0; kk < dimDomain; ++kk)
+        jacobian_inverse_transposed_[kk][mm] = column[kk];
+    }
+  } // ... update_jacobian_inverse_transposed(...)
+
+  /// \brief Transforms the reference gradients at the points first, ..., first + count - 1.
+  void transform(const size_t first, const size_t count) const
+  {
+    const size_t num_points = reference_->num_points();
+    const size_t length = count * size();
+    for (size_t kk = 0; kk < dimDomain; ++kk) {
+      RangeFieldType* ret = &gradients_[(kk * num_points + first) * size()];
+      for (size_t ii = 0; ii < length; ++ii)
+        ret[ii] = 0;
+      for (size_t mm = 0; mm < dimDomain; ++mm) {
+        const RangeFieldType factor = jacobian_inverse_transposed_[kk][mm];
+        const RangeFieldType* reference_gradients = reference_->gradients(mm) + first * size();
+        for (size_t ii = 0; ii < length; ++ii)
+          ret[ii] += factor * reference_gradients[ii];
+      }
+    }
+  } // ... transform(...)
+
+  const BaseFunctionSetType* base_;
+  const QuadratureType* quadrature_;
+  const ReferenceTabulationType* reference_;
+  bool affine_;
+  mutable JacobianInverseTransposedType jacobian_inverse_transposed_;
+  mutable std::vector< RangeFieldType > gradients_;
+  mutable std::vector< bool > transformed_;
+}; // class Tabulated
+
+
+} // namespace BaseFunctionSet
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_BASEFUNCTIONSET_TABULATION_HH
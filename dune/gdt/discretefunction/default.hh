@@ -56,7 +56,8 @@ public:
   typedef typename BaseType::EntityType        EntityType;
   typedef typename BaseType::LocalfunctionType LocalfunctionType;
 
-  typedef ConstLocalDiscreteFunction< SpaceType, VectorType > ConstLocalDiscreteFunctionType;
+  typedef ConstLocalDiscreteFunction< SpaceType, VectorType >           ConstLocalDiscreteFunctionType;
+  typedef RebindableConstLocalDiscreteFunction< SpaceType, VectorType > RebindableConstLocalDiscreteFunctionType;
 
   ConstDiscreteFunction(const SpaceType& sp, const VectorType& vec, const std::string nm = "gdt.constdiscretefunction")
     : space_(sp)
@@ -111,6 +112,15 @@ public:
     return local_discrete_function(entity);
   }
 
+  /**
+   * \brief A local function which is not bound to any entity yet, see RebindableConstLocalDiscreteFunction.
+   * \note  Prefer this one over local_discrete_function() when evaluating on many entities (e.g. one per thread).
+   */
+  RebindableConstLocalDiscreteFunctionType rebindable_local_discrete_function() const
+  {
+    return RebindableConstLocalDiscreteFunctionType(*space_, vector_);
+  }
+
   /**
    * \brief Visualizes the function using Dune::Stuff::LocalizableFunctionInterface::visualize on the grid view
    *        associated with the space.
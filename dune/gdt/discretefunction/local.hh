@@ -6,9 +6,13 @@
 #ifndef DUNE_GDT_DISCRETEFUNCTION_LOCAL_HH
 #define DUNE_GDT_DISCRETEFUNCTION_LOCAL_HH
 
+#include <memory>
+#include <new>
 #include <vector>
 #include <type_traits>
 
+#include <dune/common/dynvector.hh>
+
 #include <dune/stuff/common/memory.hh>
 #include <dune/stuff/functions/interfaces.hh>
 #include <dune/stuff/la/container/interfaces.hh>
@@ -198,12 +202,12 @@ public:
   {
     assert(this->is_a_valid_point(xx));
     ret *= 0.0;
-    std::vector<RangeType> tmpBaseValues(base_->size(), RangeType(0));
-    assert(localVector_->size() == tmpBaseValues.size());
-    base_->evaluate(xx, tmpBaseValues);
-    for (size_t ii = 0; ii < localVector_->size(); ++ii) {
-      tmpBaseValues[ii] *= localVector_->get(ii);
-      ret += tmpBaseValues[ii];
+    const size_t size = localVector_->size();
+    tmpBaseValues_.resize(size);
+    base_->evaluate(xx, tmpBaseValues_);
+    for (size_t ii = 0; ii < size; ++ii) {
+      tmpBaseValues_[ii] *= localVector_->get(ii);
+      ret += tmpBaseValues_[ii];
     }
   } // ... evaluate(...)
 
@@ -211,15 +215,37 @@ public:
   {
     assert(this->is_a_valid_point(xx));
     ret *= RangeFieldType(0);
-    std::vector<JacobianRangeType> tmpBaseJacobianValues(base_->size(), JacobianRangeType(0));
-    assert(localVector_->size() == tmpBaseJacobianValues.size());
-    base_->jacobian(xx, tmpBaseJacobianValues);
-    for (size_t ii = 0; ii < localVector_->size(); ++ii) {
-      tmpBaseJacobianValues[ii] *= localVector_->get(ii);
-      ret += tmpBaseJacobianValues[ii];
+    const size_t size = localVector_->size();
+    tmpBaseJacobianValues_.resize(size);
+    base_->jacobian(xx, tmpBaseJacobianValues_);
+    for (size_t ii = 0; ii < size; ++ii) {
+      tmpBaseJacobianValues_[ii] *= localVector_->get(ii);
+      ret += tmpBaseJacobianValues_[ii];
     }
   } // ... jacobian(...)
 
+  /**
+   * \brief Evaluates the function at all given points, ret is resized if required.
+   */
+  void evaluate(const std::vector< DomainType >& xx, std::vector< RangeType >& ret) const
+  {
+    if (ret.size() < xx.size())
+      ret.resize(xx.size());
+    for (size_t qq = 0; qq < xx.size(); ++qq)
+      evaluate(xx[qq], ret[qq]);
+  }
+
+  /**
+   * \brief Evaluates the jacobian of the function at all given points, ret is resized if required.
+   */
+  void jacobian(const std::vector< DomainType >& xx, std::vector< JacobianRangeType >& ret) const
+  {
+    if (ret.size() < xx.size())
+      ret.resize(xx.size());
+    for (size_t qq = 0; qq < xx.size(); ++qq)
+      jacobian(xx[qq], ret[qq]);
+  }
+
   using BaseType::evaluate;
   using BaseType::jacobian;
 
@@ -227,6 +253,10 @@ protected:
   const SpaceType& space_;
   std::unique_ptr< const BaseFunctionSetType > base_;
   std::unique_ptr< const ConstLocalDoFVectorType > localVector_;
+private:
+  // scratch space for the base function values, to avoid allocations in each call of evaluate() and jacobian()
+  mutable std::vector< RangeType > tmpBaseValues_;
+  mutable std::vector< JacobianRangeType > tmpBaseJacobianValues_;
 }; // class ConstLocalDiscreteFunction
 
 
@@ -286,6 +316,190 @@ private:
 }; // class LocalDiscreteFunction
 
 
+/**
+ * \brief A local discrete function which can be bound to one entity after another.
+ *
+ *        In contrast to ConstLocalDiscreteFunction, which is created for a single entity, this one is meant to be
+ *        created once (e.g. per thread) and rebound to each entity, reusing the global indices, the local DoFs and the
+ *        scratch space for the base function values. The base function set is constructed in place on bind(), so
+ *        that binding does not allocate (apart from what the base function set of the space allocates itself).
+ *        The local DoFs are copied from the global vector on bind().
+ * \note  This is not a Stuff::LocalfunctionInterface, since those are bound to their entity for their whole lifetime.
+ */
+template< class SpaceImp, class VectorImp >
+class RebindableConstLocalDiscreteFunction
+{
+  static_assert(is_space< SpaceImp >::value, "SpaceImp has to be derived from SpaceInterface!");
+  static_assert(Stuff::LA::is_vector< VectorImp >::value,
+                "VectorImp has to be derived from Stuff::LA::VectorInterface!");
+  static_assert(std::is_same< typename SpaceImp::RangeFieldType, typename VectorImp::ScalarType >::value,
+                "Types do not match!");
+  typedef typename SpaceImp::BaseFunctionSetType BaseFunctionSetType;
+  typedef RebindableConstLocalDiscreteFunction< SpaceImp, VectorImp > ThisType;
+public:
+  typedef SpaceImp                                SpaceType;
+  typedef VectorImp                               VectorType;
+  typedef typename SpaceType::EntityType          EntityType;
+  typedef typename SpaceType::RangeFieldType      RangeFieldType;
+  typedef typename BaseFunctionSetType::DomainType        DomainType;
+  typedef typename BaseFunctionSetType::RangeType         RangeType;
+  typedef typename BaseFunctionSetType::JacobianRangeType JacobianRangeType;
+
+  RebindableConstLocalDiscreteFunction(const SpaceType& space, const VectorType& globalVector)
+    : space_(space)
+    , globalVector_(globalVector)
+    , entity_(nullptr)
+    , size_(0)
+    , indices_(space_.mapper().maxNumDofs(), 0)
+    , localDoFs_(space_.mapper().maxNumDofs(), RangeFieldType(0))
+    , tmpBaseValues_(space_.mapper().maxNumDofs(), RangeType(0))
+    , tmpBaseJacobianValues_(space_.mapper().maxNumDofs(), JacobianRangeType(0))
+  {}
+
+  RebindableConstLocalDiscreteFunction(const SpaceType& space, const VectorType& globalVector, const EntityType& ent)
+    : RebindableConstLocalDiscreteFunction(space, globalVector)
+  {
+    bind(ent);
+  }
+
+  /// \brief Binds the new function to the entity source is bound to (if any).
+  RebindableConstLocalDiscreteFunction(ThisType&& source)
+    : RebindableConstLocalDiscreteFunction(source.space_, source.globalVector_)
+  {
+    if (source.entity_)
+      bind(*source.entity_);
+  }
+
+  RebindableConstLocalDiscreteFunction(const ThisType& other) = delete;
+
+  ThisType& operator=(const ThisType& other) = delete;
+
+  ~RebindableConstLocalDiscreteFunction()
+  {
+    unbind();
+  }
+
+  void bind(const EntityType& ent)
+  {
+    unbind();
+    new (&base_storage_) BaseFunctionSetType(space_.base_function_set(ent));
+    entity_ = &ent;
+    const auto& mapper = space_.mapper();
+    size_ = mapper.numDofs(ent);
+    assert(size_ == base().size());
+    assert(indices_.size() >= size_);
+    mapper.globalIndices(ent, indices_);
+    for (size_t ii = 0; ii < size_; ++ii)
+      localDoFs_[ii] = globalVector_.get_entry(indices_[ii]);
+  } // ... bind(...)
+
+  const EntityType& entity() const
+  {
+    assert(entity_);
+    return *entity_;
+  }
+
+  const BaseFunctionSetType& base() const
+  {
+    assert(entity_);
+    return *reinterpret_cast< const BaseFunctionSetType* >(&base_storage_);
+  }
+
+  size_t order() const
+  {
+    return base().order();
+  }
+
+  /// \brief The first size() entries are the DoFs of the function on the entity.
+  const Dune::DynamicVector< RangeFieldType >& local_dofs() const
+  {
+    return localDoFs_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  void evaluate(const DomainType& xx, RangeType& ret) const
+  {
+    ret *= 0.0;
+    base().evaluate(xx, tmpBaseValues_);
+    for (size_t ii = 0; ii < size_; ++ii) {
+      tmpBaseValues_[ii] *= localDoFs_[ii];
+      ret += tmpBaseValues_[ii];
+    }
+  } // ... evaluate(...)
+
+  RangeType evaluate(const DomainType& xx) const
+  {
+    RangeType ret(0);
+    evaluate(xx, ret);
+    return ret;
+  }
+
+  void jacobian(const DomainType& xx, JacobianRangeType& ret) const
+  {
+    ret *= RangeFieldType(0);
+    base().jacobian(xx, tmpBaseJacobianValues_);
+    for (size_t ii = 0; ii < size_; ++ii) {
+      tmpBaseJacobianValues_[ii] *= localDoFs_[ii];
+      ret += tmpBaseJacobianValues_[ii];
+    }
+  } // ... jacobian(...)
+
+  JacobianRangeType jacobian(const DomainType& xx) const
+  {
+    JacobianRangeType ret(0);
+    jacobian(xx, ret);
+    return ret;
+  }
+
+  /**
+   * \brief Evaluates the function at all given points, ret is resized if required.
+   */
+  void evaluate(const std::vector< DomainType >& xx, std::vector< RangeType >& ret) const
+  {
+    if (ret.size() < xx.size())
+      ret.resize(xx.size());
+    for (size_t qq = 0; qq < xx.size(); ++qq)
+      evaluate(xx[qq], ret[qq]);
+  }
+
+  /**
+   * \brief Evaluates the jacobian of the function at all given points, ret is resized if required.
+   */
+  void jacobian(const std::vector< DomainType >& xx, std::vector< JacobianRangeType >& ret) const
+  {
+    if (ret.size() < xx.size())
+      ret.resize(xx.size());
+    for (size_t qq = 0; qq < xx.size(); ++qq)
+      jacobian(xx[qq], ret[qq]);
+  }
+
+private:
+  void unbind()
+  {
+    if (entity_) {
+      reinterpret_cast< BaseFunctionSetType* >(&base_storage_)->~BaseFunctionSetType();
+      entity_ = nullptr;
+    }
+  }
+
+  const SpaceType& space_;
+  const VectorType& globalVector_;
+  // the base function set lives in base_storage_ iff entity_ is set
+  const EntityType* entity_;
+  typename std::aligned_storage< sizeof(BaseFunctionSetType), std::alignment_of< BaseFunctionSetType >::value >::type
+      base_storage_;
+  size_t size_;
+  Dune::DynamicVector< size_t > indices_;
+  Dune::DynamicVector< RangeFieldType > localDoFs_;
+  mutable std::vector< RangeType > tmpBaseValues_;
+  mutable std::vector< JacobianRangeType > tmpBaseJacobianValues_;
+}; // class RebindableConstLocalDiscreteFunction
+
+
 } // namespace GDT
 } // namespace Dune
 
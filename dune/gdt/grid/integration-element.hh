@@ -0,0 +1,64 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_GRID_INTEGRATION_ELEMENT_HH
+#define DUNE_GDT_GRID_INTEGRATION_ELEMENT_HH
+
+#include <cassert>
+
+namespace Dune {
+namespace GDT {
+
+
+/**
+ * \brief The integration element of a geometry at local points, which is computed only once if the geometry is affine
+ *        (where it is constant), \sa make_integration_element().
+ */
+template< class GeometryImp >
+class AffineIntegrationElement
+{
+public:
+  typedef GeometryImp                            GeometryType;
+  typedef typename GeometryType::ctype           ctype;
+  typedef typename GeometryType::LocalCoordinate LocalCoordinateType;
+
+  /**
+   * \param point Any local point of geometry, the integration element of an affine geometry is evaluated there.
+   */
+  AffineIntegrationElement(const GeometryType& geometry, const LocalCoordinateType& point)
+    : geometry_(geometry)
+    , affine_(geometry_.affine())
+    , integration_element_(affine_ ? geometry_.integrationElement(point) : ctype(0))
+  {}
+
+  ctype operator()(const LocalCoordinateType& xx) const
+  {
+    return affine_ ? integration_element_ : geometry_.integrationElement(xx);
+  }
+
+private:
+  const GeometryType geometry_;
+  const bool affine_;
+  const ctype integration_element_;
+}; // class AffineIntegrationElement
+
+
+/**
+ * \brief Creates the integration element of geometry, which is evaluated at the first point of quadrature if geometry
+ *        is affine.
+ */
+template< class GeometryType, class QuadratureType >
+AffineIntegrationElement< GeometryType > make_integration_element(const GeometryType& geometry,
+                                                                 const QuadratureType& quadrature)
+{
+  assert(quadrature.size() > 0);
+  return AffineIntegrationElement< GeometryType >(geometry, quadrature.begin()->position());
+}
+
+
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_GRID_INTEGRATION_ELEMENT_HH
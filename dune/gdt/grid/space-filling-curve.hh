@@ -0,0 +1,205 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_GRID_SPACE_FILLING_CURVE_HH
+#define DUNE_GDT_GRID_SPACE_FILLING_CURVE_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/common/parallel/threadmanager.hh>
+#include <dune/stuff/common/ranges.hh>
+
+namespace Dune {
+namespace GDT {
+
+
+/**
+ * \brief The codim 0 entities of a grid view, ordered along a space filling curve through their centers (the Z-order
+ *        or Morton curve), stored as entity seeds.
+ *
+ *        Consecutive entities along the curve are close to each other, so walking the grid in this order (instead of
+ *        the order of the grid view) improves the locality of the accesses to the grid and to the global containers.
+ *        The entities are split into contiguous partitions of the curve, so this can also be used as the partitioning
+ *        of SystemAssembler::assemble(partitioning), where each partition is a compact part of the domain.
+ */
+template< class GridViewImp >
+class SpaceFillingCurveTraversal
+{
+public:
+  typedef GridViewImp                                        GridViewType;
+  typedef typename GridViewType::Grid                        GridType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename EntityType::EntitySeed                    EntitySeedType;
+private:
+  static const size_t dimDomain = GridViewType::dimension;
+  typedef typename GridViewType::ctype               DomainFieldType;
+  typedef FieldVector< DomainFieldType, dimDomain >  DomainType;
+  typedef typename std::vector< EntitySeedType >::const_iterator SeedIteratorType;
+
+public:
+  class EntityIterator
+    : public std::iterator< std::forward_iterator_tag, EntityType >
+  {
+  public:
+    EntityIterator(const GridType& grid, const SeedIteratorType seed_it)
+      : grid_(&grid)
+      , seed_it_(seed_it)
+    {}
+
+    EntityType operator*() const
+    {
+      return *grid_->entity(*seed_it_);
+    }
+
+    EntityIterator& operator++()
+    {
+      ++seed_it_;
+      return *this;
+    }
+
+    bool operator==(const EntityIterator& other) const
+    {
+      return seed_it_ == other.seed_it_;
+    }
+
+    bool operator!=(const EntityIterator& other) const
+    {
+      return seed_it_ != other.seed_it_;
+    }
+
+  private:
+    const GridType* grid_;
+    SeedIteratorType seed_it_;
+  }; // class EntityIterator
+
+  /// \brief A contiguous part of the curve, to be used in range based for loops.
+  class Partition
+  {
+  public:
+    Partition(const GridType& grid, const SeedIteratorType seeds_begin, const SeedIteratorType seeds_end)
+      : grid_(grid)
+      , seeds_begin_(seeds_begin)
+      , seeds_end_(seeds_end)
+    {}
+
+    EntityIterator begin() const
+    {
+      return EntityIterator(grid_, seeds_begin_);
+    }
+
+    EntityIterator end() const
+    {
+      return EntityIterator(grid_, seeds_end_);
+    }
+
+  private:
+    const GridType& grid_;
+    const SeedIteratorType seeds_begin_;
+    const SeedIteratorType seeds_end_;
+  }; // class Partition
+
+  /**
+   * \param num_partitions The number of partitions, defaults to four times the maximal number of threads.
+   */
+  explicit SpaceFillingCurveTraversal(const GridViewType& grid_view, const size_t num_partitions = 0)
+    : grid_(grid_view.grid())
+  {
+    static const size_t bits = std::min(size_t(21), size_t(64) / dimDomain);
+    std::vector< EntitySeedType > seeds;
+    std::vector< DomainType > centers;
+    seeds.reserve(grid_view.size(0));
+    centers.reserve(grid_view.size(0));
+    for (const auto& entity : DSC::entityRange(grid_view)) {
+      seeds.push_back(entity.seed());
+      centers.push_back(entity.geometry().center());
+    }
+    // bounding box of the centers
+    DomainType lower(std::numeric_limits< DomainFieldType >::max());
+    DomainType upper(std::numeric_limits< DomainFieldType >::lowest());
+    for (const auto& center : centers)
+      for (size_t kk = 0; kk < dimDomain; ++kk) {
+        lower[kk] = std::min(lower[kk], center[kk]);
+        upper[kk] = std::max(upper[kk], center[kk]);
+      }
+    // interleave the bits of the quantized coordinates
+    const DomainFieldType max_coordinate = DomainFieldType((std::uint64_t(1) << bits) - 1);
+    std::vector< std::uint64_t > keys(centers.size(), 0);
+    for (size_t ee = 0; ee < centers.size(); ++ee) {
+      for (size_t kk = 0; kk < dimDomain; ++kk) {
+        const DomainFieldType extent = upper[kk] - lower[kk];
+        const std::uint64_t coordinate = extent > 0
+                                         ? std::uint64_t(((centers[ee][kk] - lower[kk]) / extent) * max_coordinate)
+                                         : 0;
+        for (size_t bb = 0; bb < bits; ++bb)
+          keys[ee] |= ((coordinate >> bb) & std::uint64_t(1)) << (bb * dimDomain + kk);
+      }
+    }
+    std::vector< size_t > order(seeds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const size_t ii, const size_t jj) { return keys[ii] < keys[jj]; });
+    seeds_.reserve(seeds.size());
+    for (const auto& ee : order)
+      seeds_.push_back(seeds[ee]);
+    // partitions
+    const size_t requested = num_partitions > 0
+                             ? num_partitions
+                             : 4 * std::max(size_t(1), size_t(DS::threadManager().max_threads()));
+    const size_t partitions = std::max(size_t(1), std::min(requested, seeds_.size()));
+    partition_offsets_.resize(partitions + 1);
+    for (size_t pp = 0; pp <= partitions; ++pp)
+      partition_offsets_[pp] = (pp * seeds_.size()) / partitions;
+  } // SpaceFillingCurveTraversal(...)
+
+  size_t size() const
+  {
+    return seeds_.size();
+  }
+
+  /// \brief The seeds of all entities, in the order of the curve.
+  const std::vector< EntitySeedType >& seeds() const
+  {
+    return seeds_;
+  }
+
+  EntityIterator begin() const
+  {
+    return EntityIterator(grid_, seeds_.begin());
+  }
+
+  EntityIterator end() const
+  {
+    return EntityIterator(grid_, seeds_.end());
+  }
+
+  size_t partitions() const
+  {
+    return partition_offsets_.size() - 1;
+  }
+
+  Partition partition(const size_t pp) const
+  {
+    assert(pp < partitions());
+    return Partition(grid_, seeds_.begin() + partition_offsets_[pp], seeds_.begin() + partition_offsets_[pp + 1]);
+  }
+
+private:
+  const GridType& grid_;
+  std::vector< EntitySeedType > seeds_;
+  std::vector< size_t > partition_offsets_;
+}; // class SpaceFillingCurveTraversal
+
+
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_GRID_SPACE_FILLING_CURVE_HH
@@ -0,0 +1,388 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_LA_ISTL_BLOCK_HH
+#define DUNE_GDT_LA_ISTL_BLOCK_HH
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/typetraits.hh>
+
+#if HAVE_DUNE_ISTL
+# include <dune/istl/bcrsmatrix.hh>
+# include <dune/istl/bvector.hh>
+#endif
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/la/container/interfaces.hh>
+#include <dune/stuff/la/container/pattern.hh>
+
+#include <dune/gdt/spaces/interface.hh>
+
+namespace Dune {
+namespace GDT {
+namespace LA {
+
+
+/**
+ * \brief Collapses a sparsity pattern of scalar entries into the pattern of its blockSize x blockSize blocks, i.e.
+ *        block (ii / blockSize, jj / blockSize) is contained if entry (ii, jj) is.
+ */
+inline Stuff::LA::SparsityPatternDefault block_pattern(const Stuff::LA::SparsityPatternDefault& pattern,
+                                                       const size_t block_size)
+{
+  assert(block_size > 0);
+  const size_t num_blocks = (pattern.size() + block_size - 1) / block_size;
+  Stuff::LA::SparsityPatternDefault ret(num_blocks);
+  for (size_t ii = 0; ii < pattern.size(); ++ii) {
+    auto& block_row = ret.inner(ii / block_size);
+    for (const auto& jj : pattern.inner(ii))
+      block_row.push_back(jj / block_size);
+  }
+  for (size_t bb = 0; bb < num_blocks; ++bb) {
+    auto& block_row = ret.inner(bb);
+    std::sort(block_row.begin(), block_row.end());
+    block_row.erase(std::unique(block_row.begin(), block_row.end()), block_row.end());
+  }
+  return ret;
+} // ... block_pattern(...)
+
+
+#if HAVE_DUNE_ISTL
+
+
+// forward, to be used in the traits
+template< class ScalarImp, size_t blockSize >
+class IstlBlockMatrix;
+
+
+namespace internal {
+
+
+template< class ScalarImp, size_t blockSize >
+class IstlBlockMatrixTraits
+{
+  static_assert(blockSize > 0, "blockSize has to be positive!");
+public:
+  typedef IstlBlockMatrix< ScalarImp, blockSize >                                  derived_type;
+  typedef ScalarImp                                                                ScalarType;
+  typedef typename Dune::FieldTraits< ScalarImp >::real_type                       RealType;
+  typedef Dune::BCRSMatrix< Dune::FieldMatrix< ScalarType, blockSize, blockSize > > BackendType;
+}; // class IstlBlockMatrixTraits
+
+
+} // namespace internal
+
+
+/**
+ * \brief A sparse matrix of dense blockSize x blockSize blocks (block CSR), based on Dune::BCRSMatrix.
+ *
+ *        All indices are scalar indices, entry (ii, jj) is stored in block (ii / blockSize, jj / blockSize), so this
+ *        can be used as any other matrix in the SystemAssembler, e.g. as the MatrixType of a product or an operator
+ *        which creates its own matrix. If the DoFs of each entity come in contiguous blocks of blockSize (as for
+ *        Mapper::FiniteVolume with dimRange == blockSize), the pattern of the blocks has blockSize^2 times fewer
+ *        entries than the scalar one, and the backend can be used natively with dune-istl, \sa to_block_vector().
+ * \sa    make_block_matrix()
+ */
+template< class ScalarImp = double, size_t blockSize = 1 >
+class IstlBlockMatrix
+  : public Stuff::LA::MatrixInterface< internal::IstlBlockMatrixTraits< ScalarImp, blockSize >, ScalarImp >
+  , public Stuff::LA::ProvidesBackend< internal::IstlBlockMatrixTraits< ScalarImp, blockSize > >
+{
+  typedef IstlBlockMatrix< ScalarImp, blockSize > ThisType;
+public:
+  typedef internal::IstlBlockMatrixTraits< ScalarImp, blockSize > Traits;
+  typedef typename Traits::ScalarType                              ScalarType;
+  typedef typename Traits::RealType                                RealType;
+  typedef typename Traits::BackendType                             BackendType;
+  typedef typename BackendType::block_type                         BlockType;
+  static const size_t                                              block_size = blockSize;
+
+  /**
+   * \param rr       The number of (scalar) rows.
+   * \param cc       The number of (scalar) cols.
+   * \param pattern_ The (scalar) pattern, which is collapsed into the pattern of the blocks, \sa block_pattern().
+   */
+  IstlBlockMatrix(const size_t rr, const size_t cc, const Stuff::LA::SparsityPatternDefault& pattern_)
+    : rows_(rr)
+    , cols_(cc)
+    , backend_(num_blocks(rr), num_blocks(cc), BackendType::row_wise)
+  {
+    if (pattern_.size() != rows_)
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "The pattern has " << pattern_.size() << " rows, but " << rows_ << " are required!");
+    build(block_pattern(pattern_, blockSize));
+  } // IstlBlockMatrix(...)
+
+  /**
+   * \brief Creates the matrix from the pattern of its blocks, e.g. from SpaceInterface::compute_block_pattern().
+   * \param rr     The number of (scalar) rows.
+   * \param cc     The number of (scalar) cols.
+   * \param blocks The pattern of the blocks, with (rr + blockSize - 1) / blockSize rows.
+   */
+  static ThisType from_block_pattern(const size_t rr, const size_t cc, const Stuff::LA::SparsityPatternDefault& blocks)
+  {
+    if (blocks.size() != num_blocks(rr))
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "The pattern has " << blocks.size() << " rows of blocks, but " << num_blocks(rr) << " are required!");
+    return ThisType(rr, cc, blocks, BlockPattern());
+  } // ... from_block_pattern(...)
+
+  IstlBlockMatrix(const ThisType& other) = default;
+
+  ThisType& operator=(const ThisType& other) = default;
+
+  /// \name Required by ProvidesBackend.
+  /// \{
+
+  BackendType& backend()
+  {
+    return backend_;
+  }
+
+  const BackendType& backend() const
+  {
+    return backend_;
+  }
+
+  /// \}
+  /// \name Required by ContainerInterface.
+  /// \{
+
+  ThisType copy() const
+  {
+    return ThisType(*this);
+  }
+
+  void scal(const ScalarType& alpha)
+  {
+    backend_ *= alpha;
+  }
+
+  void axpy(const ScalarType& alpha, const ThisType& xx)
+  {
+    if (!has_equal_shape(xx))
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "The shape of xx (" << xx.rows() << "x" << xx.cols() << ") does not match the shape of this ("
+                 << rows() << "x" << cols() << ")!");
+    backend_.axpy(alpha, xx.backend_);
+  } // ... axpy(...)
+
+  bool has_equal_shape(const ThisType& other) const
+  {
+    return (rows() == other.rows()) && (cols() == other.cols());
+  }
+
+  /// \}
+  /// \name Required by MatrixInterface.
+  /// \{
+
+  size_t rows() const
+  {
+    return rows_;
+  }
+
+  size_t cols() const
+  {
+    return cols_;
+  }
+
+  /**
+   * \brief Computes yy = A * xx block by block, without converting the vectors.
+   */
+  template< class T1, class T2 >
+  void mv(const Stuff::LA::VectorInterface< T1, ScalarType >& xx,
+          Stuff::LA::VectorInterface< T2, ScalarType >& yy) const
+  {
+    assert(xx.size() == cols_);
+    assert(yy.size() == rows_);
+    for (auto row_it = backend_.begin(); row_it != backend_.end(); ++row_it) {
+      const size_t first_ii = row_it.index() * blockSize;
+      for (size_t kk = 0; kk < blockSize && first_ii + kk < rows_; ++kk) {
+        ScalarType value(0);
+        for (auto block_it = row_it->begin(); block_it != row_it->end(); ++block_it) {
+          const size_t first_jj = block_it.index() * blockSize;
+          const auto& block_row = (*block_it)[kk];
+          for (size_t ll = 0; ll < blockSize && first_jj + ll < cols_; ++ll)
+            value += block_row[ll] * xx.get_entry(first_jj + ll);
+        }
+        yy.set_entry(first_ii + kk, value);
+      }
+    }
+  } // ... mv(...)
+
+  void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
+  {
+    entry(ii, jj) += value;
+  }
+
+  void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
+  {
+    entry(ii, jj) = value;
+  }
+
+  ScalarType get_entry(const size_t ii, const size_t jj) const
+  {
+    assert(ii < rows_);
+    assert(jj < cols_);
+    const auto& block_row = backend_[ii / blockSize];
+    const auto block_it = block_row.find(jj / blockSize);
+    return block_it == block_row.end() ? ScalarType(0) : (*block_it)[ii % blockSize][jj % blockSize];
+  }
+
+  void clear_row(const size_t ii)
+  {
+    assert(ii < rows_);
+    for (auto& block : backend_[ii / blockSize])
+      block[ii % blockSize] = ScalarType(0);
+  }
+
+  void clear_col(const size_t jj)
+  {
+    assert(jj < cols_);
+    for (auto& block_row : backend_) {
+      const auto block_it = block_row.find(jj / blockSize);
+      if (block_it != block_row.end())
+        for (size_t kk = 0; kk < blockSize; ++kk)
+          (*block_it)[kk][jj % blockSize] = ScalarType(0);
+    }
+  } // ... clear_col(...)
+
+  void unit_row(const size_t ii)
+  {
+    clear_row(ii);
+    set_entry(ii, ii, ScalarType(1));
+  }
+
+  void unit_col(const size_t jj)
+  {
+    clear_col(jj);
+    set_entry(jj, jj, ScalarType(1));
+  }
+
+  bool valid() const
+  {
+    for (const auto& block_row : backend_)
+      for (const auto& block : block_row)
+        for (size_t kk = 0; kk < blockSize; ++kk)
+          for (size_t ll = 0; ll < blockSize; ++ll)
+            if (std::isnan(block[kk][ll]) || std::isinf(block[kk][ll]))
+              return false;
+    return true;
+  } // ... valid(...)
+
+  /// \}
+
+private:
+  struct BlockPattern {};
+
+  IstlBlockMatrix(const size_t rr, const size_t cc, const Stuff::LA::SparsityPatternDefault& blocks, BlockPattern)
+    : rows_(rr)
+    , cols_(cc)
+    , backend_(num_blocks(rr), num_blocks(cc), BackendType::row_wise)
+  {
+    build(blocks);
+  }
+
+  static size_t num_blocks(const size_t size)
+  {
+    return (size + blockSize - 1) / blockSize;
+  }
+
+  void build(const Stuff::LA::SparsityPatternDefault& blocks)
+  {
+    for (auto row_it = backend_.createbegin(); row_it != backend_.createend(); ++row_it) {
+      const auto& block_row = blocks.inner(row_it.index());
+      for (const auto& block_col : block_row) {
+        assert(block_col < num_blocks(cols_));
+        row_it.insert(block_col);
+      }
+    }
+    backend_ = ScalarType(0);
+  } // ... build(...)
+
+  ScalarType& entry(const size_t ii, const size_t jj)
+  {
+    assert(ii < rows_);
+    assert(jj < cols_);
+    auto& block_row = backend_[ii / blockSize];
+    const auto block_it = block_row.find(jj / blockSize);
+    if (block_it == block_row.end())
+      DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                 "Entry (" << ii << ", " << jj << ") is not contained in the pattern of the blocks!");
+    return (*block_it)[ii % blockSize][jj % blockSize];
+  } // ... entry(...)
+
+  size_t rows_;
+  size_t cols_;
+  BackendType backend_;
+}; // class IstlBlockMatrix
+
+
+/**
+ * \brief Creates a block matrix with the volume (and face, if faces) pattern of space, which is computed directly for
+ *        blocks of blockSize, \sa SpaceInterface::compute_block_pattern().
+ * \param faces Couple the DoFs of neighboring entities, as required for DG and FV spaces (but not for CG spaces).
+ */
+template< size_t blockSize, class S, size_t d, size_t r, size_t rC >
+IstlBlockMatrix< typename S::RangeFieldType, blockSize > make_block_matrix(const SpaceInterface< S, d, r, rC >& space,
+                                                                          const bool faces = true)
+{
+  const size_t size = space.mapper().size();
+  return IstlBlockMatrix< typename S::RangeFieldType, blockSize >::from_block_pattern(
+      size, size, space.compute_block_pattern(blockSize, faces));
+}
+
+
+/**
+ * \brief Copies vector into blocks of blockSize (the last one padded with zeros), to be used with the backend of an
+ *        IstlBlockMatrix, e.g. by the solvers of dune-istl.
+ */
+template< size_t blockSize, class T, class S >
+Dune::BlockVector< Dune::FieldVector< S, blockSize > >
+    to_block_vector(const Stuff::LA::VectorInterface< T, S >& vector)
+{
+  Dune::BlockVector< Dune::FieldVector< S, blockSize > > ret((vector.size() + blockSize - 1) / blockSize);
+  ret = S(0);
+  for (size_t ii = 0; ii < vector.size(); ++ii)
+    ret[ii / blockSize][ii % blockSize] = vector.get_entry(ii);
+  return ret;
+} // ... to_block_vector(...)
+
+
+/**
+ * \brief Copies the blocks back into vector, \sa to_block_vector().
+ */
+template< class S, int blockSize, class T >
+void from_block_vector(const Dune::BlockVector< Dune::FieldVector< S, blockSize > >& block_vector,
+                       Stuff::LA::VectorInterface< T, S >& vector)
+{
+  assert(block_vector.size() * blockSize >= vector.size());
+  for (size_t ii = 0; ii < vector.size(); ++ii)
+    vector.set_entry(ii, block_vector[ii / blockSize][ii % blockSize]);
+} // ... from_block_vector(...)
+
+
+#else // HAVE_DUNE_ISTL
+
+
+template< class ScalarImp = double, size_t blockSize = 1 >
+class IstlBlockMatrix
+{
+  static_assert(Dune::AlwaysFalse< ScalarImp >::value, "You are missing dune-istl!");
+};
+
+
+#endif // HAVE_DUNE_ISTL
+
+} // namespace LA
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_LA_ISTL_BLOCK_HH
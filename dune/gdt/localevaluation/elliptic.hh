@@ -9,6 +9,8 @@
 #define DUNE_GDT_EVALUATION_ELLIPTIC_HH
 
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -17,9 +19,12 @@
 
 #include <dune/stuff/common/fmatrix.hh>
 #include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/parallel/threadstorage.hh>
 #include <dune/stuff/functions/constant.hh>
 #include <dune/stuff/functions/interfaces.hh>
 
+#include <dune/gdt/basefunctionset/tabulation.hh>
+
 #include "interface.hh"
 
 namespace Dune {
@@ -200,6 +205,59 @@ public:
     evaluate(*local_diffusion_factor, *local_diffusion_tensor, test_base, ansatz_base, localPoint, ret);
   }
 
+  /// \}
+  /// \name Required by supports_tabulation
+  /// \{
+
+  template< class TT, class TA, class M >
+  void evaluate(const LocalfunctionTupleType& local_functions_tuple,
+                const BaseFunctionSet::Tabulated< TT >& test_base,
+                const BaseFunctionSet::Tabulated< TA >& ansatz_base,
+                const size_t qq,
+                const Dune::FieldVector< D, d >& localPoint,
+                M& ret) const
+  {
+    typedef typename BaseFunctionSet::Tabulated< TT >::RangeFieldType R;
+    typedef Stuff::Common::FieldMatrix< R, d, d > TensorType;
+    const auto local_diffusion_factor = std::get< 0 >(local_functions_tuple);
+    const auto local_diffusion_tensor = std::get< 1 >(local_functions_tuple);
+    // evaluate local functions
+    const auto       diffusion_factor_value = local_diffusion_factor->evaluate(localPoint);
+    const TensorType diffusion_tensor_value = local_diffusion_tensor->evaluate(localPoint);
+    const auto       diffusion_value        = diffusion_tensor_value * diffusion_factor_value;
+    // compute elliptic evaluation, using (diffusion_value * a) * t = a * (diffusion_value^T * t), on the already
+    // evaluated bases: since each component of the gradients of all basis functions is stored contiguously, we compute
+    // each row of the result by d contiguous axpys (which are vectorized by the compiler) instead of by dot products of
+    // FieldVectors
+    const size_t rows = internal::local_rows(ret, test_base.size());
+    const size_t cols = internal::local_cols(ret, ansatz_base.size());
+    const R* test_gradients[d];
+    const R* ansatz_gradients[d];
+    for (size_t kk = 0; kk < d; ++kk) {
+      test_gradients[kk]   = test_base.gradients(qq, kk);
+      ansatz_gradients[kk] = ansatz_base.gradients(qq, kk);
+    }
+    R transformed_test_gradient[d];
+    for (size_t ii = 0; ii < rows; ++ii) {
+      for (size_t kk = 0; kk < d; ++kk) {
+        transformed_test_gradient[kk] = 0;
+        for (size_t mm = 0; mm < d; ++mm)
+          transformed_test_gradient[kk] += diffusion_value[mm][kk] * test_gradients[mm][ii];
+      }
+      R* retRow = &(ret[ii][0]);
+      const R* ansatz_gradient = ansatz_gradients[0];
+      const R factor = transformed_test_gradient[0];
+      for (size_t jj = 0; jj < cols; ++jj)
+        retRow[jj] = factor * ansatz_gradient[jj];
+      for (size_t kk = 1; kk < d; ++kk) {
+        const R* ansatz_gradient_kk = ansatz_gradients[kk];
+        const R factor_kk = transformed_test_gradient[kk];
+        for (size_t jj = 0; jj < cols; ++jj)
+          retRow[jj] += factor_kk * ansatz_gradient_kk[jj];
+      }
+    }
+  } // ... evaluate(...)
+
   /// \}
   /// \name Actual implementations of order
   /// \{
@@ -233,12 +291,21 @@ public:
     const auto       diffusion_factor_value = local_diffusion_factor.evaluate(localPoint);
     const TensorType diffusion_tensor_value = local_diffusion_tensor.evaluate(localPoint);
     const auto       diffusion_value        = diffusion_tensor_value * diffusion_factor_value;
-    // evaluate bases
-    const auto testGradients   = test_base.jacobian(localPoint);
-    const auto ansatzGradients = ansatz_base.jacobian(localPoint);
-    // compute elliptic evaluation
+    // evaluate bases (into thread local storage, to avoid allocations at each quadrature point)
+    typedef typename Stuff::LocalfunctionSetInterface< E, D, d, R, r, 1 >::JacobianRangeType JacobianRangeType;
+    static DS::PerThreadValue< std::pair< std::vector< JacobianRangeType >,
+                                          std::vector< JacobianRangeType > > > tmp_gradients;
     const size_t rows = test_base.size();
     const size_t cols = ansatz_base.size();
+    auto& testGradients   = tmp_gradients->first;
+    auto& ansatzGradients = tmp_gradients->second;
+    if (testGradients.size() < rows)
+      testGradients.resize(rows);
+    if (ansatzGradients.size() < cols)
+      ansatzGradients.resize(cols);
+    test_base.jacobian(localPoint, testGradients);
+    ansatz_base.jacobian(localPoint, ansatzGradients);
+    // compute elliptic evaluation
     assert(ret.rows() >= rows);
     assert(ret.cols() >= cols);
     for (size_t ii = 0; ii < rows; ++ii) {
@@ -256,6 +323,37 @@ private:
 }; // class Elliptic
 
 
+template< class DiffusionFactorType, class DiffusionTensorType >
+struct supports_tabulation< Elliptic< DiffusionFactorType, DiffusionTensorType > >
+  : public std::true_type
+{};
+
+
+/**
+ * \brief Marks diffusion tensors which are known to be symmetric, false unless specialized by the user.
+ *
+ *        Only then is Elliptic with this tensor symmetric (\sa is_symmetric), since the upper triangle of a matrix
+ *        assembled with a non-symmetric tensor silently differs from the full one.
+ */
+template< class DiffusionTensorType >
+struct is_symmetric_tensor
+  : public std::false_type
+{};
+
+
+/// \brief Symmetric if only a scalar diffusion factor is given, or the diffusion tensor is marked symmetric.
+template< class DiffusionFactorType, class DiffusionTensorType >
+struct is_symmetric< Elliptic< DiffusionFactorType, DiffusionTensorType > >
+  : public std::integral_constant< bool, is_symmetric_tensor< DiffusionTensorType >::value >
+{};
+
+
+template< class DiffusionType >
+struct is_symmetric< Elliptic< DiffusionType, void > >
+  : public std::integral_constant< bool, (DiffusionType::dimRange == 1) || is_symmetric_tensor< DiffusionType >::value >
+{};
+
+
 } // namespace LocalEvaluation
 } // namespace GDT
 } // namespace Dune
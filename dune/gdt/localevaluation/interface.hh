@@ -7,9 +7,12 @@
 #define DUNE_GDT_EVALUATION_INTERFACE_HH
 
 #include <memory>
+#include <type_traits>
 
 #include <dune/common/dynmatrix.hh>
+#include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
+#include <dune/common/unused.hh>
 
 #include <dune/stuff/common/crtp.hh>
 #include <dune/stuff/common/type_utils.hh>
@@ -150,6 +153,79 @@ public:
 }; // class Codim0Interface< Traits, 2 >
 
 
+/**
+ *  \brief  Marks binary codim 0 evaluations which, in addition to the evaluate() required by
+ *          Codim0Interface< ..., 2 >, provide
+\code
+template< class TT, class TA, class M >
+void evaluate(const LocalfunctionTupleType& localFunctionsTuple,
+              const BaseFunctionSet::Tabulated< TT >& testBase,
+              const BaseFunctionSet::Tabulated< TA >& ansatzBase,
+              const size_t qq,
+              const Dune::FieldVector< D, d >& localPoint,
+              M& ret) const;
+\endcode
+ *          where localPoint is the qq-th point of the quadrature the bases are bound to and M is either a
+ *          Dune::DynamicMatrix< R > or a Dune::FieldMatrix< R, rows, cols > (\sa internal::local_rows). This is used by
+ *          LocalOperator::Codim0Integral if both bases are tabulatable, \sa BaseFunctionSet::Tabulated.
+ */
+template< class EvaluationType >
+struct supports_tabulation
+  : public std::false_type
+{};
+
+
+/**
+ *  \brief  Marks binary and quaternary evaluations which are symmetric in the test and ansatz bases, i.e. swapping the
+ *          test and ansatz bases transposes the result (for quaternary evaluations, entityNeighbor is then the
+ *          transpose of neighborEntity). This allows to only assemble the upper triangle, \sa MatrixStorage.
+ */
+template< class EvaluationType >
+struct is_symmetric
+  : public std::false_type
+{};
+
+
+namespace internal {
+
+
+/**
+ * \brief The number of rows of ret to be used, i.e. rows for a Dune::DynamicMatrix and the number of rows known at
+ *        compile time for a Dune::FieldMatrix, so that loops over the rows of the latter may be unrolled.
+ */
+template< class R >
+size_t local_rows(const Dune::DynamicMatrix< R >& ret, const size_t rows)
+{
+  assert(ret.rows() >= rows);
+  return rows;
+}
+
+template< class K, int ROWS, int COLS >
+size_t local_rows(const Dune::FieldMatrix< K, ROWS, COLS >& /*ret*/, const size_t DUNE_UNUSED(rows))
+{
+  assert(rows == ROWS);
+  return ROWS;
+}
+
+/// \brief The number of cols of ret to be used, \sa local_rows
+template< class R >
+size_t local_cols(const Dune::DynamicMatrix< R >& ret, const size_t cols)
+{
+  assert(ret.cols() >= cols);
+  return cols;
+}
+
+template< class K, int ROWS, int COLS >
+size_t local_cols(const Dune::FieldMatrix< K, ROWS, COLS >& /*ret*/, const size_t DUNE_UNUSED(cols))
+{
+  assert(cols == COLS);
+  return COLS;
+}
+
+
+} // namespace internal
+
+
 /**
  *  \brief  Interface for local evaluations that depend on an intersection.
  *  \tparam numArguments  The number of local bases.
@@ -13,6 +13,8 @@
 
 #include <dune/stuff/functions/interfaces.hh>
 
+#include <dune/gdt/basefunctionset/tabulation.hh>
+
 #include "interface.hh"
 
 namespace Dune {
@@ -141,6 +143,33 @@ public:
     evaluate(*std::get< 0 >(localFuncs), testBase, ansatzBase, localPoint, ret);
   }
 
+  /// \}
+  /// \name Required by supports_tabulation
+  /// \{
+
+  template< class TT, class TA, class M >
+  void evaluate(const LocalfunctionTupleType& localFuncs,
+                const BaseFunctionSet::Tabulated< TT >& testBase,
+                const BaseFunctionSet::Tabulated< TA >& ansatzBase,
+                const size_t qq,
+                const Dune::FieldVector< DomainFieldType, dimDomain >& localPoint,
+                M& ret) const
+  {
+    // evaluate local function
+    const auto functionValue = std::get< 0 >(localFuncs)->evaluate(localPoint);
+    // the bases are already evaluated
+    const size_t rows = internal::local_rows(ret, testBase.size());
+    const size_t cols = internal::local_cols(ret, ansatzBase.size());
+    const auto testValues = testBase.values(qq);
+    const auto ansatzValues = ansatzBase.values(qq);
+    // compute product
+    for (size_t ii = 0; ii < rows; ++ii) {
+      auto& retRow = ret[ii];
+      for (size_t jj = 0; jj < cols; ++jj)
+        retRow[jj] = functionValue * (testValues[ii] * ansatzValues[jj]);
+    }
+  } // ... evaluate(...)
+
   /// \}
   /// \name Required by LocalEvaluation::Codim1Interface< ..., 2 >
   /// \{
@@ -320,6 +349,19 @@ private:
   const LocalizableFunctionType& inducingFunction_;
 }; // class Product
 
+
+template< class LocalizableFunctionType >
+struct supports_tabulation< Product< LocalizableFunctionType > >
+  : public std::true_type
+{};
+
+
+template< class LocalizableFunctionType >
+struct is_symmetric< Product< LocalizableFunctionType > >
+  : public std::true_type
+{};
+
+
 } // namespace LocalEvaluation
 } // namespace GDT
 } // namespace Dune
@@ -790,6 +790,20 @@ private:
 
 
 } // namespace SWIPDG
+
+
+template< class LocalizableFunctionImp >
+struct is_symmetric< SWIPDG::Inner< LocalizableFunctionImp, void > >
+  : public std::true_type
+{};
+
+
+template< class LocalizableFunctionImp >
+struct is_symmetric< SWIPDG::BoundaryLHS< LocalizableFunctionImp, void > >
+  : public std::true_type
+{};
+
+
 } // namespace LocalEvaluation
 } // namespace GDT
 } // namespace Dune
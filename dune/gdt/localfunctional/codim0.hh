@@ -19,6 +19,7 @@
 
 #include <dune/stuff/functions/interfaces.hh>
 
+#include "../grid/integration-element.hh"
 #include "../localevaluation/interface.hh"
 #include "interface.hh"
 
@@ -107,12 +108,13 @@ public:
     assert(ret.size() >= size);
     assert(tmpLocalVectors.size() >= numTmpObjectsRequired_);
     auto& localVector = tmpLocalVectors[0];
+    const auto integration_element = make_integration_element(entity.geometry(), volumeQuadrature);
     // loop over all quadrature points
     const auto quadPointEndIt = volumeQuadrature.end();
     for (auto quadPointIt = volumeQuadrature.begin(); quadPointIt != quadPointEndIt; ++quadPointIt) {
       const Dune::FieldVector< D, d > x = quadPointIt->position();
       // integration factors
-      const auto integrationFactor = entity.geometry().integrationElement(x);
+      const auto integrationFactor = integration_element(x);
       const auto quadratureWeight = quadPointIt->weight();
       // evaluate the local operation
       evaluation_.evaluate(localFunctions, testBase, x, localVector);
@@ -19,6 +19,7 @@
 
 #include <dune/stuff/functions/interfaces.hh>
 
+#include "../grid/integration-element.hh"
 #include "../localevaluation/interface.hh"
 #include "interface.hh"
 
@@ -103,10 +104,11 @@ public:
     assert(ret.size() >= size);
     assert(tmpLocalVectors.size() >= numTmpObjectsRequired_);
     auto& localVector = tmpLocalVectors[0];
+    const auto integration_element = make_integration_element(intersection.geometry(), faceQuadrature);
     // loop over all quadrature points
     for (auto quadPoint = faceQuadrature.begin(); quadPoint != faceQuadrature.end(); ++quadPoint) {
       const Dune::FieldVector< D, d - 1 > localPoint = quadPoint->position();
-      const auto integrationFactor = intersection.geometry().integrationElement(localPoint);
+      const auto integrationFactor = integration_element(localPoint);
       const auto quadratureWeight = quadPoint->weight();
       // evaluate local
       evaluation_.evaluate(localFunctions, testBase, intersection, localPoint, localVector);
@@ -14,11 +14,16 @@
 #include <boost/numeric/conversion/cast.hpp>
 
 #include <dune/common/densematrix.hh>
+#include <dune/common/fmatrix.hh>
 
 #include <dune/geometry/quadraturerules.hh>
 
+#include <dune/stuff/common/parallel/threadstorage.hh>
 #include <dune/stuff/functions/interfaces.hh>
 
+#include "../basefunctionset/interface.hh"
+#include "../basefunctionset/tabulation.hh"
+#include "../grid/integration-element.hh"
 #include "../localevaluation/interface.hh"
 #include "interface.hh"
 
@@ -80,11 +85,131 @@ public:
     return numTmpObjectsRequired_;
   }
 
-  template< class E, class D, size_t d, class R, size_t rT, size_t rCT, size_t rA, size_t rCA >
+  /**
+   * \note ret may be a Dune::DynamicMatrix< R > or a Dune::FieldMatrix< R, rows, cols >, \sa supports_fixed_size.
+   */
+  template< class E, class D, size_t d, class R, size_t rT, size_t rCT, size_t rA, size_t rCA, class M >
   void apply(const Stuff::LocalfunctionSetInterface< E, D, d, R, rT, rCT >& testBase,
              const Stuff::LocalfunctionSetInterface< E, D, d, R, rA, rCA >& ansatzBase,
-             Dune::DynamicMatrix< R >& ret,
+             M& ret,
+             std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices) const
+  {
+    apply_generic(testBase, ansatzBase, ret, tmpLocalMatrices);
+  }
+
+  /**
+   * \brief Uses tabulated values of the bases on the reference element if both bases and the evaluation support this
+   *        (\sa BaseFunctionSet::Tabulated and LocalEvaluation::supports_tabulation), evaluates the bases at each
+   *        quadrature point otherwise.
+   * \note  ret may be a Dune::DynamicMatrix< R > or a Dune::FieldMatrix< R, rows, cols >, in the latter case the
+   *        tabulated evaluation works on statically sized matrices only.
+   */
+  template< class TT, class TA, class D, size_t d, class R, size_t rT, size_t rCT, size_t rA, size_t rCA, class M >
+  void apply(const BaseFunctionSetInterface< TT, D, d, R, rT, rCT >& testBase,
+             const BaseFunctionSetInterface< TA, D, d, R, rA, rCA >& ansatzBase,
+             M& ret,
              std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices) const
+  {
+    typedef typename TT::derived_type TestBaseType;
+    typedef typename TA::derived_type AnsatzBaseType;
+    static const bool tabulate = BaseFunctionSet::is_tabulatable< TestBaseType >::value
+                              && BaseFunctionSet::is_tabulatable< AnsatzBaseType >::value
+                              && LocalEvaluation::supports_tabulation< BinaryEvaluationType >::value;
+    apply(static_cast< const TestBaseType& >(testBase),
+          static_cast< const AnsatzBaseType& >(ansatzBase),
+          ret,
+          tmpLocalMatrices,
+          std::integral_constant< bool, tabulate >());
+  } // ... apply(...)
+
+private:
+  template< class TestBaseType, class AnsatzBaseType, class M, class R >
+  void apply(const TestBaseType& testBase,
+             const AnsatzBaseType& ansatzBase,
+             M& ret,
+             std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices,
+             std::false_type) const
+  {
+    apply_generic(testBase, ansatzBase, ret, tmpLocalMatrices);
+  }
+
+  template< class TestBaseType, class AnsatzBaseType, class R >
+  void apply(const TestBaseType& testBase,
+             const AnsatzBaseType& ansatzBase,
+             Dune::DynamicMatrix< R >& ret,
+             std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices,
+             std::true_type) const
+  {
+    assert(tmpLocalMatrices.size() >= numTmpObjectsRequired_);
+    apply_tabulated(testBase, ansatzBase, ret, tmpLocalMatrices[0]);
+  }
+
+  template< class TestBaseType, class AnsatzBaseType, class K, int rows, int cols >
+  void apply(const TestBaseType& testBase,
+             const AnsatzBaseType& ansatzBase,
+             Dune::FieldMatrix< K, rows, cols >& ret,
+             std::vector< Dune::DynamicMatrix< K > >& /*tmpLocalMatrices*/,
+             std::true_type) const
+  {
+    Dune::FieldMatrix< K, rows, cols > evaluationResult(0);
+    apply_tabulated(testBase, ansatzBase, ret, evaluationResult);
+  }
+
+  /**
+   * \brief The loops over the rows and cols are bounded by LocalEvaluation::internal::local_rows() and local_cols(),
+   *        i.e. by compile time constants for statically sized matrices.
+   */
+  template< class TestBaseType, class AnsatzBaseType, class M >
+  void apply_tabulated(const TestBaseType& testBase,
+                       const AnsatzBaseType& ansatzBase,
+                       M& ret,
+                       M& evaluationResult) const
+  {
+    typedef typename TestBaseType::RangeFieldType R;
+    typedef typename TestBaseType::DomainFieldType D;
+    // the tabulated bases keep their storage, so we keep one of each per thread
+    static DS::PerThreadValue< BaseFunctionSet::Tabulated< TestBaseType > >   test_tabulated;
+    static DS::PerThreadValue< BaseFunctionSet::Tabulated< AnsatzBaseType > > ansatz_tabulated;
+    const auto& entity = ansatzBase.entity();
+    const auto localFunctions = integrand_.localFunctions(entity);
+    // quadrature
+    const size_t integrand_order = integrand_.order(localFunctions, ansatzBase, testBase) + over_integrate_;
+    const auto& volumeQuadrature = QuadratureRules< D, TestBaseType::dimDomain >::rule(
+                                     entity.type(), boost::numeric_cast< int >(integrand_order));
+    // tabulate bases
+    test_tabulated->bind(testBase, volumeQuadrature);
+    ansatz_tabulated->bind(ansatzBase, volumeQuadrature);
+    // check matrix
+    const size_t rows = LocalEvaluation::internal::local_rows(ret, testBase.size());
+    const size_t cols = LocalEvaluation::internal::local_cols(ret, ansatzBase.size());
+    ret *= 0.0;
+    const auto integration_element = make_integration_element(entity.geometry(), volumeQuadrature);
+    // loop over all quadrature points
+    size_t qq = 0;
+    for (const auto& quadPoint : volumeQuadrature) {
+      const auto x = quadPoint.position();
+      // integration factors
+      const auto integrationFactor = integration_element(x);
+      const auto quadratureWeight = quadPoint.weight();
+      // evaluate the integrand
+      integrand_.evaluate(localFunctions, *ansatz_tabulated, *test_tabulated, qq, x, evaluationResult);
+      // compute integral (on raw rows, so the compiler may vectorize this)
+      const R factor = integrationFactor * quadratureWeight;
+      for (size_t ii = 0; ii < rows; ++ii) {
+        R* retRow = &(ret[ii][0]);
+        const R* evaluationResultRow = &(evaluationResult[ii][0]);
+        for (size_t jj = 0; jj < cols; ++jj)
+          retRow[jj] += evaluationResultRow[jj] * factor;
+      } // compute integral
+      ++qq;
+    } // loop over all quadrature points
+  } // ... apply_tabulated(...)
+
+  template< class E, class D, size_t d, class R, size_t rT, size_t rCT, size_t rA, size_t rCA, class M >
+  void apply_generic(const Stuff::LocalfunctionSetInterface< E, D, d, R, rT, rCT >& testBase,
+                     const Stuff::LocalfunctionSetInterface< E, D, d, R, rA, rCA >& ansatzBase,
+                     M& ret,
+                     std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices) const
   {
     const auto& entity = ansatzBase.entity();
     const auto localFunctions = integrand_.localFunctions(entity);
@@ -93,18 +218,17 @@ public:
     const auto& volumeQuadrature = QuadratureRules< D, d >::rule(entity.type(),
                                                                  boost::numeric_cast< int >(integrand_order));
     // check matrix and tmp storage
-    const size_t rows = testBase.size();
-    const size_t cols = ansatzBase.size();
+    const size_t rows = LocalEvaluation::internal::local_rows(ret, testBase.size());
+    const size_t cols = LocalEvaluation::internal::local_cols(ret, ansatzBase.size());
     ret *= 0.0;
-    assert(ret.rows() >= rows);
-    assert(ret.cols() >= cols);
     assert(tmpLocalMatrices.size() >= numTmpObjectsRequired_);
     auto& evaluationResult = tmpLocalMatrices[0];
+    const auto integration_element = make_integration_element(entity.geometry(), volumeQuadrature);
     // loop over all quadrature points
     for (const auto& quadPoint : volumeQuadrature) {
       const auto x = quadPoint.position();
       // integration factors
-      const auto integrationFactor = entity.geometry().integrationElement(x);
+      const auto integrationFactor = integration_element(x);
       const auto quadratureWeight = quadPoint.weight();
       // evaluate the integrand
       integrand_.evaluate(localFunctions, ansatzBase, testBase, x, evaluationResult);
@@ -116,14 +240,25 @@ public:
           retRow[jj] += evaluationResultRow[jj] * integrationFactor * quadratureWeight;
       } // compute integral
     } // loop over all quadrature points
-  } // ... apply(...)
+  } // ... apply_generic(...)
 
-private:
   const BinaryEvaluationType integrand_;
   const size_t over_integrate_;
 }; // class Codim0Integral
 
 
+template< class BinaryEvaluationType >
+struct supports_fixed_size< Codim0Integral< BinaryEvaluationType > >
+  : public std::true_type
+{};
+
+
+template< class BinaryEvaluationType >
+struct is_symmetric< Codim0Integral< BinaryEvaluationType > >
+  : public LocalEvaluation::is_symmetric< BinaryEvaluationType >
+{};
+
+
 } // namespace LocalOperator
 } // namespace GDT
 } // namespace Dune
@@ -19,6 +19,7 @@
 
 #include <dune/stuff/functions/interfaces.hh>
 
+#include "../grid/integration-element.hh"
 #include "../localevaluation/interface.hh"
 #include "interface.hh"
 
@@ -109,6 +110,50 @@ public:
              Dune::DynamicMatrix< R >& entityNeighborRet,
              Dune::DynamicMatrix< R >& neighborEntityRet,
              std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices) const
+  {
+    integrate(entityTestBase, entityAnsatzBase, neighborTestBase, neighborAnsatzBase,
+              intersection,
+              entityEntityRet, neighborNeighborRet, entityNeighborRet, &neighborEntityRet,
+              tmpLocalMatrices);
+  }
+
+  /**
+   * \brief Same as apply(), but does not compute the neighborEntity block, which is the transpose of the
+   *        entityNeighbor block if the evaluation is symmetric (\sa LocalEvaluation::is_symmetric) and test and ansatz
+   *        bases coincide.
+   */
+  template< class E, class N, class IntersectionType, class D, size_t d, class R, size_t rT, size_t rCT, size_t rA, size_t rCA >
+  void apply_symmetric(const Stuff::LocalfunctionSetInterface< E, D, d, R, rT, rCT >& entityTestBase,
+                       const Stuff::LocalfunctionSetInterface< E, D, d, R, rA, rCA >& entityAnsatzBase,
+                       const Stuff::LocalfunctionSetInterface< N, D, d, R, rT, rCT >& neighborTestBase,
+                       const Stuff::LocalfunctionSetInterface< N, D, d, R, rA, rCA >& neighborAnsatzBase,
+                       const IntersectionType& intersection,
+                       Dune::DynamicMatrix< R >& entityEntityRet,
+                       Dune::DynamicMatrix< R >& neighborNeighborRet,
+                       Dune::DynamicMatrix< R >& entityNeighborRet,
+                       std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices) const
+  {
+    static_assert(LocalEvaluation::is_symmetric< QuaternaryEvaluationType >::value,
+                  "Only available for symmetric evaluations!");
+    integrate(entityTestBase, entityAnsatzBase, neighborTestBase, neighborAnsatzBase,
+              intersection,
+              entityEntityRet, neighborNeighborRet, entityNeighborRet, nullptr,
+              tmpLocalMatrices);
+  }
+
+private:
+  /// \brief Computes all four blocks, but skips the neighborEntity block if neighborEntityRet is a nullptr.
+  template< class E, class N, class IntersectionType, class D, size_t d, class R, size_t rT, size_t rCT, size_t rA, size_t rCA >
+  void integrate(const Stuff::LocalfunctionSetInterface< E, D, d, R, rT, rCT >& entityTestBase,
+                 const Stuff::LocalfunctionSetInterface< E, D, d, R, rA, rCA >& entityAnsatzBase,
+                 const Stuff::LocalfunctionSetInterface< N, D, d, R, rT, rCT >& neighborTestBase,
+                 const Stuff::LocalfunctionSetInterface< N, D, d, R, rA, rCA >& neighborAnsatzBase,
+                 const IntersectionType& intersection,
+                 Dune::DynamicMatrix< R >& entityEntityRet,
+                 Dune::DynamicMatrix< R >& neighborNeighborRet,
+                 Dune::DynamicMatrix< R >& entityNeighborRet,
+                 Dune::DynamicMatrix< R >* neighborEntityRet,
+                 std::vector< Dune::DynamicMatrix< R > >& tmpLocalMatrices) const
   {
     // local inducing function
     const auto& entity = entityTestBase.entity();
@@ -125,7 +170,8 @@ public:
     entityEntityRet *= 0.0;
     neighborNeighborRet *= 0.0;
     entityNeighborRet *= 0.0;
-    neighborEntityRet *= 0.0;
+    if (neighborEntityRet)
+      *neighborEntityRet *= 0.0;
     const size_t rowsEn = entityTestBase.size();
     const size_t colsEn = entityAnsatzBase.size();
     const size_t rowsNe = neighborTestBase.size();
@@ -136,17 +182,18 @@ public:
     assert(neighborNeighborRet.cols() >= colsNe);
     assert(entityNeighborRet.rows() >= rowsEn);
     assert(entityNeighborRet.cols() >= colsNe);
-    assert(neighborEntityRet.rows() >= rowsEn);
-    assert(neighborEntityRet.cols() >= colsEn);
+    assert(!neighborEntityRet || neighborEntityRet->rows() >= rowsNe);
+    assert(!neighborEntityRet || neighborEntityRet->cols() >= colsEn);
     assert(tmpLocalMatrices.size() >= numTmpObjectsRequired_);
     auto& entityEntityVals = tmpLocalMatrices[0];
     auto& neighborNeighborVals = tmpLocalMatrices[1];
     auto& entityNeighborVals = tmpLocalMatrices[2];
     auto& neighborEntityVals = tmpLocalMatrices[3];
+    const auto integration_element = make_integration_element(intersection.geometry(), faceQuadrature);
     // loop over all quadrature points
     for (auto quadPoint = faceQuadrature.begin(); quadPoint != faceQuadrature.end(); ++quadPoint) {
       const Dune::FieldVector< D, d - 1 > localPoint = quadPoint->position();
-      const auto integrationFactor = intersection.geometry().integrationElement(localPoint);
+      const auto integrationFactor = integration_element(localPoint);
       const auto quadratureWeight = quadPoint->weight();
       // evaluate local
       evaluation_.evaluate(localFunctionsEn, localFunctionsNe,
@@ -185,21 +232,22 @@ public:
       for (size_t ii = 0; ii < rowsNe; ++ii) {
         auto& neighborNeighborRetRow = neighborNeighborRet[ii];
         const auto& neighborNeighborValsRow = neighborNeighborVals[ii];
-        auto& neighborEntityRetRow = neighborEntityRet[ii];
-        const auto& neighborEntityValsRow = neighborEntityVals[ii];
         // loop over all neighbor ansatz basis functions
         for (size_t jj = 0; jj < colsNe; ++jj) {
           neighborNeighborRetRow[jj] += neighborNeighborValsRow[jj] * integrationFactor * quadratureWeight;
         } // loop over all neighbor ansatz basis functions
+        if (!neighborEntityRet)
+          continue;
+        auto& neighborEntityRetRow = (*neighborEntityRet)[ii];
+        const auto& neighborEntityValsRow = neighborEntityVals[ii];
         // loop over all entity ansatz basis functions
         for (size_t jj = 0; jj < colsEn; ++jj) {
           neighborEntityRetRow[jj] += neighborEntityValsRow[jj] * integrationFactor * quadratureWeight;
         } // loop over all entity ansatz basis functions
       } // loop over all neighbor test basis functions
     } // loop over all quadrature points
-  } // void apply(...) const
+  } // void integrate(...) const
 
-private:
   const QuaternaryEvaluationType evaluation_;
   const size_t over_integrate_;
 }; // class Codim1CouplingIntegral
@@ -264,10 +312,11 @@ public:
     assert(ret.cols() >= cols);
     assert(tmpLocalMatrices.size() >= numTmpObjectsRequired_);
     Dune::DynamicMatrix< R >& localMatrix = tmpLocalMatrices[0];
+    const auto integration_element = make_integration_element(intersection.geometry(), faceQuadrature);
     // loop over all quadrature points
     for (auto quadPoint = faceQuadrature.begin(); quadPoint != faceQuadrature.end(); ++quadPoint) {
       const Dune::FieldVector< D, d - 1 > localPoint = quadPoint->position();
-      const R integrationFactor = intersection.geometry().integrationElement(localPoint);
+      const R integrationFactor = integration_element(localPoint);
       const R quadratureWeight = quadPoint->weight();
       // evaluate local
       evaluation_.evaluate(localFunctions, testBase, ansatzBase, intersection, localPoint, localMatrix);
@@ -292,6 +341,18 @@ private:
 }; // class Codim1BoundaryIntegral
 
 
+template< class QuaternaryEvaluationType >
+struct is_symmetric< Codim1CouplingIntegral< QuaternaryEvaluationType > >
+  : public LocalEvaluation::is_symmetric< QuaternaryEvaluationType >
+{};
+
+
+template< class BinaryEvaluationType >
+struct is_symmetric< Codim1BoundaryIntegral< BinaryEvaluationType > >
+  : public LocalEvaluation::is_symmetric< BinaryEvaluationType >
+{};
+
+
 } // namespace LocalOperator
 } // namespace GDT
 } // namespace Dune
@@ -6,6 +6,7 @@
 #ifndef DUNE_GDT_LOCALOPERATOR_INTERFACE_HH
 #define DUNE_GDT_LOCALOPERATOR_INTERFACE_HH
 
+#include <type_traits>
 #include <vector>
 
 #include <dune/common/dynmatrix.hh>
@@ -53,6 +54,30 @@ public:
 }; // class Codim0Interface
 
 
+/**
+ * \brief Marks local operators derived from Codim0Interface whose apply() also accepts a
+ *        Dune::FieldMatrix< R, rows, cols > as ret, which is used by LocalAssembler::Codim0Matrix if the number of DoFs
+ *        of the spaces is known at compile time (\sa fixed_num_dofs).
+ */
+template< class LocalOperatorType >
+struct supports_fixed_size
+  : public std::false_type
+{};
+
+
+/**
+ * \brief Marks local operators which are symmetric if test and ansatz space coincide, so that only the upper triangle
+ *        of the resulting matrix needs to be assembled, \sa MatrixStorage.
+ *
+ *        Codim 1 coupling operators marked as symmetric have to provide an apply_symmetric(), which does not compute
+ *        the neighborEntity block (\sa LocalOperator::Codim1CouplingIntegral).
+ */
+template< class LocalOperatorType >
+struct is_symmetric
+  : public std::false_type
+{};
+
+
 template< class Traits >
 class Codim1CouplingInterface
   : public Stuff::CRTPInterface< Codim1CouplingInterface< Traits >, Traits >
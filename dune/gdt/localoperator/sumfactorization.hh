@@ -0,0 +1,429 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_LOCALOPERATOR_SUMFACTORIZATION_HH
+#define DUNE_GDT_LOCALOPERATOR_SUMFACTORIZATION_HH
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/type.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/fmatrix.hh>
+#include <dune/stuff/common/parallel/threadstorage.hh>
+#include <dune/stuff/functions/interfaces.hh>
+
+#include "../grid/integration-element.hh"
+#include "../localevaluation/elliptic.hh"
+#include "../localevaluation/product.hh"
+#include "interface.hh"
+
+namespace Dune {
+namespace GDT {
+namespace LocalOperator {
+
+
+// forward, to be used in the traits
+template< class BinaryEvaluationImp >
+class Codim0SumFactorizedIntegral;
+
+
+namespace internal {
+
+
+template< class BinaryEvaluationImp >
+class Codim0SumFactorizedIntegralTraits
+{
+  static_assert(std::is_base_of< LocalEvaluation::Codim0Interface< typename BinaryEvaluationImp::Traits, 2 >,
+                                 BinaryEvaluationImp >::value,
+                "BinaryEvaluationImp has to be derived from LocalEvaluation::Codim0Interface< ..., 2 >!");
+public:
+  typedef Codim0SumFactorizedIntegral< BinaryEvaluationImp > derived_type;
+};
+
+
+/**
+ * \brief Computes the coefficients of an integrand w.r.t. the reference element at a quadrature point.
+ *
+ *        The integrand has to be of the form sum_{a, b = 0}^{d} ret[a][b] * t_a * a_b, where v_0 denotes the value of
+ *        a basis function and v_k its derivative in direction k - 1 on the reference element. The quadrature weight
+ *        and the integration element are contained in factor. Only those terms are considered for which values and/or
+ *        derivatives is true.
+ */
+template< class BinaryEvaluationType >
+struct SumFactorizationCoefficients
+{
+  static_assert(AlwaysFalse< BinaryEvaluationType >::value, "Not available for this evaluation!");
+};
+
+
+template< class DiffusionFactorType, class DiffusionTensorType >
+struct SumFactorizationCoefficients< LocalEvaluation::Elliptic< DiffusionFactorType, DiffusionTensorType > >
+{
+  static const bool values = false;
+  static const bool derivatives = true;
+
+  template< class LocalfunctionTupleType, class GeometryType, class DomainType, class D, class MatrixType >
+  static void evaluate(const LocalfunctionTupleType& local_functions_tuple,
+                       const GeometryType& geometry,
+                       const DomainType& xx,
+                       const D& factor,
+                       MatrixType& ret)
+  {
+    static const size_t d = DomainType::dimension;
+    typedef typename MatrixType::field_type R;
+    typedef Stuff::Common::FieldMatrix< R, d, d > TensorType;
+    const auto       diffusion_factor_value = std::get< 0 >(local_functions_tuple)->evaluate(xx);
+    const TensorType diffusion_tensor_value = std::get< 1 >(local_functions_tuple)->evaluate(xx);
+    const auto       diffusion_value        = diffusion_tensor_value * diffusion_factor_value;
+    // the gradient of a basis function is given by sum_k v_k * columns[k], where columns[k] is the k-th column of the
+    // jacobian inverse transposed, so ret[k + 1][l + 1] = factor * columns[k] * (diffusion_value * columns[l])
+    const auto jacobian_inverse_transposed = geometry.jacobianInverseTransposed(xx);
+    Dune::FieldMatrix< R, d, d > columns(0);
+    Dune::FieldVector< R, d > unit(0);
+    for (size_t kk = 0; kk < d; ++kk) {
+      unit[kk] = 1;
+      jacobian_inverse_transposed.mv(unit, columns[kk]);
+      unit[kk] = 0;
+    }
+    Dune::FieldVector< R, d > tmp(0);
+    ret *= 0.0;
+    for (size_t ll = 0; ll < d; ++ll) {
+      diffusion_value.mv(columns[ll], tmp);
+      for (size_t kk = 0; kk < d; ++kk)
+        ret[kk + 1][ll + 1] = factor * (columns[kk] * tmp);
+    }
+  } // ... evaluate(...)
+}; // struct SumFactorizationCoefficients< Elliptic< ... > >
+
+
+template< class LocalizableFunctionType >
+struct SumFactorizationCoefficients< LocalEvaluation::Product< LocalizableFunctionType > >
+{
+  static const bool values = true;
+  static const bool derivatives = false;
+
+  template< class LocalfunctionTupleType, class GeometryType, class DomainType, class D, class MatrixType >
+  static void evaluate(const LocalfunctionTupleType& local_functions_tuple,
+                       const GeometryType& /*geometry*/,
+                       const DomainType& xx,
+                       const D& factor,
+                       MatrixType& ret)
+  {
+    ret *= 0.0;
+    ret[0][0] = factor * std::get< 0 >(local_functions_tuple)->evaluate(xx)[0];
+  }
+}; // struct SumFactorizationCoefficients< Product< ... > >
+
+
+} // namespace internal
+
+
+/**
+ * \brief Computes the same integral as Codim0Integral, using sum factorization for tensor product bases.
+ *
+ *        This local operator is only available for scalar Q_k Lagrange bases on cubes (with equidistant nodes and the
+ *        basis functions ordered lexicographically, the first direction running fastest), as are given by
+ *        Spaces::CG::PdelabBased on cube grids. It uses a tensor product Gauss quadrature and contracts one direction
+ *        of the quadrature at a time, reducing the work per entity from O(k^{3d}) to O(k^{2d + 1}), which is the best
+ *        possible up to a factor of k, since the local matrix has (k + 1)^{2d} entries. Like Codim0Integral, it may be
+ *        used in a LocalAssembler::Codim0Matrix, e.g.
+\code
+typedef LocalOperator::Codim0SumFactorizedIntegral< LocalEvaluation::Elliptic< DiffusionType > > LocalOperatorType;
+const LocalOperatorType local_operator(diffusion);
+const LocalAssembler::Codim0Matrix< LocalOperatorType > local_assembler(local_operator);
+system_assembler.add(local_assembler, matrix);
+\endcode
+ *        Currently available for LocalEvaluation::Elliptic and LocalEvaluation::Product.
+ */
+template< class BinaryEvaluationType >
+class Codim0SumFactorizedIntegral
+  : public LocalOperator::Codim0Interface< internal::Codim0SumFactorizedIntegralTraits< BinaryEvaluationType > >
+{
+  static const size_t numTmpObjectsRequired_ = 0;
+  typedef internal::SumFactorizationCoefficients< BinaryEvaluationType > CoefficientsType;
+public:
+  typedef internal::Codim0SumFactorizedIntegralTraits< BinaryEvaluationType > Traits;
+
+  template< class... Args >
+  explicit Codim0SumFactorizedIntegral(Args&& ...args)
+    : integrand_(std::forward< Args >(args)...)
+    , over_integrate_(0)
+  {}
+
+  template< class... Args >
+  explicit Codim0SumFactorizedIntegral(const int over_integrate, Args&& ...args)
+    : integrand_(std::forward< Args >(args)...)
+    , over_integrate_(boost::numeric_cast< size_t >(over_integrate))
+  {}
+
+  template< class... Args >
+  explicit Codim0SumFactorizedIntegral(const size_t over_integrate, Args&& ...args)
+    : integrand_(std::forward< Args >(args)...)
+    , over_integrate_(over_integrate)
+  {}
+
+  size_t numTmpObjectsRequired() const
+  {
+    return numTmpObjectsRequired_;
+  }
+
+  template< class E, class D, size_t d, class R >
+  void apply(const Stuff::LocalfunctionSetInterface< E, D, d, R, 1, 1 >& testBase,
+             const Stuff::LocalfunctionSetInterface< E, D, d, R, 1, 1 >& ansatzBase,
+             Dune::DynamicMatrix< R >& ret,
+             std::vector< Dune::DynamicMatrix< R > >& /*tmpLocalMatrices*/) const
+  {
+    static DS::PerThreadValue< Storage< D, d, R > > storages;
+    auto& storage = *storages;
+    const auto& entity = ansatzBase.entity();
+    if (!entity.type().isCube())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Sum factorization is only available on cubes, not on " << entity.type() << "!");
+    const size_t order = testBase.order();
+    if (order < 1 || ansatzBase.order() != order)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The bases have to be of the same order (at least one)!\n"
+                 << "  testBase.order() = " << testBase.order() << "\n"
+                 << "  ansatzBase.order() = " << ansatzBase.order());
+    const size_t nn = order + 1;
+    const size_t size = power(nn, d);
+    if (testBase.size() != size || ansatzBase.size() != size)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The bases have to be Q_k bases, i.e. of size " << size << "!\n"
+                 << "  testBase.size() = " << testBase.size() << "\n"
+                 << "  ansatzBase.size() = " << ansatzBase.size());
+    assert(ret.rows() >= size);
+    assert(ret.cols() >= size);
+    const auto localFunctions = integrand_.localFunctions(entity);
+    // 1d quadrature and basis
+    const size_t integrand_order = integrand_.order(localFunctions, ansatzBase, testBase) + over_integrate_;
+    const auto& quadrature = QuadratureRules< D, 1 >::rule(GeometryType(GeometryType::cube, 1),
+                                                           boost::numeric_cast< int >(integrand_order));
+    const size_t num_points = quadrature.size();
+    storage.tabulate(order, quadrature);
+    check_basis(testBase, storage, size, nn, num_points);
+    check_basis(ansatzBase, storage, size, nn, num_points);
+    // coefficients at each point of the tensor product quadrature (the first direction running fastest)
+    const auto geometry = entity.geometry();
+    const AffineIntegrationElement< typename E::Geometry > integration_element(geometry, Dune::FieldVector< D, d >(0));
+    const size_t num_tensor_points = power(num_points, d);
+    storage.coefficients.resize(num_tensor_points);
+    Dune::FieldVector< D, d > xx(0);
+    for (size_t qq = 0; qq < num_tensor_points; ++qq) {
+      D weight = 1;
+      for (size_t mm = 0, rest = qq; mm < d; ++mm, rest /= num_points) {
+        const auto& quadrature_point = quadrature[rest % num_points];
+        xx[mm] = quadrature_point.position()[0];
+        weight *= quadrature_point.weight();
+      }
+      CoefficientsType::evaluate(localFunctions, geometry, xx, weight * integration_element(xx),
+                                 storage.coefficients[qq]);
+    }
+    // sum up all terms
+    ret *= 0.0;
+    for (size_t aa = 0; aa <= d; ++aa) {
+      if (!(aa == 0 ? CoefficientsType::values : CoefficientsType::derivatives))
+        continue;
+      for (size_t bb = 0; bb <= d; ++bb) {
+        if (!(bb == 0 ? CoefficientsType::values : CoefficientsType::derivatives))
+          continue;
+        add_term(aa, bb, storage, nn, num_points, ret);
+      }
+    }
+  } // ... apply(...)
+
+private:
+  /**
+   * \brief Thread local storage, such that no allocations occur once all sizes are known.
+   */
+  template< class D, size_t d, class R >
+  struct Storage
+  {
+    Storage()
+      : order(0)
+      , quadrature(nullptr)
+    {}
+
+    /**
+     * \brief Evaluates the 1d Lagrange basis of the given order (on equidistant nodes) at all points of the quadrature,
+     *        values[ii * num_points + qq] is the value of the ii-th basis function at the qq-th point.
+     */
+    void tabulate(const size_t ord, const Dune::QuadratureRule< D, 1 >& quad)
+    {
+      if (ord == order && &quad == quadrature)
+        return;
+      order = ord;
+      quadrature = &quad;
+      const size_t nn = order + 1;
+      const size_t num_points = quad.size();
+      values.resize(nn * num_points);
+      derivatives.resize(nn * num_points);
+      for (size_t qq = 0; qq < num_points; ++qq) {
+        const D xx = quad[qq].position()[0];
+        for (size_t ii = 0; ii < nn; ++ii) {
+          const D x_ii = D(ii) / D(order);
+          R value = 1;
+          R derivative = 0;
+          for (size_t jj = 0; jj < nn; ++jj) {
+            if (jj == ii)
+              continue;
+            const D x_jj = D(jj) / D(order);
+            // product rule: (value * f)' = derivative * f + value * f', where f = (xx - x_jj) / (x_ii - x_jj)
+            derivative = derivative * (xx - x_jj) / (x_ii - x_jj) + value / (x_ii - x_jj);
+            value *= (xx - x_jj) / (x_ii - x_jj);
+          }
+          values[ii * num_points + qq] = value;
+          derivatives[ii * num_points + qq] = derivative;
+        }
+      }
+    } // ... tabulate(...)
+
+    size_t order;
+    const Dune::QuadratureRule< D, 1 >* quadrature;
+    std::vector< R > values;
+    std::vector< R > derivatives;
+    std::vector< Dune::FieldMatrix< R, d + 1, d + 1 > > coefficients;
+    std::vector< R > current;
+    std::vector< R > next;
+    std::vector< Dune::FieldVector< R, 1 > > base_values;
+    std::set< std::pair< std::type_index, size_t > > checked_bases;
+  }; // struct Storage
+
+  static size_t power(const size_t base, const size_t exponent)
+  {
+    size_t ret = 1;
+    for (size_t ii = 0; ii < exponent; ++ii)
+      ret *= base;
+    return ret;
+  }
+
+  /**
+   * \brief Compares the values of the given base with the tensor products of the 1d basis, to make sure the bases are
+   *        what we expect.
+   *
+   *        Checks num_points points of the tensor product quadrature, the coordinates of which differ in each direction
+   *        (so a permutation of the directions is detected as well). This is only done once per type of base and order
+   *        (and thread), since the bases of one type are the same on all entities.
+   */
+  template< class E, class D, size_t d, class R, class StorageType >
+  static void check_basis(const Stuff::LocalfunctionSetInterface< E, D, d, R, 1, 1 >& base,
+                          StorageType& storage,
+                          const size_t size,
+                          const size_t nn,
+                          const size_t num_points)
+  {
+    if (!storage.checked_bases.insert(std::make_pair(std::type_index(typeid(base)), nn - 1)).second)
+      return;
+    storage.base_values.resize(size);
+    Dune::FieldVector< D, d > xx(0);
+    for (size_t pp = 0; pp < num_points; ++pp) {
+      // the quadrature point of index (pp + mm) % num_points in direction mm
+      for (size_t mm = 0; mm < d; ++mm)
+        xx[mm] = (*storage.quadrature)[(pp + mm) % num_points].position()[0];
+      base.evaluate(xx, storage.base_values);
+      for (size_t ii = 0; ii < size; ++ii) {
+        R expected = 1;
+        for (size_t mm = 0, rest = ii; mm < d; ++mm, rest /= nn)
+          expected *= storage.values[(rest % nn) * num_points + (pp + mm) % num_points];
+        if (std::abs(storage.base_values[ii][0] - expected) > 1e-10 * std::max(R(1), std::abs(expected))) {
+          storage.checked_bases.erase(std::make_pair(std::type_index(typeid(base)), nn - 1));
+          DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                     "The bases have to be lexicographically ordered Q_k Lagrange bases on equidistant nodes!");
+        }
+      }
+    }
+  } // ... check_basis(...)
+
+  /**
+   * \brief Adds the integral of storage.coefficients[.][aa][bb] * t_aa * a_bb for all test and ansatz basis functions
+   *        to ret.
+   *
+   *        We contract one direction of the quadrature at a time, starting with the last one. Before contracting
+   *        direction mm - 1, storage.current[(qq * outer + oo) * inner + pp] holds the intermediate result for the
+   *        quadrature index qq in direction mm - 1, the quadrature indices oo of the directions 0, ..., mm - 2 and the
+   *        pairs of 1d basis functions pp of the directions mm, ..., d - 1 (already contracted).
+   */
+  template< class D, size_t d, class R >
+  static void add_term(const size_t aa,
+                       const size_t bb,
+                       Storage< D, d, R >& storage,
+                       const size_t nn,
+                       const size_t num_points,
+                       Dune::DynamicMatrix< R >& ret)
+  {
+    const size_t num_tensor_points = storage.coefficients.size();
+    auto& current = storage.current;
+    auto& next = storage.next;
+    current.resize(num_tensor_points);
+    for (size_t qq = 0; qq < num_tensor_points; ++qq)
+      current[qq] = storage.coefficients[qq][aa][bb];
+    size_t inner = 1;
+    for (size_t mm = d; mm > 0; --mm) {
+      const size_t outer = power(num_points, mm - 1);
+      const auto& test_values = (aa == mm) ? storage.derivatives : storage.values;
+      const auto& ansatz_values = (bb == mm) ? storage.derivatives : storage.values;
+      next.assign(outer * nn * nn * inner, R(0));
+      for (size_t qq = 0; qq < num_points; ++qq) {
+        for (size_t oo = 0; oo < outer; ++oo) {
+          const R* in = &current[(qq * outer + oo) * inner];
+          for (size_t ii = 0; ii < nn; ++ii) {
+            const R test_value = test_values[ii * num_points + qq];
+            for (size_t jj = 0; jj < nn; ++jj) {
+              const R factor = test_value * ansatz_values[jj * num_points + qq];
+              R* out = &next[((oo * nn + ii) * nn + jj) * inner];
+              for (size_t pp = 0; pp < inner; ++pp)
+                out[pp] += factor * in[pp];
+            }
+          }
+        }
+      }
+      std::swap(current, next);
+      inner *= nn * nn;
+    }
+    // now current[pp] holds the result for the pairs of 1d basis functions pp, where the pair of direction 0 runs
+    // slowest
+    for (size_t pp = 0; pp < inner; ++pp) {
+      size_t row = 0;
+      size_t col = 0;
+      size_t rest = pp;
+      size_t stride = power(nn, d - 1);
+      for (size_t mm = 0; mm < d; ++mm, stride /= nn) {
+        const size_t pair = rest % (nn * nn);
+        rest /= nn * nn;
+        // the pair of direction d - 1 - mm
+        row += (pair / nn) * stride;
+        col += (pair % nn) * stride;
+      }
+      ret[row][col] += current[pp];
+    }
+  } // ... add_term(...)
+
+  const BinaryEvaluationType integrand_;
+  const size_t over_integrate_;
+}; // class Codim0SumFactorizedIntegral
+
+
+} // namespace LocalOperator
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_LOCALOPERATOR_SUMFACTORIZATION_HH
@@ -0,0 +1,308 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_MAPPER_RENUMBERED_HH
+#define DUNE_GDT_MAPPER_RENUMBERED_HH
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <dune/common/dynvector.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/gdt/grid/space-filling-curve.hh>
+
+#include "interface.hh"
+
+namespace Dune {
+namespace GDT {
+namespace Mapper {
+
+
+enum class Renumbering
+{
+    reverse_cuthill_mckee
+  , space_filling_curve
+}; // enum class Renumbering
+
+
+namespace internal {
+
+
+/**
+ * \brief The global indices of all entities of a grid view (in the order of the grid view) and the entities of each
+ *        global index, both stored as compressed rows.
+ */
+class EntityDofIncidence
+{
+public:
+  template< class GridViewType, class MapperType >
+  EntityDofIncidence(const GridViewType& grid_view, const MapperType& mapper)
+    : size_(mapper.size())
+    , entity_offsets_(1, 0)
+  {
+    Dune::DynamicVector< size_t > global_indices(mapper.maxNumDofs(), 0);
+    entity_offsets_.reserve(grid_view.indexSet().size(0) + 1);
+    for (const auto& entity : DSC::entityRange(grid_view)) {
+      const size_t num_dofs = mapper.numDofs(entity);
+      mapper.globalIndices(entity, global_indices);
+      entity_dofs_.insert(entity_dofs_.end(), global_indices.begin(), global_indices.begin() + num_dofs);
+      entity_offsets_.push_back(entity_dofs_.size());
+    }
+    // invert
+    dof_offsets_.assign(size_ + 1, 0);
+    for (const auto& global_index : entity_dofs_) {
+      assert(global_index < size_);
+      ++dof_offsets_[global_index + 1];
+    }
+    std::partial_sum(dof_offsets_.begin(), dof_offsets_.end(), dof_offsets_.begin());
+    dof_entities_.resize(entity_dofs_.size());
+    std::vector< size_t > positions(dof_offsets_.begin(), dof_offsets_.end() - 1);
+    for (size_t ee = 0; ee < num_entities(); ++ee)
+      for (size_t ii = entity_offsets_[ee]; ii < entity_offsets_[ee + 1]; ++ii)
+        dof_entities_[positions[entity_dofs_[ii]]++] = ee;
+  } // EntityDofIncidence(...)
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  size_t num_entities() const
+  {
+    return entity_offsets_.size() - 1;
+  }
+
+  const size_t* entity_dofs_begin(const size_t ee) const
+  {
+    return entity_dofs_.data() + entity_offsets_[ee];
+  }
+
+  const size_t* entity_dofs_end(const size_t ee) const
+  {
+    return entity_dofs_.data() + entity_offsets_[ee + 1];
+  }
+
+  const size_t* dof_entities_begin(const size_t dd) const
+  {
+    return dof_entities_.data() + dof_offsets_[dd];
+  }
+
+  const size_t* dof_entities_end(const size_t dd) const
+  {
+    return dof_entities_.data() + dof_offsets_[dd + 1];
+  }
+
+private:
+  const size_t size_;
+  std::vector< size_t > entity_offsets_;
+  std::vector< size_t > entity_dofs_;
+  std::vector< size_t > dof_offsets_;
+  std::vector< size_t > dof_entities_;
+}; // class EntityDofIncidence
+
+
+} // namespace internal
+
+
+/**
+ * \brief Computes a reverse Cuthill-McKee renumbering of the DoFs of mapper, where two DoFs are adjacent if they
+ *        belong to a common entity. ret[old_index] is the new index.
+ *
+ *        The degree of a DoF is approximated by the sum of the number of DoFs of its entities (which counts shared
+ *        neighbors multiple times) and each connected component is started at a DoF of minimal degree.
+ */
+template< class GridViewType, class MapperType >
+std::vector< size_t > reverse_cuthill_mckee_renumbering(const GridViewType& grid_view, const MapperType& mapper)
+{
+  const internal::EntityDofIncidence incidence(grid_view, mapper);
+  const size_t size = incidence.size();
+  std::vector< size_t > degrees(size, 0);
+  for (size_t dd = 0; dd < size; ++dd)
+    for (auto ee = incidence.dof_entities_begin(dd); ee != incidence.dof_entities_end(dd); ++ee)
+      degrees[dd] += incidence.entity_dofs_end(*ee) - incidence.entity_dofs_begin(*ee);
+  const auto by_degree = [&](const size_t ii, const size_t jj) { return degrees[ii] < degrees[jj]; };
+  std::vector< size_t > starts(size);
+  std::iota(starts.begin(), starts.end(), 0);
+  std::stable_sort(starts.begin(), starts.end(), by_degree);
+  // breadth first search
+  std::vector< size_t > order;
+  order.reserve(size);
+  std::vector< bool > visited(size, false);
+  std::vector< size_t > neighbors;
+  for (const auto& start : starts) {
+    if (visited[start])
+      continue;
+    visited[start] = true;
+    order.push_back(start);
+    for (size_t head = order.size() - 1; head < order.size(); ++head) {
+      const size_t current = order[head];
+      neighbors.clear();
+      for (auto ee = incidence.dof_entities_begin(current); ee != incidence.dof_entities_end(current); ++ee)
+        for (auto dof = incidence.entity_dofs_begin(*ee); dof != incidence.entity_dofs_end(*ee); ++dof)
+          if (!visited[*dof]) {
+            visited[*dof] = true;
+            neighbors.push_back(*dof);
+          }
+      std::stable_sort(neighbors.begin(), neighbors.end(), by_degree);
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+  // reverse
+  std::vector< size_t > new_indices(size);
+  for (size_t ii = 0; ii < size; ++ii)
+    new_indices[order[ii]] = size - 1 - ii;
+  return new_indices;
+} // ... reverse_cuthill_mckee_renumbering(...)
+
+
+/**
+ * \brief Computes a renumbering of the DoFs of mapper along a space filling curve through the entities, \sa
+ *        SpaceFillingCurveTraversal. ret[old_index] is the new index.
+ */
+template< class GridViewType, class MapperType >
+std::vector< size_t > space_filling_curve_renumbering(const GridViewType& grid_view, const MapperType& mapper)
+{
+  const size_t invalid = std::numeric_limits< size_t >::max();
+  std::vector< size_t > new_indices(mapper.size(), invalid);
+  Dune::DynamicVector< size_t > global_indices(mapper.maxNumDofs(), 0);
+  size_t next = 0;
+  for (const auto& entity : SpaceFillingCurveTraversal< GridViewType >(grid_view, 1)) {
+    const size_t num_dofs = mapper.numDofs(entity);
+    mapper.globalIndices(entity, global_indices);
+    for (size_t ii = 0; ii < num_dofs; ++ii)
+      if (new_indices[global_indices[ii]] == invalid)
+        new_indices[global_indices[ii]] = next++;
+  }
+  // DoFs which do not belong to any entity go last
+  for (auto& new_index : new_indices)
+    if (new_index == invalid)
+      new_index = next++;
+  return new_indices;
+} // ... space_filling_curve_renumbering(...)
+
+
+template< class GridViewType, class MapperType >
+std::vector< size_t > compute_renumbering(const Renumbering renumbering,
+                                          const GridViewType& grid_view,
+                                          const MapperType& mapper)
+{
+  switch (renumbering) {
+    case Renumbering::reverse_cuthill_mckee:
+      return reverse_cuthill_mckee_renumbering(grid_view, mapper);
+    case Renumbering::space_filling_curve:
+      return space_filling_curve_renumbering(grid_view, mapper);
+  }
+  DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Unknown renumbering!");
+  return std::vector< size_t >();
+} // ... compute_renumbering(...)
+
+
+// forward, to be used in the traits
+template< class MapperImp >
+class Renumbered;
+
+
+namespace internal {
+
+
+template< class MapperImp >
+class RenumberedTraits
+{
+public:
+  typedef Renumbered< MapperImp >         derived_type;
+  typedef MapperImp                       BackendType;
+  typedef typename MapperImp::EntityType  EntityType;
+};
+
+
+} // namespace internal
+
+
+/**
+ * \brief Renumbers the global indices of another mapper by a permutation, e.g. to reduce the bandwidth of the
+ *        resulting matrices (\sa reverse_cuthill_mckee_renumbering() and space_filling_curve_renumbering()).
+ *
+ *        The permutation is shared between copies. The backend (the renumbered mapper) has to outlive this mapper.
+ */
+template< class MapperImp >
+class Renumbered
+  : public MapperInterface< internal::RenumberedTraits< MapperImp > >
+{
+  typedef MapperInterface< internal::RenumberedTraits< MapperImp > > InterfaceType;
+public:
+  typedef internal::RenumberedTraits< MapperImp > Traits;
+  typedef typename Traits::BackendType            BackendType;
+  typedef typename Traits::EntityType             EntityType;
+
+  /**
+   * \param new_indices (*new_indices)[old_index] is the new index, has to be a permutation of 0, ..., mapper.size() - 1
+   */
+  Renumbered(const BackendType& mapper, const std::shared_ptr< const std::vector< size_t > >& new_indices)
+    : backend_(mapper)
+    , new_indices_(new_indices)
+  {
+    if (!new_indices_ || new_indices_->size() != backend_.size())
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "The renumbering has to contain one index for each of the " << backend_.size() << " DoFs!");
+  }
+
+  const BackendType& backend() const
+  {
+    return backend_;
+  }
+
+  const std::shared_ptr< const std::vector< size_t > >& new_indices() const
+  {
+    return new_indices_;
+  }
+
+  size_t size() const
+  {
+    return backend_.size();
+  }
+
+  size_t numDofs(const EntityType& entity) const
+  {
+    return backend_.numDofs(entity);
+  }
+
+  size_t maxNumDofs() const
+  {
+    return backend_.maxNumDofs();
+  }
+
+  void globalIndices(const EntityType& entity, Dune::DynamicVector< size_t >& ret) const
+  {
+    backend_.globalIndices(entity, ret);
+    const auto& new_indices = *new_indices_;
+    const size_t num_dofs = backend_.numDofs(entity);
+    for (size_t ii = 0; ii < num_dofs; ++ii)
+      ret[ii] = new_indices[ret[ii]];
+  } // ... globalIndices(...)
+
+  using InterfaceType::globalIndices;
+
+  size_t mapToGlobal(const EntityType& entity, const size_t& localIndex) const
+  {
+    return (*new_indices_)[backend_.mapToGlobal(entity, localIndex)];
+  }
+
+private:
+  const BackendType& backend_;
+  const std::shared_ptr< const std::vector< size_t > > new_indices_;
+}; // class Renumbered
+
+
+} // namespace Mapper
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_MAPPER_RENUMBERED_HH
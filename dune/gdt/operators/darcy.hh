@@ -18,6 +18,7 @@
 #include <dune/stuff/la/container.hh>
 #include <dune/stuff/la/solver.hh>
 
+#include <dune/gdt/assembler/traversal.hh>
 #include <dune/gdt/discretefunction/default.hh>
 #include <dune/gdt/exceptions.hh>
 #include <dune/gdt/spaces/cg/interface.hh>
@@ -78,9 +79,15 @@ public:
   typedef typename GridViewType::ctype                       DomainFieldType;
   static const size_t                                        dimDomain = GridViewType::dimension;
 
-  Darcy(const GridViewType& grd_vw, const FunctionImp& function)
+  typedef SpaceFillingCurveTraversal< GridViewType >         TraversalType;
+
+  /**
+   * \param traversal If given (has to outlive this operator), the grid is walked in this order.
+   */
+  Darcy(const GridViewType& grd_vw, const FunctionImp& function, const TraversalType* traversal = nullptr)
     : grid_view_(grd_vw)
     , function_(function)
+    , traversal_(traversal)
   {}
 
   /**
@@ -112,9 +119,7 @@ private:
     VectorType rhs(range.space().mapper().size());
 
     // walk the grid
-    const auto entity_it_end = grid_view_.template end< 0 >();
-    for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
-      const auto& entity = *entity_it;
+    GDT::internal::for_each_entity(grid_view_, traversal_, [&](const EntityType& entity) {
       const auto local_function = function_.local_function(entity);
       const auto local_source = source.local_function(entity);
       const auto basis = range.space().base_function_set(entity);
@@ -145,7 +150,7 @@ private:
           }
         }
       } // do a volume quadrature
-    } // walk the grid
+    }); // walk the grid
 
     // solve
     try {
@@ -169,9 +174,7 @@ private:
     for (size_t ii = 0; ii < range_vector.size(); ++ii)
       range_vector[ii] = infinity;
     // walk the grid
-    const auto entity_it_end = grid_view_.template end< 0 >();
-    for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
-      const auto& entity = *entity_it;
+    GDT::internal::for_each_entity(grid_view_, traversal_, [&](const EntityType& entity) {
       const auto local_DoF_indices = rtn0_space.local_DoF_indices(entity);
       const auto global_DoF_indices = rtn0_space.mapper().globalIndices(entity);
       assert(global_DoF_indices.size() == local_DoF_indices.size());
@@ -260,11 +263,12 @@ private:
         } else
           DUNE_THROW(Stuff::Exceptions::internal_error, "Unknown intersection type!");
       } // walk the intersections
-    } // walk the grid
+    }); // walk the grid
   } // ... redirect_apply(...)
 
   const GridViewType& grid_view_;
   const FunctionImp& function_;
+  const TraversalType* const traversal_;
 }; // class Darcy
 
 
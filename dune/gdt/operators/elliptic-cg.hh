@@ -19,6 +19,7 @@
 #include <dune/gdt/assembler/system.hh>
 
 #include "base.hh"
+#include "matrix-free.hh"
 
 namespace Dune {
 namespace GDT {
@@ -34,6 +35,14 @@ template< class DiffusionFactorType
         , class DiffusionTensorType = void >
 class EllipticCG;
 
+// forward
+template< class DiffusionFactorType
+        , class SourceSpaceImp
+        , class RangeSpaceImp = SourceSpaceImp
+        , class GridViewImp = typename SourceSpaceImp::GridViewType
+        , class DiffusionTensorType = void >
+class EllipticCGMatrixFree;
+
 
 namespace internal {
 
@@ -81,6 +90,7 @@ class EllipticCG< DiffusionType, MatrixImp, SourceSpaceImp, RangeSpaceImp, GridV
                                                             , RangeSpaceImp, GridViewImp > > OperatorBaseType;
   typedef LocalOperator::Codim0Integral< LocalEvaluation::Elliptic< DiffusionType > >        LocalOperatorType;
   typedef LocalAssembler::Codim0Matrix< LocalOperatorType >                                  LocalAssemblerType;
+  typedef typename MatrixImp::ScalarType                                                     ScalarType;
 public:
   typedef internal::EllipticCGTraits< DiffusionType, MatrixImp, SourceSpaceImp, RangeSpaceImp, GridViewImp, void >
       Traits;
@@ -200,6 +210,63 @@ public:
     }
   } // ... assemble(...)
 
+  /**
+   * \brief Assembles (only once, as assemble() does) using a coloring of the grid view, \sa
+   *        SystemAssembler::assemble_colored().
+   */
+  void assemble_colored()
+  {
+    if (!assembled_) {
+      AssemblerBaseType::assemble_colored();
+      assembled_ = true;
+    }
+  } // ... assemble_colored(...)
+
+  /**
+   * \brief Assembles (only once, as assemble() does) into thread local copies of the matrix, \sa
+   *        SystemAssembler::assemble_with_thread_local_copies().
+   */
+  void assemble_with_thread_local_copies()
+  {
+    if (!assembled_) {
+      AssemblerBaseType::assemble_with_thread_local_copies();
+      assembled_ = true;
+    }
+  } // ... assemble_with_thread_local_copies(...)
+
+  /**
+   * \brief Assembles the matrix again (e.g. after the diffusion has changed), keeping its pattern and adding the
+   *        local matrices at precomputed positions, \sa Products::AssemblableBase::reassemble().
+   */
+  void reassemble()
+  {
+    if (!assembled_) {
+      assemble();
+      return;
+    }
+    auto& matrix = this->matrix();
+    matrix.scal(0.0);
+    if (!AssemblerBaseType::scatter_offsets(matrix))
+      AssemblerBaseType::precompute_scatter_offsets(matrix);
+    this->add(local_assembler_, matrix);
+    AssemblerBaseType::assemble(true);
+  } // ... reassemble(...)
+
+  /**
+   * \brief Computes range = A source, where A is the matrix of this operator, without assembling (or touching) the
+   *        matrix.
+   * \note  To apply the operator repeatedly without allocating a matrix at all, use EllipticCGMatrixFree.
+   * \sa    internal::MatrixFreeApplication
+   */
+  template< class S, class R >
+  void apply_matrix_free(const Stuff::LA::VectorInterface< S, ScalarType >& source,
+                         Stuff::LA::VectorInterface< R, ScalarType >& range) const
+  {
+    internal::MatrixFreeApplication< RangeSpaceType, SourceSpaceType, GridViewType >
+        application(this->range_space(), this->source_space(), OperatorBaseType::grid_view());
+    application.apply(local_operator_, source, range);
+  } // ... apply_matrix_free(...)
+
 private:
   const DiffusionType& diffusion_;
   const LocalOperatorType local_operator_;
@@ -208,6 +275,79 @@ private:
 }; // class EllipticCG
 
 
+/**
+ * \brief The operator of EllipticCG, which is only applied matrix-free and thus neither computes a sparsity pattern
+ *        nor allocates a matrix, e.g. for use within iterative solvers, \sa internal::MatrixFreeApplication.
+ */
+template< class DiffusionType, class SourceSpaceImp, class RangeSpaceImp, class GridViewImp >
+class EllipticCGMatrixFree< DiffusionType, SourceSpaceImp, RangeSpaceImp, GridViewImp, void >
+{
+  static_assert(Stuff::is_localizable_function< DiffusionType >::value,
+                "DiffusionType has to be derived from Stuff::LocalizableFunctionInterface!");
+  static_assert(is_space< SourceSpaceImp >::value, "SourceSpaceImp has to be derived from SpaceInterface!");
+  static_assert(is_space< RangeSpaceImp >::value,  "RangeSpaceImp has to be derived from SpaceInterface!");
+  typedef LocalOperator::Codim0Integral< LocalEvaluation::Elliptic< DiffusionType > >   LocalOperatorType;
+  typedef internal::MatrixFreeApplication< RangeSpaceImp, SourceSpaceImp, GridViewImp > ApplicationType;
+public:
+  typedef SourceSpaceImp                            SourceSpaceType;
+  typedef RangeSpaceImp                             RangeSpaceType;
+  typedef GridViewImp                               GridViewType;
+  typedef typename RangeSpaceType::RangeFieldType   ScalarType;
+  typedef typename ApplicationType::TraversalType   TraversalType;
+
+  /**
+   * \param traversal If given (has to outlive this operator), its partitions are used to walk the grid in parallel.
+   */
+  EllipticCGMatrixFree(const DiffusionType& diffusion,
+                       const SourceSpaceType& source_space,
+                       const RangeSpaceType& range_space,
+                       const GridViewType& grid_view,
+                       const TraversalType* traversal = nullptr)
+    : source_space_(source_space)
+    , range_space_(range_space)
+    , grid_view_(grid_view)
+    , local_operator_(diffusion)
+    , application_(range_space_, source_space_, grid_view_, traversal)
+  {}
+
+  EllipticCGMatrixFree(const DiffusionType& diffusion,
+                       const SourceSpaceType& source_space,
+                       const TraversalType* traversal = nullptr)
+    : EllipticCGMatrixFree(diffusion, source_space, source_space, source_space.grid_view(), traversal)
+  {}
+
+  const SourceSpaceType& source_space() const
+  {
+    return source_space_;
+  }
+
+  const RangeSpaceType& range_space() const
+  {
+    return range_space_;
+  }
+
+  const GridViewType& grid_view() const
+  {
+    return grid_view_;
+  }
+
+  /// \brief Computes range = A source, where A is the matrix EllipticCG would assemble.
+  template< class S, class R >
+  void apply(const Stuff::LA::VectorInterface< S, ScalarType >& source,
+             Stuff::LA::VectorInterface< R, ScalarType >& range) const
+  {
+    application_.apply(local_operator_, source, range);
+  }
+
+private:
+  const SourceSpaceType& source_space_;
+  const RangeSpaceType& range_space_;
+  const GridViewType& grid_view_;
+  const LocalOperatorType local_operator_;
+  const ApplicationType application_;
+}; // class EllipticCGMatrixFree
+
+
 } // namespace Operators
 } // namespace GDT
 } // namespace Dune
@@ -23,6 +23,7 @@
 #include <dune/gdt/assembler/system.hh>
 
 #include "base.hh"
+#include "matrix-free.hh"
 
 namespace Dune {
 namespace GDT {
@@ -38,6 +39,14 @@ template< class DiffusionFactorType
         , class DiffusionTensorType = void >
 class EllipticSWIPDG;
 
+// forward
+template< class DiffusionFactorType
+        , class SourceSpaceImp
+        , class RangeSpaceImp = SourceSpaceImp
+        , class GridViewImp = typename SourceSpaceImp::GridViewType
+        , class DiffusionTensorType = void >
+class EllipticSWIPDGMatrixFree;
+
 
 namespace internal {
 
@@ -150,6 +159,7 @@ public:
     , coupling_assembler_(coupling_operator_)
     , dirichlet_boundary_operator_(diffusion_, beta)
     , dirichlet_boundary_assembler_(dirichlet_boundary_operator_)
+    , assembled_(false)
   {
     setup();
   }
@@ -173,6 +183,7 @@ public:
     , coupling_assembler_(coupling_operator_)
     , dirichlet_boundary_operator_(diffusion_, beta)
     , dirichlet_boundary_assembler_(dirichlet_boundary_operator_)
+    , assembled_(false)
   {
     setup();
   }
@@ -194,6 +205,7 @@ public:
     , coupling_assembler_(coupling_operator_)
     , dirichlet_boundary_operator_(diffusion_, beta)
     , dirichlet_boundary_assembler_(dirichlet_boundary_operator_)
+    , assembled_(false)
   {
     setup();
   }
@@ -216,6 +228,7 @@ public:
     , coupling_assembler_(coupling_operator_)
     , dirichlet_boundary_operator_(diffusion_, beta)
     , dirichlet_boundary_assembler_(dirichlet_boundary_operator_)
+    , assembled_(false)
   {
     setup();
   }
@@ -236,6 +249,7 @@ public:
     , coupling_assembler_(coupling_operator_)
     , dirichlet_boundary_operator_(diffusion_, beta)
     , dirichlet_boundary_assembler_(dirichlet_boundary_operator_)
+    , assembled_(false)
   {
     setup();
   }
@@ -255,6 +269,7 @@ public:
     , coupling_assembler_(coupling_operator_)
     , dirichlet_boundary_operator_(diffusion_, beta)
     , dirichlet_boundary_assembler_(dirichlet_boundary_operator_)
+    , assembled_(false)
   {
     setup();
   }
@@ -263,8 +278,69 @@ public:
 
   virtual void assemble() override final
   {
+    if (!assembled_) {
+      AssemblerBaseType::assemble();
+      assembled_ = true;
+    }
+  } // ... assemble(...)
+
+  /**
+   * \brief Assembles (only once, as assemble() does) using a coloring of the grid view, \sa
+   *        SystemAssembler::assemble_colored().
+   */
+  void assemble_colored()
+  {
+    if (!assembled_) {
+      AssemblerBaseType::assemble_colored();
+      assembled_ = true;
+    }
+  } // ... assemble_colored(...)
+
+  /**
+   * \brief Assembles (only once, as assemble() does) into thread local copies of the matrix, \sa
+   *        SystemAssembler::assemble_with_thread_local_copies().
+   */
+  void assemble_with_thread_local_copies()
+  {
+    if (!assembled_) {
+      AssemblerBaseType::assemble_with_thread_local_copies();
+      assembled_ = true;
+    }
+  } // ... assemble_with_thread_local_copies(...)
+
+  /**
+   * \brief Assembles the matrix again (e.g. after the diffusion has changed), keeping its pattern and adding the
+   *        local matrices at precomputed positions, \sa Products::AssemblableBase::reassemble().
+   */
+  void reassemble()
+  {
+    if (!assembled_) {
+      assemble();
+      return;
+    }
+    auto& matrix = this->matrix();
+    matrix.scal(0.0);
+    if (!AssemblerBaseType::scatter_offsets(matrix))
+      AssemblerBaseType::precompute_scatter_offsets(matrix, MatrixStorage::full, true);
+    setup();
     AssemblerBaseType::assemble();
-  }
+  } // ... reassemble(...)
+
+  /**
+   * \brief Computes range = A source, where A is the matrix of this operator, without assembling (or touching) the
+   *        matrix.
+   * \note  To apply the operator repeatedly without allocating a matrix at all, use EllipticSWIPDGMatrixFree.
+   * \sa    internal::MatrixFreeApplication
+   */
+  template< class S, class R >
+  void apply_matrix_free(const Stuff::LA::VectorInterface< S, ScalarType >& source,
+                         Stuff::LA::VectorInterface< R, ScalarType >& range) const
+  {
+    internal::MatrixFreeApplication< RangeSpaceType, SourceSpaceType, GridViewType >
+        application(this->range_space(), this->source_space(), OperatorBaseType::grid_view());
+    application.apply(volume_operator_, coupling_operator_, dirichlet_boundary_operator_, boundary_info_,
+                      source, range);
+  } // ... apply_matrix_free(...)
 
 private:
   void setup()
@@ -284,9 +360,102 @@ private:
   const CouplingAssemblerType coupling_assembler_;
   const DirichletBoundaryOperatorType dirichlet_boundary_operator_;
   const DirichletBoundaryAssemblerType dirichlet_boundary_assembler_;
+  bool assembled_;
 }; // class EllipticSWIPDG
 
 
+/**
+ * \brief The operator of EllipticSWIPDG, which is only applied matrix-free and thus neither computes a sparsity
+ *        pattern nor allocates a matrix, e.g. for use within iterative solvers, \sa internal::MatrixFreeApplication.
+ */
+template< class DiffusionType, class SourceSpaceImp, class RangeSpaceImp, class GridViewImp >
+class EllipticSWIPDGMatrixFree< DiffusionType, SourceSpaceImp, RangeSpaceImp, GridViewImp, void >
+{
+  static_assert(Stuff::is_localizable_function< DiffusionType >::value,
+                "DiffusionType has to be derived from Stuff::LocalizableFunctionInterface!");
+  static_assert(is_space< SourceSpaceImp >::value, "SourceSpaceImp has to be derived from SpaceInterface!");
+  static_assert(is_space< RangeSpaceImp >::value,  "RangeSpaceImp has to be derived from SpaceInterface!");
+  typedef LocalOperator::Codim0Integral< LocalEvaluation::Elliptic< DiffusionType > > VolumeOperatorType;
+  typedef LocalOperator::Codim1CouplingIntegral< LocalEvaluation::SWIPDG::Inner< DiffusionType > >
+                                                                                      CouplingOperatorType;
+  typedef LocalOperator::Codim1BoundaryIntegral< LocalEvaluation::SWIPDG::BoundaryLHS< DiffusionType > >
+                                                                                      DirichletBoundaryOperatorType;
+  typedef internal::MatrixFreeApplication< RangeSpaceImp, SourceSpaceImp, GridViewImp > ApplicationType;
+public:
+  typedef SourceSpaceImp                               SourceSpaceType;
+  typedef RangeSpaceImp                                RangeSpaceType;
+  typedef GridViewImp                                  GridViewType;
+  typedef typename RangeSpaceType::RangeFieldType      ScalarType;
+  typedef typename ApplicationType::BoundaryInfoType   BoundaryInfoType;
+  typedef typename ApplicationType::TraversalType      TraversalType;
+
+  /**
+   * \param traversal If given (has to outlive this operator), its partitions are used to walk the grid in parallel.
+   */
+  EllipticSWIPDGMatrixFree(const DiffusionType& diffusion,
+                           const BoundaryInfoType& boundary_info,
+                           const SourceSpaceType& source_space,
+                           const RangeSpaceType& range_space,
+                           const GridViewType& grid_view,
+                           const ScalarType beta
+                               = LocalEvaluation::SIPDG::internal::default_beta(GridViewType::dimension),
+                           const TraversalType* traversal = nullptr)
+    : boundary_info_(boundary_info)
+    , source_space_(source_space)
+    , range_space_(range_space)
+    , grid_view_(grid_view)
+    , volume_operator_(diffusion)
+    , coupling_operator_(diffusion, beta)
+    , dirichlet_boundary_operator_(diffusion, beta)
+    , application_(range_space_, source_space_, grid_view_, traversal)
+  {}
+
+  EllipticSWIPDGMatrixFree(const DiffusionType& diffusion,
+                           const BoundaryInfoType& boundary_info,
+                           const SourceSpaceType& source_space,
+                           const ScalarType beta
+                               = LocalEvaluation::SIPDG::internal::default_beta(GridViewType::dimension),
+                           const TraversalType* traversal = nullptr)
+    : EllipticSWIPDGMatrixFree(diffusion, boundary_info, source_space, source_space, source_space.grid_view(), beta,
+                               traversal)
+  {}
+
+  const SourceSpaceType& source_space() const
+  {
+    return source_space_;
+  }
+
+  const RangeSpaceType& range_space() const
+  {
+    return range_space_;
+  }
+
+  const GridViewType& grid_view() const
+  {
+    return grid_view_;
+  }
+
+  /// \brief Computes range = A source, where A is the matrix EllipticSWIPDG would assemble.
+  template< class S, class R >
+  void apply(const Stuff::LA::VectorInterface< S, ScalarType >& source,
+             Stuff::LA::VectorInterface< R, ScalarType >& range) const
+  {
+    application_.apply(volume_operator_, coupling_operator_, dirichlet_boundary_operator_, boundary_info_,
+                       source, range);
+  }
+
+private:
+  const BoundaryInfoType& boundary_info_;
+  const SourceSpaceType& source_space_;
+  const RangeSpaceType& range_space_;
+  const GridViewType& grid_view_;
+  const VolumeOperatorType volume_operator_;
+  const CouplingOperatorType coupling_operator_;
+  const DirichletBoundaryOperatorType dirichlet_boundary_operator_;
+  const ApplicationType application_;
+}; // class EllipticSWIPDGMatrixFree
+
+
 /// \todo use matrix as first template parameter, dro /*matrix*/
 /// \todo return by value, implement move ctor
 template< class DF, class M, class S >
@@ -312,6 +481,16 @@ std::unique_ptr< EllipticSWIPDG< DF, M, S, S, typename S::GridViewType > > make_
                                                                                                space);
 } // ... make_elliptic_swipdg(...)
 
+template< class DF, class S >
+std::unique_ptr< EllipticSWIPDGMatrixFree< DF, S > >
+make_elliptic_swipdg_matrix_free(const DF& diffusion_factor,
+                                 const Stuff::Grid::BoundaryInfoInterface< typename S::GridViewType::Intersection >&
+                                     boundary_info,
+                                 const S& space)
+{
+  return Stuff::Common::make_unique< EllipticSWIPDGMatrixFree< DF, S > >(diffusion_factor, boundary_info, space);
+} // ... make_elliptic_swipdg_matrix_free(...)
+
 
 } // namespace Operators
 } // namespace GDT
@@ -0,0 +1,295 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_OPERATORS_MATRIX_FREE_HH
+#define DUNE_GDT_OPERATORS_MATRIX_FREE_HH
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+
+#include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/parallel/threadstorage.hh>
+#include <dune/stuff/grid/boundaryinfo.hh>
+#include <dune/stuff/grid/walker/apply-on.hh>
+#include <dune/stuff/la/container/interfaces.hh>
+
+#include <dune/gdt/assembler/local/bound-space.hh>
+#include <dune/gdt/assembler/traversal.hh>
+#include <dune/gdt/assembler/wrapper.hh>
+#include <dune/gdt/spaces/interface.hh>
+
+namespace Dune {
+namespace GDT {
+namespace Operators {
+namespace internal {
+
+
+/**
+ * \brief Computes range = A source, where A is given by local operators on the entities and (optionally) on the inner
+ *        and Dirichlet intersections of a grid view, without assembling A.
+ *
+ *        On each entity and intersection, the local matrices are computed by the local operators and directly
+ *        multiplied with the local DoF vectors of source, the results are added to range. This is exactly what the
+ *        respective local assemblers add to the system matrix (inner intersections are visited once, as by
+ *        Stuff::Grid::ApplyOn::InnerIntersectionsPrimally).
+ *
+ *        The entities are walked in parallel if TBB is available (\sa GDT::internal::parallel_for_each_entity()). Since
+ *        neighboring entities share rows of range (DoFs of continuous spaces, couplings of discontinuous ones), each
+ *        thread adds into its own copy of range, which are summed up afterwards (\sa
+ *        GDT::internal::ThreadLocalContainer). Each thread uses its own copy of the spaces, binds them to one entity
+ *        after another (\sa LocalAssembler::BoundSpace) and keeps these copies and all temporary storage for the
+ *        lifetime of this object, so repeated applications (e.g. within iterative solvers) do not allocate apart from
+ *        the copies of range.
+ * \note  Applications of the same object must not run concurrently.
+ */
+template< class RangeSpaceType, class SourceSpaceType, class GridViewType >
+class MatrixFreeApplication
+{
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename RangeSpaceType::RangeFieldType             FieldType;
+  typedef GDT::internal::BoundSpaces< RangeSpaceType, SourceSpaceType > BoundSpacesType;
+
+  struct Storage
+  {
+    BoundSpacesType bound_spaces;
+    std::vector< Dune::DynamicMatrix< FieldType > > local_matrices;
+    std::vector< Dune::DynamicMatrix< FieldType > > tmp_local_matrices;
+    Dune::DynamicVector< FieldType > source_entity;
+    Dune::DynamicVector< FieldType > source_neighbor;
+  }; // struct Storage
+
+public:
+  typedef Stuff::Grid::BoundaryInfoInterface< typename GridViewType::Intersection > BoundaryInfoType;
+  typedef SpaceFillingCurveTraversal< GridViewType >                                TraversalType;
+
+  /**
+   * \param traversal If given (has to outlive this object), its partitions are used to walk the grid in parallel.
+   *                  Otherwise this object builds its own traversal on first application and keeps it (as long as the
+   *                  number of entities of grid_view does not change), instead of collecting the entities anew on each
+   *                  application.
+   */
+  MatrixFreeApplication(const RangeSpaceType& range_space,
+                        const SourceSpaceType& source_space,
+                        const GridViewType& grid_view,
+                        const TraversalType* traversal = nullptr)
+    : range_space_(range_space)
+    , source_space_(source_space)
+    , grid_view_(grid_view)
+    , traversal_(traversal)
+    , range_spaces_(range_space_)
+    , source_spaces_(source_space_)
+  {}
+
+  /// \brief Only considers local operators on entities (as required for continuous spaces).
+  template< class VolumeOperatorType, class S, class R >
+  void apply(const VolumeOperatorType& volume_operator,
+             const Stuff::LA::VectorInterface< S, FieldType >& source,
+             Stuff::LA::VectorInterface< R, FieldType >& range) const
+  {
+    walk(volume_operator.numTmpObjectsRequired(), source, range,
+         [&](const EntityType& /*entity*/, Storage& storage, typename R::derived_type& local_range) {
+      apply_volume(volume_operator, local_range, storage);
+    });
+  } // ... apply(...)
+
+  /// \brief Considers local operators on entities, inner intersections and Dirichlet intersections.
+  template< class VolumeOperatorType, class CouplingOperatorType, class BoundaryOperatorType, class S, class R >
+  void apply(const VolumeOperatorType& volume_operator,
+             const CouplingOperatorType& coupling_operator,
+             const BoundaryOperatorType& boundary_operator,
+             const BoundaryInfoType& boundary_info,
+             const Stuff::LA::VectorInterface< S, FieldType >& source,
+             Stuff::LA::VectorInterface< R, FieldType >& range) const
+  {
+    const Stuff::Grid::ApplyOn::InnerIntersectionsPrimally< GridViewType > inner_intersections;
+    const Stuff::Grid::ApplyOn::DirichletIntersections< GridViewType > dirichlet_intersections(boundary_info);
+    walk(std::max({volume_operator.numTmpObjectsRequired(),
+                   coupling_operator.numTmpObjectsRequired(),
+                   boundary_operator.numTmpObjectsRequired()}),
+         source,
+         range,
+         [&](const EntityType& entity, Storage& storage, typename R::derived_type& local_range) {
+      apply_volume(volume_operator, local_range, storage);
+      const auto intersection_it_end = grid_view_.iend(entity);
+      for (auto intersection_it = grid_view_.ibegin(entity);
+           intersection_it != intersection_it_end;
+           ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        if (inner_intersections.apply_on(grid_view_, intersection))
+          apply_coupling(coupling_operator, intersection, source, local_range, storage);
+        else if (dirichlet_intersections.apply_on(grid_view_, intersection))
+          apply_boundary(boundary_operator, intersection, local_range, storage);
+      }
+    });
+  } // ... apply(...)
+
+private:
+  /**
+   * \brief Calls functor(entity, storage, range) for each entity (in parallel, if possible), where storage is bound to
+   *        entity and holds its local DoFs of source and range is the vector the calling thread has to add into.
+   */
+  template< class S, class R, class FunctorType >
+  void walk(const size_t num_tmp_objects,
+            const Stuff::LA::VectorInterface< S, FieldType >& source,
+            Stuff::LA::VectorInterface< R, FieldType >& range,
+            const FunctorType& functor) const
+  {
+    assert(source.size() == source_space_.mapper().size());
+    assert(range.size() == range_space_.mapper().size());
+    range.scal(FieldType(0));
+    const size_t size = std::max(range_space_.mapper().maxNumDofs(), source_space_.mapper().maxNumDofs());
+    GDT::internal::ThreadLocalContainer< typename R::derived_type > thread_local_range(range.as_imp());
+#if HAVE_TBB
+    thread_local_range.enable();
+#endif
+    GDT::internal::parallel_for_each_entity(grid_view_, traversal(), [&](const EntityType& entity) {
+      auto& storage = *storages_;
+      prepare(size, num_tmp_objects, storage);
+      storage.bound_spaces.bind_inside(*range_spaces_, *source_spaces_, entity);
+      gather(storage.bound_spaces.ansatz_inside, source, storage.source_entity);
+      functor(entity, storage, thread_local_range.get());
+    });
+    thread_local_range.reduce();
+  } // ... walk(...)
+
+  /// \brief The given traversal or the own one, \sa MatrixFreeApplication().
+  const TraversalType* traversal() const
+  {
+    if (traversal_)
+      return traversal_;
+    if (!own_traversal_ || own_traversal_->size() != size_t(grid_view_.size(0)))
+      own_traversal_ = DSC::make_unique< const TraversalType >(grid_view_);
+    return own_traversal_.get();
+  } // ... traversal(...)
+
+  static void prepare(const size_t size, const size_t num_tmp_objects, Storage& storage)
+  {
+    if (storage.local_matrices.size() < 4 || storage.local_matrices[0].rows() < size
+        || storage.local_matrices[0].cols() < size) {
+      storage.local_matrices.assign(4, Dune::DynamicMatrix< FieldType >(size, size, FieldType(0)));
+      storage.tmp_local_matrices.clear();
+    }
+    if (storage.tmp_local_matrices.size() < num_tmp_objects)
+      storage.tmp_local_matrices.resize(num_tmp_objects, Dune::DynamicMatrix< FieldType >(size, size, FieldType(0)));
+    if (storage.source_entity.size() < size)
+      storage.source_entity.resize(size);
+    if (storage.source_neighbor.size() < size)
+      storage.source_neighbor.resize(size);
+  } // ... prepare(...)
+
+  template< class S >
+  static void gather(const LocalAssembler::BoundSpace< SourceSpaceType >& source_space,
+                     const Stuff::LA::VectorInterface< S, FieldType >& source,
+                     Dune::DynamicVector< FieldType >& ret)
+  {
+    const auto& global_indices = source_space.global_indices();
+    for (size_t jj = 0; jj < source_space.size(); ++jj)
+      ret[jj] = source.get_entry(global_indices[jj]);
+  } // ... gather(...)
+
+  /// \brief Adds local_matrix * local_source to range.
+  template< class RangeType >
+  static void scatter(const Dune::DynamicMatrix< FieldType >& local_matrix,
+                      const Dune::DynamicVector< FieldType >& local_source,
+                      const LocalAssembler::BoundSpace< RangeSpaceType >& range_space,
+                      const size_t cols,
+                      RangeType& range)
+  {
+    const auto& global_rows = range_space.global_indices();
+    for (size_t ii = 0; ii < range_space.size(); ++ii) {
+      const auto& local_row = local_matrix[ii];
+      FieldType value(0);
+      for (size_t jj = 0; jj < cols; ++jj)
+        value += local_row[jj] * local_source[jj];
+      range.add_to_entry(global_rows[ii], value);
+    }
+  } // ... scatter(...)
+
+  template< class VolumeOperatorType, class RangeType >
+  void apply_volume(const VolumeOperatorType& volume_operator, RangeType& range, Storage& storage) const
+  {
+    const auto& bound_spaces = storage.bound_spaces;
+    auto& local_matrix = storage.local_matrices[0];
+    local_matrix *= 0.0;
+    volume_operator.apply(bound_spaces.test_inside.base(),
+                          bound_spaces.ansatz_inside.base(),
+                          local_matrix,
+                          storage.tmp_local_matrices);
+    scatter(local_matrix, storage.source_entity, bound_spaces.test_inside, bound_spaces.ansatz_inside.size(), range);
+  } // ... apply_volume(...)
+
+  template< class CouplingOperatorType, class IntersectionType, class S, class RangeType >
+  void apply_coupling(const CouplingOperatorType& coupling_operator,
+                      const IntersectionType& intersection,
+                      const Stuff::LA::VectorInterface< S, FieldType >& source,
+                      RangeType& range,
+                      Storage& storage) const
+  {
+    const auto neighbor_ptr = intersection.outside();
+    const auto& neighbor = *neighbor_ptr;
+    auto& bound_spaces = storage.bound_spaces;
+    bound_spaces.bind_outside(bound_spaces.test_inside.space(), bound_spaces.ansatz_inside.space(), neighbor);
+    gather(bound_spaces.ansatz_outside, source, storage.source_neighbor);
+    auto& local_matrix_entity_entity = storage.local_matrices[0];
+    auto& local_matrix_neighbor_neighbor = storage.local_matrices[1];
+    auto& local_matrix_entity_neighbor = storage.local_matrices[2];
+    auto& local_matrix_neighbor_entity = storage.local_matrices[3];
+    for (auto& local_matrix : storage.local_matrices)
+      local_matrix *= 0.0;
+    coupling_operator.apply(bound_spaces.test_inside.base(), bound_spaces.ansatz_inside.base(),
+                            bound_spaces.test_outside.base(), bound_spaces.ansatz_outside.base(),
+                            intersection,
+                            local_matrix_entity_entity,
+                            local_matrix_neighbor_neighbor,
+                            local_matrix_entity_neighbor,
+                            local_matrix_neighbor_entity,
+                            storage.tmp_local_matrices);
+    const size_t cols_entity = bound_spaces.ansatz_inside.size();
+    const size_t cols_neighbor = bound_spaces.ansatz_outside.size();
+    scatter(local_matrix_entity_entity, storage.source_entity, bound_spaces.test_inside, cols_entity, range);
+    scatter(local_matrix_entity_neighbor, storage.source_neighbor, bound_spaces.test_inside, cols_neighbor, range);
+    scatter(local_matrix_neighbor_entity, storage.source_entity, bound_spaces.test_outside, cols_entity, range);
+    scatter(local_matrix_neighbor_neighbor, storage.source_neighbor, bound_spaces.test_outside, cols_neighbor, range);
+  } // ... apply_coupling(...)
+
+  template< class BoundaryOperatorType, class IntersectionType, class RangeType >
+  void apply_boundary(const BoundaryOperatorType& boundary_operator,
+                      const IntersectionType& intersection,
+                      RangeType& range,
+                      Storage& storage) const
+  {
+    const auto& bound_spaces = storage.bound_spaces;
+    auto& local_matrix = storage.local_matrices[0];
+    local_matrix *= 0.0;
+    boundary_operator.apply(bound_spaces.test_inside.base(),
+                            bound_spaces.ansatz_inside.base(),
+                            intersection,
+                            local_matrix,
+                            storage.tmp_local_matrices);
+    scatter(local_matrix, storage.source_entity, bound_spaces.test_inside, bound_spaces.ansatz_inside.size(), range);
+  } // ... apply_boundary(...)
+
+  const RangeSpaceType& range_space_;
+  const SourceSpaceType& source_space_;
+  const GridViewType& grid_view_;
+  const TraversalType* const traversal_;
+  mutable std::unique_ptr< const TraversalType > own_traversal_;
+  mutable DS::PerThreadValue< const RangeSpaceType > range_spaces_;
+  mutable DS::PerThreadValue< const SourceSpaceType > source_spaces_;
+  // has to be destroyed before the copies of the spaces, since the bound spaces refer to them
+  mutable DS::PerThreadValue< Storage > storages_;
+}; // class MatrixFreeApplication
+
+
+} // namespace internal
+} // namespace Operators
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_OPERATORS_MATRIX_FREE_HH
@@ -7,18 +7,30 @@
 #define DUNE_GDT_OPERATORS_OSWALD_HH
 
 #include <vector>
-#include <set>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+
+#if HAVE_TBB
+# include <tbb/blocked_range.h>
+# include <tbb/parallel_for.h>
+#endif
 
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <dune/common/unused.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
 #include <dune/stuff/aliases.hh>
 #include <dune/stuff/common/vector.hh>
-#include <dune/stuff/common/float_cmp.hh>
+#include <dune/stuff/common/parallel/threadstorage.hh>
 #include <dune/stuff/common/print.hh>
 #include <dune/stuff/common/ranges.hh>
 #include <dune/stuff/grid/walker.hh>
 
+#include <dune/gdt/assembler/traversal.hh>
 #include <dune/gdt/discretefunction/default.hh>
 #include <dune/gdt/playground/spaces/dg/fem.hh>
 #include <dune/gdt/playground/spaces/block.hh>
@@ -48,6 +60,176 @@ public:
 };
 
 
+/**
+ * \brief The DoFs of a DG space of piecewise linear functions which are associated with each vertex of a grid view
+ *        (stored as compressed rows) and whether each vertex lies on the domain boundary.
+ *
+ *        Built by one parallel walk over the grid (\sa GDT::internal::parallel_for_each_entity()), where each thread
+ *        only writes to the DoFs of its entity, and one sequential pass over all DoFs.
+ */
+class OswaldIncidence
+{
+public:
+  template< class GridViewType, class SpaceType >
+  OswaldIncidence(const GridViewType& grid_view,
+                  const SpaceType& space,
+                  const SpaceFillingCurveTraversal< GridViewType >* traversal)
+    : num_vertices_(grid_view.indexSet().size(GridViewType::dimension))
+    , num_entities_(grid_view.indexSet().size(0))
+    , index_set_(&grid_view.indexSet())
+    , mapper_(&space.mapper())
+  {
+    static const size_t dimDomain = GridViewType::dimension;
+    typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+    typedef typename GridViewType::ctype                       DomainFieldType;
+    const size_t invalid = std::numeric_limits< size_t >::max();
+    std::vector< size_t > DoF_vertices(space.mapper().size(), invalid);
+    std::vector< char > boundary_DoFs(space.mapper().size(), 0);
+    DS::PerThreadValue< std::vector< size_t > > local_DoFs_of_vertices;
+    GDT::internal::parallel_for_each_entity_with_space(grid_view, traversal, space,
+                                                       [&](const SpaceType& local_space, const EntityType& entity) {
+      auto& local_DoFs = *local_DoFs_of_vertices;
+      const size_t num_vertices = boost::numeric_cast< size_t >(entity.template count< dimDomain >());
+      const auto basis = local_space.base_function_set(entity);
+      if (basis.size() != num_vertices)
+        DUNE_THROW(Dune::Stuff::Exceptions::internal_error, "basis.size() = " << basis.size());
+      local_DoFs.resize(num_vertices);
+      //loop over all vertices of the entitity, to find their associated global DoF indices
+      for (size_t local_vertex_id = 0; local_vertex_id < num_vertices; ++local_vertex_id) {
+        const auto vertex_ptr = entity.template subEntity< dimDomain >(boost::numeric_cast< int >(local_vertex_id));
+        const auto global_vertex_id = grid_view.indexSet().index(*vertex_ptr);
+        const auto vertex = vertex_ptr->geometry().center();
+        // find the local basis function which corresponds to this vertex
+        const auto basis_values = basis.evaluate(entity.geometry().local(vertex));
+        if (basis_values.size() != num_vertices)
+          DUNE_THROW(Dune::Stuff::Exceptions::internal_error, "basis_values.size() = " << basis_values.size());
+        size_t ones = 0;
+        size_t zeros = 0;
+        size_t failures = 0;
+        size_t local_DoF_index = 0;
+        for (size_t ii = 0; ii < basis.size(); ++ii) {
+          if (std::abs(basis_values[ii][0] - 1.0) < 1e-14) {
+            local_DoF_index = ii;
+            ++ones;
+          } else if (std::abs(basis_values[ii][0] - 0.0) < 1e-14)
+            ++zeros;
+          else
+            ++failures;
+        }
+        if (ones != 1 || zeros != (basis.size() - 1) || failures > 0) {
+          std::stringstream ss;
+          ss << "ones = " << ones << ", zeros = " << zeros << ", failures = " << failures << ", num_vertices = "
+             << num_vertices << ", entity " << grid_view.indexSet().index(entity)
+             << ", vertex " << local_vertex_id << ": [ " << vertex << "], ";
+          Stuff::Common::print(basis_values, "basis_values", ss);
+          DUNE_THROW(Dune::Stuff::Exceptions::internal_error, ss.str());
+        }
+        // now we know that the local DoF index of this vertex is ii
+        local_DoFs[local_vertex_id] = local_DoF_index;
+        DoF_vertices[local_space.mapper().mapToGlobal(entity, local_DoF_index)] = global_vertex_id;
+      } //loop over all vertices
+      // the vertices of all boundary intersections are boundary vertices
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      const auto intersection_it_end = grid_view.iend(entity);
+      for (auto intersection_it = grid_view.ibegin(entity); intersection_it != intersection_it_end; ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        if (intersection.boundary() && !intersection.neighbor()) {
+          const int face = intersection.indexInInside();
+          for (int ii = 0; ii < reference_element.size(face, 1, dimDomain); ++ii) {
+            const size_t local_vertex_id = boost::numeric_cast< size_t >(reference_element.subEntity(face,
+                                                                                                      1,
+                                                                                                      ii,
+                                                                                                      dimDomain));
+            boundary_DoFs[local_space.mapper().mapToGlobal(entity, local_DoFs[local_vertex_id])] = 1;
+          }
+        }
+      } // loop over all intersections
+    }); // walk the grid
+    // invert
+    vertex_offsets_.assign(num_vertices_ + 1, 0);
+    for (const auto& vertex : DoF_vertices)
+      if (vertex != invalid)
+        ++vertex_offsets_[vertex + 1];
+    std::partial_sum(vertex_offsets_.begin(), vertex_offsets_.end(), vertex_offsets_.begin());
+    vertex_DoFs_.resize(vertex_offsets_.back());
+    boundary_vertices_.assign(num_vertices_, 0);
+    std::vector< size_t > positions(vertex_offsets_.begin(), vertex_offsets_.end() - 1);
+    for (size_t DoF = 0; DoF < DoF_vertices.size(); ++DoF) {
+      const size_t vertex = DoF_vertices[DoF];
+      if (vertex == invalid)
+        continue;
+      vertex_DoFs_[positions[vertex]++] = DoF;
+      if (boundary_DoFs[DoF])
+        boundary_vertices_[vertex] = 1;
+    }
+    size_ = DoF_vertices.size();
+  } // OswaldIncidence(...)
+
+  /**
+   * \brief Returns true if this was built for the mapper of space and the index set of grid_view, for as many DoFs,
+   *        vertices and entities. This does not walk the grid, so an adaptation which keeps all these sizes is not
+   *        detected, \sa OswaldInterpolation::invalidate().
+   */
+  template< class GridViewType, class SpaceType >
+  bool fits(const GridViewType& grid_view, const SpaceType& space) const
+  {
+    return mapper_ == &space.mapper()
+        && index_set_ == &grid_view.indexSet()
+        && size_ == space.mapper().size()
+        && num_vertices_ == grid_view.indexSet().size(GridViewType::dimension)
+        && num_entities_ == grid_view.indexSet().size(0);
+  }
+
+  size_t num_vertices() const
+  {
+    return num_vertices_;
+  }
+
+  const size_t* vertex_DoFs_begin(const size_t vv) const
+  {
+    return vertex_DoFs_.data() + vertex_offsets_[vv];
+  }
+
+  const size_t* vertex_DoFs_end(const size_t vv) const
+  {
+    return vertex_DoFs_.data() + vertex_offsets_[vv + 1];
+  }
+
+  bool boundary(const size_t vv) const
+  {
+    return boundary_vertices_[vv] != 0;
+  }
+
+  /**
+   * \brief Calls functor(vv) for all vertices, in parallel if TBB is available.
+   * \note  functor is called concurrently, so it has to take care of its own thread safety.
+   */
+  template< class FunctorType >
+  void for_each_vertex(const FunctorType& functor) const
+  {
+#if HAVE_TBB
+    tbb::parallel_for(tbb::blocked_range< size_t >(0, num_vertices_), [&](const tbb::blocked_range< size_t >& range) {
+      for (size_t vv = range.begin(); vv != range.end(); ++vv)
+        functor(vv);
+    });
+#else // HAVE_TBB
+    for (size_t vv = 0; vv < num_vertices_; ++vv)
+      functor(vv);
+#endif // HAVE_TBB
+  } // ... for_each_vertex(...)
+
+private:
+  const size_t num_vertices_;
+  const size_t num_entities_;
+  const void* const index_set_;
+  const void* const mapper_;
+  size_t size_;
+  std::vector< size_t > vertex_offsets_;
+  std::vector< size_t > vertex_DoFs_;
+  std::vector< char > boundary_vertices_;
+}; // class OswaldIncidence
+
+
 } // namespace internal
 
 
@@ -60,12 +242,31 @@ public:
   typedef typename Traits::GridViewType GridViewType;
   typedef typename Traits::FieldType    FieldType;
   static const size_t                   dimDomain = GridViewType::dimension;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef SpaceFillingCurveTraversal< GridViewType >         TraversalType;
 
-  OswaldInterpolation(const GridViewType& grd_vw, const bool zero_boundary = true)
+  /**
+   * \param traversal If given (has to outlive this operator), its partitions are used to walk the grid in parallel
+   *                  when building the incidence of vertices and DoFs.
+   */
+  OswaldInterpolation(const GridViewType& grd_vw,
+                      const bool zero_boundary = true,
+                      const TraversalType* traversal = nullptr)
     : grid_view_(grd_vw)
     , zero_boundary_(zero_boundary)
+    , traversal_(traversal)
   {}
 
+  /**
+   * \brief Forgets the incidence of vertices and DoFs, which has to be called if the grid has been adapted without
+   *        changing the number of its entities and vertices (or the number of DoFs of the space).
+   */
+  void invalidate()
+  {
+    std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+    incidence_.reset();
+  }
+
   template< class SGP, class SV, class RGP, class RV >
   void apply(const ConstDiscreteFunction< Spaces::DG::FemBased< SGP, 1, FieldType, 1, 1 >, SV >&
                 source,
@@ -85,120 +286,51 @@ public:
   }
 
 private:
+  /**
+   * \brief Sets each DoF of range to the average of the source DoFs of its vertex (or to zero on the boundary, if
+   *        zero_boundary). Since each DoF belongs to exactly one vertex, all vertices are processed concurrently.
+   */
   template< class SourceType, class RangeType >
   void apply_dg_fem(const SourceType& source, RangeType& range) const
   {
-    // data structures we need
-    // * a map from a global vertex index to global DoF indices
-    //   given a vertex, one obtains a set of all global DoF ids, which are associated with this vertex
-    std::map< size_t, std::set< size_t > > global_vertex_id_to_global_DoF_id_map;
-    // * a map from a global DoF index to the global index of its associated vertex
-    std::vector< size_t > global_DoF_id_to_global_vertex_id_map(source.space().mapper().size());
-    // * a set to hold the global id of all boundary vertices
-    std::set< size_t > boundary_vertices;
-
-    const auto entity_it_end = grid_view_.template end< 0 >();
-    //walk the grid to create the maps explained above and to find the boundary vertices
-    for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
-      const auto& entity = *entity_it;
-      const size_t num_vertices = boost::numeric_cast< size_t >(entity.template count< dimDomain >());
-      const auto basis = source.space().base_function_set(entity);
-      if (basis.size() != num_vertices)
-        DUNE_THROW(Dune::Stuff::Exceptions::internal_error, "basis.size() = " << basis.size());
-
-      //loop over all vertices of the entitity, to find their associated global DoF indices
-      for (size_t local_vertex_id = 0; local_vertex_id < num_vertices; ++local_vertex_id) {
-        const auto vertex_ptr = entity.template subEntity< dimDomain >(boost::numeric_cast< int >(local_vertex_id));
-        const auto global_vertex_id = grid_view_.indexSet().index(*vertex_ptr);
-        const auto vertex = vertex_ptr->geometry().center();
-        // find the local basis function which corresponds to this vertex
-        const auto basis_values = basis.evaluate(entity.geometry().local(vertex));
-        if (basis_values.size() != num_vertices)
-          DUNE_THROW(Dune::Stuff::Exceptions::internal_error, "basis_values.size() = " << basis_values.size());
-        size_t ones = 0;
-        size_t zeros = 0;
-        size_t failures = 0;
-        size_t local_DoF_index = 0;
-        for (size_t ii = 0; ii < basis.size(); ++ii) {
-          if (std::abs(basis_values[ii][0] - 1.0) < 1e-14) {
-            local_DoF_index = ii;
-            ++ones;
-          } else if (std::abs(basis_values[ii][0] - 0.0) < 1e-14)
-            ++zeros;
-          else
-            ++failures;
-        }
-        if (ones != 1 || zeros != (basis.size() - 1) || failures > 0) {
-          std::stringstream ss;
-          ss << "ones = " << ones << ", zeros = " << zeros << ", failures = " << failures << ", num_vertices = "
-             << num_vertices << ", entity " << grid_view_.indexSet().index(entity)
-             << ", vertex " << local_vertex_id << ": [ " << vertex << "], ";
-          Stuff::Common::print(basis_values, "basis_values", ss);
-          DUNE_THROW(Dune::Stuff::Exceptions::internal_error, ss.str());
-        }
-        // now we know that the local DoF index of this vertex is ii
-        const size_t global_DoF_index = source.space().mapper().mapToGlobal(entity, local_DoF_index);
-        global_DoF_id_to_global_vertex_id_map[global_DoF_index] = global_vertex_id;
-        global_vertex_id_to_global_DoF_id_map[global_vertex_id].insert(global_DoF_index);
-      } //loop over all vertices
-
-      if (zero_boundary_) {
-        // in order to determine the boundary vertices, we need to
-        // loop over all intersections
-        const auto intersectionEndIt = grid_view_.iend(entity);
-        for (auto intersectionIt = grid_view_.ibegin(entity); intersectionIt != intersectionEndIt; ++intersectionIt) {
-          const auto& intersection = *intersectionIt;
-          if (intersection.boundary() && !intersection.neighbor()) {
-            const auto& intersection_geometry = intersection.geometry();
-            for (auto local_intersection_corner_id : DSC::valueRange(intersection_geometry.corners())) {
-              const auto global_intersection_corner = intersection_geometry.corner(local_intersection_corner_id);
-              // now, we need to find the entity's vertex this intersection's corner point equals to, so we
-              // loop over all vertices of the entity
-              for (size_t local_vertex_id = 0; local_vertex_id < num_vertices; ++local_vertex_id) {
-                const auto vertex_ptr = entity.template subEntity< dimDomain >(boost::numeric_cast< int >(local_vertex_id));
-                const auto global_vertex_id = grid_view_.indexSet().index(*vertex_ptr);
-                const auto vertex = vertex_ptr->geometry().center();
-                if (Stuff::Common::FloatCmp::eq(global_intersection_corner, vertex))
-                  boundary_vertices.insert(global_vertex_id);
-              } // loop over all vertices of the entity
-            } //loop over all intersection corners
-          } // if (intersection.boundary() && !intersection.neighbor())
-        } // loop over all intersections
-      } // if(zero_boundary)
-    } //walk the grid for the first time
-
-    // walk the grid for the second time
-    for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
-      const auto& entity = *entity_it;
-      const auto num_vertices = boost::numeric_cast< size_t >(entity.template count< dimDomain >());
-      // get the local functions
-      const auto local_source = source.local_discrete_function(entity);
-      const auto& local_source_DoF_vector = local_source->vector();
-
-      // * loop over all local DoFs
-      for (size_t local_DoF_id = 0; local_DoF_id < num_vertices; ++local_DoF_id) {
-      const size_t global_DoF_index = source.space().mapper().mapToGlobal(entity, local_DoF_id);
-      const size_t global_vertex_id = global_DoF_id_to_global_vertex_id_map[global_DoF_index];
-        // if we are on the domain boundary
-        if (zero_boundary_ && boundary_vertices.count(global_vertex_id)) {
-          // set the dof to zero (we have dirichlet zero)
-          range.vector().set_entry(global_DoF_index, FieldType(0));
-        } else {
-          // do the oswald projection
-          const size_t num_DoFS_per_vertex = global_vertex_id_to_global_DoF_id_map[global_vertex_id].size();
-          // * get the source DoF
-          const FieldType source_DoF_value = local_source_DoF_vector.get(local_DoF_id);
-          // * and add it to all target DoFs
-          for (size_t target_global_DoF_id : global_vertex_id_to_global_DoF_id_map[global_vertex_id])
-            range.vector().add_to_entry(target_global_DoF_id, source_DoF_value / num_DoFS_per_vertex);
-        } // if (boundary_vertices.find(global_vertex_id))
-      } // loop over all local DoFs
-    } // walk the grid for the second time
-  } // ... apply(...)
+    const auto incidence_ptr = this->incidence(source.space());
+    const auto& incidence = *incidence_ptr;
+    const auto& source_vector = source.vector();
+    auto& range_vector = range.vector();
+    range_vector *= 0.0;
+    incidence.for_each_vertex([&](const size_t vv) {
+      const auto DoFs_begin = incidence.vertex_DoFs_begin(vv);
+      const auto DoFs_end = incidence.vertex_DoFs_end(vv);
+      if (DoFs_begin == DoFs_end || (zero_boundary_ && incidence.boundary(vv)))
+        return;
+      FieldType average(0);
+      for (auto DoF = DoFs_begin; DoF != DoFs_end; ++DoF)
+        average += source_vector.get_entry(*DoF);
+      average /= FieldType(DoFs_end - DoFs_begin);
+      for (auto DoF = DoFs_begin; DoF != DoFs_end; ++DoF)
+        range_vector.set_entry(*DoF, average);
+    });
+  } // ... apply_dg_fem(...)
 
+  /**
+   * \brief The incidence of the vertices of the grid view and the DoFs of space, which is built on first use and kept
+   *        for all subsequent applications until the space or the size of the grid view changes, \sa invalidate().
+   * \note  Returns a shared pointer, since a concurrent application to another space may replace the incidence.
+   */
+  template< class SpaceType >
+  std::shared_ptr< const internal::OswaldIncidence > incidence(const SpaceType& space) const
+  {
+    std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+    if (!incidence_ || !incidence_->fits(grid_view_, space))
+      incidence_ = std::make_shared< const internal::OswaldIncidence >(grid_view_, space, traversal_);
+    return incidence_;
+  } // ... incidence(...)
 
   const GridViewType& grid_view_;
   const bool zero_boundary_;
+  const TraversalType* const traversal_;
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr< const internal::OswaldIncidence > incidence_;
 }; // class OswaldInterpolation
 
 
@@ -6,11 +6,20 @@
 #ifndef DUNE_GDT_OPERATORS_PROJECTIONS_HH
 #define DUNE_GDT_OPERATORS_PROJECTIONS_HH
 
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <limits>
 
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
 #include <dune/common/fvector.hh>
 
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/stuff/common/parallel/threadstorage.hh>
 #include <dune/stuff/common/type_utils.hh>
 #include <dune/stuff/common/vector.hh>
 #include <dune/stuff/functions/interfaces.hh>
@@ -21,6 +30,7 @@
 #include <dune/stuff/la/solver.hh>
 
 #include <dune/gdt/exceptions.hh>
+#include <dune/gdt/assembler/traversal.hh>
 #include <dune/gdt/discretefunction/default.hh>
 #include <dune/gdt/spaces/cg/interface.hh>
 #include <dune/gdt/spaces/dg/interface.hh>
@@ -124,6 +134,54 @@ public:
 }; // class DirichletProjectionLocalizableTraits
 
 
+/**
+ * \brief Computes the Cholesky factorization L L^T of the upper left size x size block of the symmetric positive
+ *        definite matrix in place, where L is stored in the lower triangle. Returns false if matrix is not positive
+ *        definite.
+ */
+template< class FieldType >
+bool cholesky_factorize(Dune::DynamicMatrix< FieldType >& matrix, const size_t size)
+{
+  for (size_t jj = 0; jj < size; ++jj) {
+    FieldType diagonal = matrix[jj][jj];
+    for (size_t kk = 0; kk < jj; ++kk)
+      diagonal -= matrix[jj][kk] * matrix[jj][kk];
+    if (!(diagonal > FieldType(0)))
+      return false;
+    matrix[jj][jj] = std::sqrt(diagonal);
+    for (size_t ii = jj + 1; ii < size; ++ii) {
+      FieldType value = matrix[ii][jj];
+      for (size_t kk = 0; kk < jj; ++kk)
+        value -= matrix[ii][kk] * matrix[jj][kk];
+      matrix[ii][jj] = value / matrix[jj][jj];
+    }
+  }
+  return true;
+} // ... cholesky_factorize(...)
+
+
+/**
+ * \brief Solves L L^T x = rhs in place, where L is the factor computed by cholesky_factorize().
+ */
+template< class FieldType >
+void cholesky_solve(const Dune::DynamicMatrix< FieldType >& factor,
+                    const size_t size,
+                    Dune::DynamicVector< FieldType >& rhs)
+{
+  for (size_t ii = 0; ii < size; ++ii) {
+    for (size_t kk = 0; kk < ii; ++kk)
+      rhs[ii] -= factor[ii][kk] * rhs[kk];
+    rhs[ii] /= factor[ii][ii];
+  }
+  for (size_t ii = size; ii > 0; --ii) {
+    const size_t row = ii - 1;
+    for (size_t kk = ii; kk < size; ++kk)
+      rhs[row] -= factor[kk][row] * rhs[kk];
+    rhs[row] /= factor[row][row];
+  }
+} // ... cholesky_solve(...)
+
+
 } // namespace internal
 
 
@@ -213,9 +271,17 @@ private:
   static const size_t                                           dimDomain = GridViewType::dimension;
 
 public:
-  L2Projection(const GridViewType& grid_view, const size_t over_integrate = 0)
+  typedef SpaceFillingCurveTraversal< GridViewType >            TraversalType;
+
+  /**
+   * \param traversal If given (has to outlive this operator), the grid is walked in this order.
+   */
+  L2Projection(const GridViewType& grid_view,
+               const size_t over_integrate = 0,
+               const TraversalType* traversal = nullptr)
     : grid_view_(grid_view)
     , over_integrate_(over_integrate)
+    , traversal_(traversal)
   {}
 
   /**
@@ -244,7 +310,7 @@ private:
                       const Stuff::LocalizableFunctionInterface< EntityType, DomainFieldType, dimDomain, R, dimRange, 1 >& source,
                       DiscreteFunction< S, V >& range) const
   {
-    apply_local_l2_projection(source, range);
+    apply_local_l2_projection(source, range, std::true_type());
   }
 
   template< class T, class R, size_t dimRange, class S, class V >
@@ -252,7 +318,7 @@ private:
                       const Stuff::LocalizableFunctionInterface< EntityType, DomainFieldType, dimDomain, R, dimRange, 1 >& source,
                       DiscreteFunction< S, V >& range) const
   {
-    apply_local_l2_projection(source, range);
+    apply_local_l2_projection(source, range, std::true_type());
   }
 
   template< class T, class R, size_t dimRange, class S, class V >
@@ -260,7 +326,7 @@ private:
                       const Stuff::LocalizableFunctionInterface< EntityType, DomainFieldType, dimDomain, R, dimRange, 1 >& source,
                       DiscreteFunction< S, V >& range) const
   {
-    apply_local_l2_projection(source, range);
+    apply_local_l2_projection(source, range, std::false_type());
   }
 
 #if HAVE_DUNE_GRID_MULTISCALE
@@ -279,63 +345,170 @@ private:
 #endif // HAVE_DUNE_GRID_MULTISCALE
 
 private:
+  /**
+   * \brief The temporary storage of the local projections, one per thread which is reused for all entities.
+   *
+   *        Also holds the factorized mass matrices on the reference elements, \sa reference_mass_factor().
+   */
+  template< class RangeType >
+  struct LocalStorage
+  {
+    // (geometry type, size of the basis, order of the basis, over_integrate)
+    typedef std::tuple< size_t, size_t, size_t, size_t > KeyType;
+
+    std::vector< RangeType > basis_values;
+    Dune::DynamicMatrix< FieldType > local_matrix;
+    Dune::DynamicVector< FieldType > local_vector;
+    Dune::DynamicVector< size_t > global_indices;
+    std::map< KeyType, Dune::DynamicMatrix< FieldType > > reference_mass_factors;
+  }; // struct LocalStorage
+
+  /**
+   * \brief Solves the local problems of DG and FV spaces in parallel (if TBB is available), \sa
+   *        GDT::internal::parallel_for_each_entity().
+   *
+   *        Since the DoFs of these spaces belong to exactly one entity, no two threads write into the same DoF. Since
+   *        their bases are the same reference basis on each entity, the local mass matrices on affine entities are
+   *        the mass matrix on the reference element scaled by the constant integration element, so we factorize the
+   *        latter only once, \sa reference_mass_factor().
+   */
   template< class SourceType, class RangeFunctionType >
-  void apply_local_l2_projection(const SourceType& source, RangeFunctionType& range) const
+  void apply_local_l2_projection(const SourceType& source, RangeFunctionType& range, std::true_type) const
   {
+    typedef typename RangeFunctionType::SpaceType SpaceType;
     typedef typename RangeFunctionType::RangeType RangeType;
-    typedef typename Stuff::LA::Container< FieldType, Stuff::LA::default_dense_backend >::MatrixType LocalMatrixType;
-    typedef typename Stuff::LA::Container< FieldType, Stuff::LA::default_dense_backend >::VectorType LocalVectorType;
-    // clear
+    static DS::PerThreadValue< LocalStorage< RangeType > > storages;
     range.vector() *= 0.0;
-    // walk the grid
+    auto& vector = range.vector();
+    GDT::internal::parallel_for_each_entity_with_space(grid_view_, traversal_, range.space(),
+                                                       [&](const SpaceType& space, const EntityType& entity) {
+      project_locally< true >(space, source, entity, *storages, vector);
+    });
+  } // ... apply_local_l2_projection(...)
+
+  /**
+   * \brief Solves the local problems of all other spaces (e.g. RT spaces) one after another, assembling the full local
+   *        mass matrix on each entity.
+   */
+  template< class SourceType, class RangeFunctionType >
+  void apply_local_l2_projection(const SourceType& source, RangeFunctionType& range, std::false_type) const
+  {
+    typedef typename RangeFunctionType::RangeType RangeType;
+    static DS::PerThreadValue< LocalStorage< RangeType > > storages;
+    range.vector() *= 0.0;
+    GDT::internal::for_each_entity(grid_view_, traversal_, [&](const EntityType& entity) {
+      project_locally< false >(range.space(), source, entity, *storages, range.vector());
+    });
+  } // ... apply_local_l2_projection(...)
+
+  /**
+   * \brief Computes and sets the DoFs of the L2 projection of source on entity, without any allocation once storage
+   *        has grown to the size of the largest local basis.
+   *
+   *        The local mass matrix is factorized by a Cholesky decomposition, if use_reference_mass is true and the
+   *        geometry of entity is affine the cached factor of the reference element is used instead, where the
+   *        integration element (which would scale the mass matrix and the right hand side alike) is dropped.
+   */
+  template< bool use_reference_mass, class SpaceType, class SourceType, class RangeType, class VectorType >
+  void project_locally(const SpaceType& space,
+                       const SourceType& source,
+                       const EntityType& entity,
+                       LocalStorage< RangeType >& storage,
+                       VectorType& vector) const
+  {
+    // prepare
+    const auto local_basis = space.base_function_set(entity);
+    const auto local_source = source.local_function(entity);
+    const size_t size = local_basis.size();
+    if (storage.local_matrix.rows() < size)
+      storage.local_matrix.resize(size, size, FieldType(0));
+    if (storage.local_vector.size() < size)
+      storage.local_vector.resize(size);
+    if (storage.global_indices.size() < space.mapper().maxNumDofs())
+      storage.global_indices.resize(space.mapper().maxNumDofs());
+    auto& local_matrix = storage.local_matrix;
+    auto& local_vector = storage.local_vector;
+    const auto geometry = entity.geometry();
+    const bool reference_mass = use_reference_mass && geometry.affine();
+    // has to be obtained before the basis is evaluated below, since it may evaluate the basis itself
+    const auto* factor = reference_mass ? &reference_mass_factor(entity, local_basis, storage) : &local_matrix;
+    for (size_t ii = 0; ii < size; ++ii) {
+      local_vector[ii] = FieldType(0);
+      if (!reference_mass)
+        for (size_t jj = 0; jj <= ii; ++jj)
+          local_matrix[ii][jj] = FieldType(0);
+    }
+    // create quadrature
+    const size_t integrand_order = std::max(local_source->order(), local_basis.order()) + local_basis.order();
+    const auto& quadrature = QuadratureRules< DomainFieldType, dimDomain >::rule(
+          entity.type(), boost::numeric_cast< int >(integrand_order + over_integrate_));
+    // evaluate the basis at all quadrature points at once
+    local_basis.evaluate_all(quadrature, storage.basis_values);
+    // loop over all quadrature points
     RangeType source_value(0);
-    std::vector< RangeType > basis_values(range.space().mapper().maxNumDofs(), RangeType(0));
-    const auto entity_it_end = grid_view_.template end< 0 >();
-    for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
-      // prepare
-      const auto& entity = *entity_it;
-      const auto local_basis = range.space().base_function_set(entity);
-      const auto local_source = source.local_function(entity);
-      auto local_range = range.local_discrete_function(entity);
-      LocalMatrixType local_matrix(local_basis.size(), local_basis.size(), FieldType(0));
-      LocalVectorType local_vector(local_basis.size(), FieldType(0));
-      LocalVectorType local_DoFs(local_basis.size(), FieldType(0));
-      // create quadrature
-      const size_t integrand_order = std::max(local_source->order(), local_basis.order()) + local_basis.order();
-      const auto& quadrature = QuadratureRules< DomainFieldType, dimDomain >::rule(
-            entity.type(), boost::numeric_cast< int >(integrand_order + over_integrate_));
-      // loop over all quadrature points
-      for (const auto& quadrature_point : quadrature) {
-        const auto local_point = quadrature_point.position();
-        const auto quadrature_weight = quadrature_point.weight();
-        const auto integration_element = entity.geometry().integrationElement(local_point);
-        // evaluate
-        local_basis.evaluate(local_point, basis_values);
-        local_source->evaluate(local_point, source_value);
-        // compute integrals
-        for (size_t ii = 0; ii < local_basis.size(); ++ii) {
-          local_vector[ii] += integration_element * quadrature_weight * (source_value * basis_values[ii]);
-          for (size_t jj = 0; jj < local_basis.size(); ++jj) {
-            local_matrix.add_to_entry(ii,
-                                      jj,
-                                      integration_element * quadrature_weight * (basis_values[ii] * basis_values[jj]));
-          }
-        }
-      } // loop over all quadrature points
-      // compute local DoFs
-      try {
-        Stuff::LA::Solver< LocalMatrixType >(local_matrix).apply(local_vector, local_DoFs);
-      } catch (Stuff::Exceptions::linear_solver_failed& ee) {
-        DUNE_THROW(Exceptions::projection_error,
-                   "L2 projection failed because a local matrix could not be inverted!\n\n"
-                   << "This was the original error: " << ee.what());
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      const auto local_point = quadrature_point.position();
+      const FieldType weight = reference_mass ? FieldType(quadrature_point.weight())
+                                              : geometry.integrationElement(local_point) * quadrature_point.weight();
+      const RangeType* values = &storage.basis_values[qq * size];
+      local_source->evaluate(local_point, source_value);
+      // compute integrals (only the lower triangle of the symmetric mass matrix is required)
+      for (size_t ii = 0; ii < size; ++ii) {
+        local_vector[ii] += weight * (source_value * values[ii]);
+        if (!reference_mass)
+          for (size_t jj = 0; jj <= ii; ++jj)
+            local_matrix[ii][jj] += weight * (values[ii] * values[jj]);
       }
-      // set local DoFs
-      auto local_range_vector = local_range->vector();
-      for (size_t ii = 0; ii < local_range_vector.size(); ++ii)
-        local_range_vector.set(ii, local_DoFs[ii]);
-    } // walk the grid
-  } // ... apply_local_l2_projection(...)
+      ++qq;
+    } // loop over all quadrature points
+    // compute local DoFs
+    if (!reference_mass && !internal::cholesky_factorize(local_matrix, size))
+      DUNE_THROW(Exceptions::projection_error,
+                 "L2 projection failed because a local matrix could not be inverted!");
+    internal::cholesky_solve(*factor, size, local_vector);
+    // set local DoFs
+    space.mapper().globalIndices(entity, storage.global_indices);
+    for (size_t ii = 0; ii < size; ++ii)
+      vector.set_entry(storage.global_indices[ii], local_vector[ii]);
+  } // ... project_locally(...)
+
+  /**
+   * \brief Returns the Cholesky factor of the mass matrix of local_basis on the reference element of entity, which is
+   *        computed on first use and cached in storage.
+   * \note  Only valid for bases which are the same reference basis on each entity.
+   */
+  template< class BasisType, class RangeType >
+  const Dune::DynamicMatrix< FieldType >& reference_mass_factor(const EntityType& entity,
+                                                               const BasisType& local_basis,
+                                                               LocalStorage< RangeType >& storage) const
+  {
+    const size_t size = local_basis.size();
+    const auto key = std::make_tuple(size_t(GlobalGeometryTypeIndex::index(entity.type())),
+                                     size,
+                                     size_t(local_basis.order()),
+                                     over_integrate_);
+    const auto result = storage.reference_mass_factors.find(key);
+    if (result != storage.reference_mass_factors.end())
+      return result->second;
+    const auto& quadrature = QuadratureRules< DomainFieldType, dimDomain >::rule(
+          entity.type(), boost::numeric_cast< int >(2*local_basis.order() + over_integrate_));
+    local_basis.evaluate_all(quadrature, storage.basis_values);
+    Dune::DynamicMatrix< FieldType > mass(size, size, FieldType(0));
+    size_t qq = 0;
+    for (const auto& quadrature_point : quadrature) {
+      const FieldType weight = quadrature_point.weight();
+      const RangeType* values = &storage.basis_values[qq * size];
+      for (size_t ii = 0; ii < size; ++ii)
+        for (size_t jj = 0; jj <= ii; ++jj)
+          mass[ii][jj] += weight * (values[ii] * values[jj]);
+      ++qq;
+    }
+    if (!internal::cholesky_factorize(mass, size))
+      DUNE_THROW(Exceptions::projection_error,
+                 "L2 projection failed because a local matrix could not be inverted!");
+    return storage.reference_mass_factors.emplace(key, std::move(mass)).first->second;
+  } // ... reference_mass_factor(...)
 
   template< class SourceType, class RangeFunctionType >
   void apply_global_l2_projection(const SourceType& source, RangeFunctionType& range) const
@@ -351,9 +524,7 @@ private:
     typedef typename RangeFunctionType::LocalfunctionType::RangeType RangeType;
     RangeType source_value(0);
     std::vector< RangeType > basis_values(range.space().mapper().maxNumDofs(), RangeType(0));
-    const auto entity_it_end = grid_view_.template end< 0 >();
-    for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
-      const auto& entity = *entity_it;
+    GDT::internal::for_each_entity(grid_view_, traversal_, [&](const EntityType& entity) {
       const auto local_source = source.local_function(entity);
       const auto basis = range.space().base_function_set(entity);
       // do a volume quadrature
@@ -381,7 +552,7 @@ private:
           }
         }
       } // do a volume quadrature
-    } // walk the grid
+    }); // walk the grid
 
     // solve
     try {
@@ -395,6 +566,7 @@ private:
 
   const GridViewType& grid_view_;
   const size_t over_integrate_;
+  const TraversalType* const traversal_;
 }; // class L2Projection
 
 
@@ -6,6 +6,7 @@
 #ifndef DUNE_GDT_OPERATORS_PROLONGATIONS_HH
 #define DUNE_GDT_OPERATORS_PROLONGATIONS_HH
 
+#include <memory>
 #include <vector>
 #include <limits>
 
@@ -23,13 +24,13 @@
 
 #include <dune/geometry/quadraturerules.hh>
 
-#include <dune/stuff/grid/search.hh>
-
 #include <dune/gdt/exceptions.hh>
 #include <dune/gdt/discretefunction/default.hh>
 #include <dune/gdt/spaces/cg/fem.hh>
 #include <dune/gdt/spaces/cg/pdelab.hh>
 
+#include "source-search.hh"
+
 
 namespace Dune {
 namespace GDT {
@@ -70,8 +71,13 @@ class L2Prolongation
   static const size_t dimDomain = GridViewType::dimension;
 
 public:
-  L2Prolongation(const GridViewType& grid_view)
+  /**
+   * \param search How to find the source entities, ProlongationSearch::hierarchical is much faster if the grid view
+   *               of the source is a coarser view of the same grid.
+   */
+  L2Prolongation(const GridViewType& grid_view, const ProlongationSearch search = ProlongationSearch::spatial)
     : grid_view_(grid_view)
+    , search_(search)
   {}
 
   // Source: Spaces::CG::FemBased
@@ -130,9 +136,41 @@ public:
     prolong_onto_dg_fem_localfunctions_wrapper(source, range);
   }
 
+  /**
+   * \brief Prolongs source onto range using the given search in the grid view of source (ignoring the search given
+   *        on construction), e.g. a BoundingBoxSourceSearch which is built once and reused for all sources on the same
+   *        grid view.
+   * \note  Does not check the combination of spaces at compile time.
+   */
+  template< class SourceType, class RangeType, class SearchType >
+  void apply(const SourceType& source, RangeType& range, const SearchType& search) const
+  {
+    prolong_onto_dg_fem_localfunctions_wrapper(source, range, search);
+  }
+
 private:
   template< class SourceFunctionType, class RangeFunctionType >
   void prolong_onto_dg_fem_localfunctions_wrapper(const SourceFunctionType& source, RangeFunctionType& range) const
+  {
+    typedef typename SourceFunctionType::SpaceType::GridViewType SourceGridViewType;
+    switch (search_) {
+      case ProlongationSearch::hierarchical: {
+        const HierarchicalSourceSearch< SourceGridViewType > search(source.space().grid_view());
+        prolong_onto_dg_fem_localfunctions_wrapper(source, range, search);
+        break;
+      }
+      case ProlongationSearch::spatial: {
+        const BoundingBoxSourceSearch< SourceGridViewType > search(source.space().grid_view());
+        prolong_onto_dg_fem_localfunctions_wrapper(source, range, search);
+        break;
+      }
+    }
+  } // ... prolong_onto_dg_fem_localfunctions_wrapper(...)
+
+  template< class SourceFunctionType, class RangeFunctionType, class SearchType >
+  void prolong_onto_dg_fem_localfunctions_wrapper(const SourceFunctionType& source,
+                                                  RangeFunctionType& range,
+                                                  const SearchType& search) const
   {
     typedef typename RangeFunctionType::DomainType DomainType;
     typedef typename RangeFunctionType::RangeType RangeType;
@@ -141,17 +179,17 @@ private:
         LocalMatrixType;
     typedef typename Stuff::LA::Container< RangeFieldType, Stuff::LA::default_dense_backend >::VectorType
         LocalVectorType;
+    typedef typename SearchType::LocatedPointsType LocatedPointsType;
     // clear
     range.vector() *= 0.0;
-    // create search in the source grid part
-    typedef typename SourceFunctionType::SpaceType::GridViewType SourceGridViewType;
-    typedef Stuff::Grid::EntityInlevelSearch< SourceGridViewType > EntitySearch;
-    EntitySearch entity_search(source.space().grid_view());
     // guess the polynomial order of the source by hoping that they are the same for all entities
     const size_t source_order = source.local_function(*source.space().grid_view().template begin< 0 >())->order();
     // walk the grid
     RangeType source_value(0);
     std::vector< RangeType > basis_values(range.space().mapper().maxNumDofs());
+    std::vector< DomainType > quadrature_points;
+    LocatedPointsType located_points;
+    std::vector< std::unique_ptr< typename SourceFunctionType::LocalfunctionType > > local_sources;
     const auto entity_it_end = grid_view_.template end< 0 >();
     for (auto entity_it = grid_view_.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
       // prepare
@@ -165,13 +203,15 @@ private:
       const auto integrand_order = std::max(source_order, local_basis.order()) + local_basis.order();
       const auto& quadrature = QuadratureRules< DomainFieldType, dimDomain >::rule(entity.type(),
                                                                                    boost::numeric_cast< int >(integrand_order));
-      // get global quadrature points
-      std::vector< DomainType > quadrature_points;
+      // find the source entities of all quadrature points and localize the source once on each of them
+      quadrature_points.clear();
       for (const auto& quadrature_point : quadrature)
-        quadrature_points.emplace_back(entity.geometry().global(quadrature_point.position()));
-      // get source entities
-      const auto source_entity_ptr_unique_ptrs = entity_search(quadrature_points);
-      assert(source_entity_ptr_unique_ptrs.size() >= quadrature_points.size());
+        quadrature_points.push_back(quadrature_point.position());
+      search.locate(entity, quadrature_points, located_points);
+      assert(located_points.local_points.size() == quadrature_points.size());
+      local_sources.clear();
+      for (const auto& source_entity : located_points.entities)
+        local_sources.emplace_back(source.local_function(source_entity));
       // loop over all quadrature points
       size_t pp = 0;
       for (const auto& quadrature_point : quadrature) {
@@ -179,13 +219,10 @@ private:
         const auto quadrature_weight = quadrature_point.weight();
         const auto integration_element = entity.geometry().integrationElement(local_point);
         // evaluate source
-        const auto& source_entity_ptr_unique_ptr = source_entity_ptr_unique_ptrs[pp];
-        if (source_entity_ptr_unique_ptr) {
-          const auto source_entity_ptr = *source_entity_ptr_unique_ptr;
-          const auto& source_entity = *source_entity_ptr;
-          const auto local_source = source.local_function(source_entity);
-          local_source->evaluate(source_entity.geometry().local(entity.geometry().global(local_point)), source_value);
-        } else
+        const size_t source_entity = located_points.entity_of_point[pp];
+        if (source_entity != LocatedPointsType::not_found)
+          local_sources[source_entity]->evaluate(located_points.local_points[pp], source_value);
+        else
           source_value *= 0.0;
         // evaluate
         local_basis.evaluate(local_point, basis_values);
@@ -217,6 +254,7 @@ private:
   } // ... prolong_onto_dg_fem_localfunctions_wrapper(...)
 
   const GridViewType& grid_view_;
+  const ProlongationSearch search_;
 }; // class L2Prolongation
 
 
@@ -240,8 +278,12 @@ public:
   typedef typename GridViewType::ctype DomainFieldType;
   static const size_t dimDomain = GridViewType::dimension;
 
-  LagrangeProlongation(const GridViewType& grid_view)
+  /**
+   * \param search How to find the source entities, \sa L2Prolongation.
+   */
+  LagrangeProlongation(const GridViewType& grid_view, const ProlongationSearch search = ProlongationSearch::spatial)
     : grid_view_(grid_view)
+    , search_(search)
   {}
 
   // Source: Spaces::CG::FemBased
@@ -300,61 +342,88 @@ public:
     redirect_to_appropriate_apply(source, range);
   }
 
+  /**
+   * \brief Prolongs source onto range using the given search in the grid view of source, \sa L2Prolongation::apply().
+   * \note  Does not check the combination of spaces at compile time.
+   */
+  template< class SourceType, class RangeType, class SearchType >
+  void apply(const SourceType& source, RangeType& range, const SearchType& search) const
+  {
+    redirect_to_appropriate_apply(source, range, search);
+  }
+
 private:
   template< class SourceType, class RangeType >
   void redirect_to_appropriate_apply(const SourceType& source, RangeType& range) const
   {
-    // create search in the source grid part
     typedef typename SourceType::SpaceType::GridViewType SourceGridViewType;
-    typedef Stuff::Grid::EntityInlevelSearch< SourceGridViewType > EntitySearch;
-    EntitySearch entity_search(source.space().grid_view());
+    switch (search_) {
+      case ProlongationSearch::hierarchical: {
+        const HierarchicalSourceSearch< SourceGridViewType > search(source.space().grid_view());
+        redirect_to_appropriate_apply(source, range, search);
+        break;
+      }
+      case ProlongationSearch::spatial: {
+        const BoundingBoxSourceSearch< SourceGridViewType > search(source.space().grid_view());
+        redirect_to_appropriate_apply(source, range, search);
+        break;
+      }
+    }
+  } // ... redirect_to_appropriate_apply(...)
+
+  template< class SourceType, class RangeType, class SearchType >
+  void redirect_to_appropriate_apply(const SourceType& source, RangeType& range, const SearchType& search) const
+  {
+    typedef typename SearchType::DomainType       DomainType;
+    typedef typename SearchType::LocatedPointsType LocatedPointsType;
     // set all range dofs to infinity
     const auto infinity = std::numeric_limits< typename RangeType::RangeFieldType >::infinity();
     for (size_t ii = 0; ii < range.vector().size(); ++ii)
       range.vector().set_entry(ii, infinity);
     // walk the grid
+    std::vector< DomainType > lagrange_points;
+    LocatedPointsType located_points;
+    auto local_source = source.rebindable_local_discrete_function();
     const auto entity_it_end = grid_view_.template end< 0 >();
     for (auto entity_it = grid_view_.template begin< 0 >();
          entity_it != entity_it_end;
          ++entity_it) {
       const auto& entity = *entity_it;
-      // get global lagrange point coordinates
+      // get local lagrange point coordinates
       const auto lagrange_point_set = range.space().lagrange_points(entity);
-      typedef FieldVector< typename SourceGridViewType::ctype, SourceGridViewType::dimension > DomainType;
-      std::vector< DomainType > lagrange_points(lagrange_point_set.size());
+      lagrange_points.resize(lagrange_point_set.size());
       for (size_t ii = 0; ii < lagrange_point_set.size(); ++ii)
-        lagrange_points[ii] = entity.geometry().global(lagrange_point_set[ii]);
+        lagrange_points[ii] = lagrange_point_set[ii];
       // get source entities
-      const auto source_entity_ptrs = entity_search(lagrange_points);
-      assert(source_entity_ptrs.size() == lagrange_points.size());
+      search.locate(entity, lagrange_points, located_points);
+      assert(located_points.local_points.size() == lagrange_points.size());
       // get range
       auto local_range = range.local_discrete_function(entity);
       auto local_range_DoF_vector = local_range->vector();
       // do the actual work (see below)
-      apply_local(source, lagrange_points, source_entity_ptrs, local_range_DoF_vector);
+      apply_local(local_source, located_points, local_range_DoF_vector);
     } // walk the grid
   } // ... redirect_to_appropriate_apply(...)
 
-  template< class SourceType, class LagrangePointsType, class EntityPointers, class LocalDoFVectorType >
-  void apply_local(const SourceType& source,
-                   const LagrangePointsType& lagrange_points,
-                   const EntityPointers& source_entity_ptr_unique_ptrs,
+  template< class LocalSourceType, class LocatedPointsType, class LocalDoFVectorType >
+  void apply_local(LocalSourceType& local_source,
+                   const LocatedPointsType& located_points,
                    LocalDoFVectorType& range_DoF_vector) const
   {
-    static const size_t dimRange = SourceType::dimRange;
+    static const size_t dimRange = LocalSourceType::SpaceType::dimRange;
+    // the source is only rebound if the source entity changes
+    size_t bound_source_entity = LocatedPointsType::not_found;
     size_t kk = 0;
-    assert(source_entity_ptr_unique_ptrs.size() >= lagrange_points.size());
-    for (size_t ii = 0; ii < lagrange_points.size(); ++ii) {
+    for (size_t ii = 0; ii < located_points.local_points.size(); ++ii) {
       if (std::isinf(range_DoF_vector.get(kk))) {
-        const auto& global_point = lagrange_points[ii];
         // evaluate source function
-        const auto& source_entity_ptr_unique_ptr = source_entity_ptr_unique_ptrs[ii];
-        if (source_entity_ptr_unique_ptr) {
-          const auto source_entity_ptr = *source_entity_ptr_unique_ptr;
-          const auto& source_entity = *source_entity_ptr;
-          const auto local_source_point = source_entity.geometry().local(global_point);
-          const auto local_source = source.local_function(source_entity);
-          const auto source_value = local_source->evaluate(local_source_point);
+        const size_t source_entity = located_points.entity_of_point[ii];
+        if (source_entity != LocatedPointsType::not_found) {
+          if (source_entity != bound_source_entity) {
+            local_source.bind(located_points.entities[source_entity]);
+            bound_source_entity = source_entity;
+          }
+          const auto source_value = local_source.evaluate(located_points.local_points[ii]);
           for (size_t jj = 0; jj < dimRange; ++jj, ++kk)
             range_DoF_vector.set(kk, source_value[jj]);
         } else
@@ -367,6 +436,7 @@ private:
   } // ... apply_local(...)
 
   const GridViewType& grid_view_;
+  const ProlongationSearch search_;
 }; // class LagrangeProlongation
 
 
@@ -377,9 +447,12 @@ public:
   typedef typename GridViewType::ctype DomainFieldType;
   static const size_t dimDomain = GridViewType::dimension;
 
-  Prolongation(const GridViewType& grid_view)
-    : l2_prolongation_operator_(grid_view)
-    , lagrange_prolongation_operator_(grid_view)
+  /**
+   * \param search How to find the source entities, \sa L2Prolongation.
+   */
+  Prolongation(const GridViewType& grid_view, const ProlongationSearch search = ProlongationSearch::spatial)
+    : l2_prolongation_operator_(grid_view, search)
+    , lagrange_prolongation_operator_(grid_view, search)
   {}
 
   template< class SourceType, class RangeType >
@@ -0,0 +1,380 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_OPERATORS_SOURCE_SEARCH_HH
+#define DUNE_GDT_OPERATORS_SOURCE_SEARCH_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/gdt/exceptions.hh>
+
+namespace Dune {
+namespace GDT {
+namespace Operators {
+
+
+/**
+ * \brief How the prolongations find the entities of the source grid view which contain the points of an entity of the
+ *        range grid view.
+ */
+enum class ProlongationSearch
+{
+    /// Searches the source grid view for each point, works for arbitrary grids, \sa BoundingBoxSourceSearch.
+    spatial
+    /**
+     * Uses the ancestor (\sa father()) of each range entity in the source grid view, which requires the source grid
+     * view to be coarser than the range grid view of the same grid, \sa HierarchicalSourceSearch.
+     */
+  , hierarchical
+}; // enum class ProlongationSearch
+
+
+/**
+ * \brief The result of a search in the source grid view for the points of one range entity: for each point the source
+ *        entity (as a position in entities, or not_found) and the local coordinates of the point in it.
+ *
+ *        Each source entity is contained only once, so that the source can be localized once per entity. Meant to be
+ *        reused for all range entities, to keep the storage.
+ */
+template< class EntityImp, class DomainImp >
+struct LocatedPoints
+{
+  typedef EntityImp EntityType;
+  typedef DomainImp DomainType;
+  static const size_t not_found = std::numeric_limits< size_t >::max();
+
+  void clear()
+  {
+    entities.clear();
+    entity_of_point.clear();
+    local_points.clear();
+  }
+
+  std::vector< EntityType > entities;
+  std::vector< size_t > entity_of_point;
+  std::vector< DomainType > local_points;
+}; // struct LocatedPoints
+
+template< class EntityImp, class DomainImp >
+const size_t LocatedPoints< EntityImp, DomainImp >::not_found;
+
+
+/**
+ * \brief Finds the source entities of arbitrary points by a uniform grid of buckets over the bounding boxes of the
+ *        entities of the source grid view.
+ *
+ *        The buckets are chosen to hold about one entity each and store the entities whose bounding box overlaps them
+ *        as compressed rows, so locating a point only checks the few candidates of its bucket (first by their bounding
+ *        box, then by their reference element). Since the points of one range entity usually lie in few source
+ *        entities, the source entities already found for a range entity are tried first.
+ *
+ *        Building the buckets requires one walk over the source grid view. Afterwards, locate() does not modify this
+ *        search, so it may be used by several threads at once and reused for all prolongations from the same source
+ *        grid view (\sa L2Prolongation::apply() and LagrangeProlongation::apply()). It works for arbitrary
+ *        (non-nested) grid views, as long as each entity is contained in the convex hull of its corners, which holds
+ *        for all affine and multilinear geometries.
+ */
+template< class SourceGridViewImp >
+class BoundingBoxSourceSearch
+{
+public:
+  typedef SourceGridViewImp                                        SourceGridViewType;
+  typedef typename SourceGridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename SourceGridViewType::ctype                       DomainFieldType;
+  static const size_t                                              dimDomain = SourceGridViewType::dimension;
+  typedef FieldVector< DomainFieldType, dimDomain >                DomainType;
+  typedef LocatedPoints< EntityType, DomainType >                  LocatedPointsType;
+private:
+  typedef typename EntityType::EntitySeed EntitySeedType;
+
+public:
+  explicit BoundingBoxSourceSearch(const SourceGridViewType& source_grid_view)
+    : source_grid_view_(source_grid_view)
+    , lower_(std::numeric_limits< DomainFieldType >::max())
+    , upper_(std::numeric_limits< DomainFieldType >::lowest())
+  {
+    // the bounding boxes of all entities
+    const size_t num_entities = source_grid_view_.indexSet().size(0);
+    seeds_.reserve(num_entities);
+    lower_corners_.reserve(num_entities);
+    upper_corners_.reserve(num_entities);
+    for (const auto& entity : DSC::entityRange(source_grid_view_)) {
+      const auto geometry = entity.geometry();
+      DomainType lower = geometry.corner(0);
+      DomainType upper = lower;
+      for (int cc = 1; cc < geometry.corners(); ++cc) {
+        const auto corner = geometry.corner(cc);
+        for (size_t kk = 0; kk < dimDomain; ++kk) {
+          lower[kk] = std::min(lower[kk], corner[kk]);
+          upper[kk] = std::max(upper[kk], corner[kk]);
+        }
+      }
+      for (size_t kk = 0; kk < dimDomain; ++kk) {
+        lower_[kk] = std::min(lower_[kk], lower[kk]);
+        upper_[kk] = std::max(upper_[kk], upper[kk]);
+      }
+      seeds_.push_back(entity.seed());
+      lower_corners_.push_back(lower);
+      upper_corners_.push_back(upper);
+    }
+    if (seeds_.empty())
+      return;
+    // about one entity per bucket, with (roughly) cubic buckets
+    DomainFieldType volume = 1;
+    size_t extended_dimensions = 0;
+    for (size_t kk = 0; kk < dimDomain; ++kk)
+      if (upper_[kk] > lower_[kk]) {
+        volume *= upper_[kk] - lower_[kk];
+        ++extended_dimensions;
+      }
+    const DomainFieldType bucket_width = extended_dimensions > 0
+                                         ? std::pow(volume / DomainFieldType(seeds_.size()),
+                                                    DomainFieldType(1) / DomainFieldType(extended_dimensions))
+                                         : DomainFieldType(1);
+    tolerance_ = 0;
+    size_t num_buckets = 1;
+    for (size_t kk = 0; kk < dimDomain; ++kk) {
+      const DomainFieldType extent = upper_[kk] - lower_[kk];
+      num_buckets_[kk] = std::max(size_t(1), size_t(std::ceil(extent / bucket_width - DomainFieldType(0.5))));
+      bucket_widths_[kk] = extent > 0 ? extent / DomainFieldType(num_buckets_[kk]) : DomainFieldType(1);
+      num_buckets *= num_buckets_[kk];
+      tolerance_ = std::max(tolerance_, DomainFieldType(1e-10) * extent);
+    }
+    // the entities of each bucket, as compressed rows
+    bucket_offsets_.assign(num_buckets + 1, 0);
+    for_each_bucket_of_entities([&](const size_t bucket, const size_t /*ee*/) { ++bucket_offsets_[bucket + 1]; });
+    std::partial_sum(bucket_offsets_.begin(), bucket_offsets_.end(), bucket_offsets_.begin());
+    bucket_entities_.resize(bucket_offsets_.back());
+    std::vector< size_t > positions(bucket_offsets_.begin(), bucket_offsets_.end() - 1);
+    for_each_bucket_of_entities([&](const size_t bucket, const size_t ee) {
+      bucket_entities_[positions[bucket]++] = ee;
+    });
+  } // BoundingBoxSourceSearch(...)
+
+  /**
+   * \param local_points The points in local coordinates of entity (which belongs to the range grid view).
+   */
+  template< class RangeEntityType >
+  void locate(const RangeEntityType& entity,
+              const std::vector< DomainType >& local_points,
+              LocatedPointsType& ret) const
+  {
+    ret.clear();
+    const auto geometry = entity.geometry();
+    DomainType local_point(0);
+    for (const auto& range_local_point : local_points) {
+      const DomainType global_point = geometry.global(range_local_point);
+      size_t position = LocatedPointsType::not_found;
+      for (size_t ee = 0; ee < ret.entities.size(); ++ee)
+        if (contains(ret.entities[ee], global_point, local_point)) {
+          position = ee;
+          break;
+        }
+      if (position == LocatedPointsType::not_found) {
+        const size_t bucket = find_bucket(global_point);
+        if (bucket != LocatedPointsType::not_found) {
+          for (size_t bb = bucket_offsets_[bucket]; bb < bucket_offsets_[bucket + 1]; ++bb) {
+            const size_t candidate = bucket_entities_[bb];
+            if (!box_contains(candidate, global_point))
+              continue;
+            const auto candidate_ptr = source_grid_view_.grid().entity(seeds_[candidate]);
+            const EntityType& candidate_entity = *candidate_ptr;
+            if (contains(candidate_entity, global_point, local_point)) {
+              ret.entities.push_back(candidate_entity);
+              position = ret.entities.size() - 1;
+              break;
+            }
+          }
+        }
+      }
+      ret.entity_of_point.push_back(position);
+      ret.local_points.push_back(position != LocatedPointsType::not_found ? local_point : DomainType(0));
+    }
+  } // ... locate(...)
+
+private:
+  /// \brief Calls functor(bucket, ee) for each bucket overlapped by the bounding box of each entity ee.
+  template< class FunctorType >
+  void for_each_bucket_of_entities(const FunctorType& functor) const
+  {
+    std::array< size_t, dimDomain > first;
+    std::array< size_t, dimDomain > last;
+    std::array< size_t, dimDomain > current;
+    for (size_t ee = 0; ee < seeds_.size(); ++ee) {
+      for (size_t kk = 0; kk < dimDomain; ++kk) {
+        first[kk] = bucket_coordinate(lower_corners_[ee][kk] - tolerance_, kk);
+        last[kk] = bucket_coordinate(upper_corners_[ee][kk] + tolerance_, kk);
+      }
+      current = first;
+      while (true) {
+        size_t bucket = 0;
+        for (size_t kk = dimDomain; kk > 0; --kk)
+          bucket = bucket * num_buckets_[kk - 1] + current[kk - 1];
+        functor(bucket, ee);
+        // next bucket within [first, last]
+        size_t kk = 0;
+        while (kk < dimDomain && current[kk] == last[kk]) {
+          current[kk] = first[kk];
+          ++kk;
+        }
+        if (kk == dimDomain)
+          break;
+        ++current[kk];
+      }
+    }
+  } // ... for_each_bucket_of_entities(...)
+
+  size_t bucket_coordinate(const DomainFieldType& coordinate, const size_t kk) const
+  {
+    const DomainFieldType relative = (coordinate - lower_[kk]) / bucket_widths_[kk];
+    if (!(relative > 0))
+      return 0;
+    return std::min(num_buckets_[kk] - 1, size_t(relative));
+  }
+
+  size_t find_bucket(const DomainType& global_point) const
+  {
+    if (seeds_.empty())
+      return LocatedPointsType::not_found;
+    size_t bucket = 0;
+    for (size_t kk = dimDomain; kk > 0; --kk) {
+      if (global_point[kk - 1] < lower_[kk - 1] - tolerance_ || global_point[kk - 1] > upper_[kk - 1] + tolerance_)
+        return LocatedPointsType::not_found;
+      bucket = bucket * num_buckets_[kk - 1] + bucket_coordinate(global_point[kk - 1], kk - 1);
+    }
+    return bucket;
+  } // ... find_bucket(...)
+
+  bool box_contains(const size_t ee, const DomainType& global_point) const
+  {
+    for (size_t kk = 0; kk < dimDomain; ++kk)
+      if (global_point[kk] < lower_corners_[ee][kk] - tolerance_
+          || global_point[kk] > upper_corners_[ee][kk] + tolerance_)
+        return false;
+    return true;
+  }
+
+  static bool contains(const EntityType& entity, const DomainType& global_point, DomainType& local_point)
+  {
+    local_point = entity.geometry().local(global_point);
+    return ReferenceElements< DomainFieldType, dimDomain >::general(entity.type()).checkInside(local_point);
+  }
+
+  const SourceGridViewType source_grid_view_;
+  DomainType lower_;
+  DomainType upper_;
+  DomainFieldType tolerance_;
+  std::array< size_t, dimDomain > num_buckets_;
+  std::array< DomainFieldType, dimDomain > bucket_widths_;
+  std::vector< EntitySeedType > seeds_;
+  std::vector< DomainType > lower_corners_;
+  std::vector< DomainType > upper_corners_;
+  std::vector< size_t > bucket_offsets_;
+  std::vector< size_t > bucket_entities_;
+}; // class BoundingBoxSourceSearch
+
+
+/**
+ * \brief Finds the source entity of all points of a range entity by walking up the grid hierarchy (\sa father())
+ *        until an entity of the source grid view is reached, without any spatial search.
+ *
+ *        The range entity and all its ancestors up to the source entity are visited once per range entity, and the
+ *        chain of their geometryInFather() transforms is composed to a single affine map (if all of them are affine,
+ *        which they are for the usual refinement rules), which then maps all points into the source entity at once.
+ *        This requires both grid views to belong to the same grid, where the source grid view is coarser (e.g. a level
+ *        grid view and a finer level or the leaf grid view), and throws an Exceptions::prolongation_error otherwise.
+ *        locate() does not modify this search, so it may be used by several threads at once.
+ */
+template< class SourceGridViewImp >
+class HierarchicalSourceSearch
+{
+public:
+  typedef SourceGridViewImp                                        SourceGridViewType;
+  typedef typename SourceGridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename SourceGridViewType::ctype                       DomainFieldType;
+  static const size_t                                              dimDomain = SourceGridViewType::dimension;
+  typedef FieldVector< DomainFieldType, dimDomain >                DomainType;
+  typedef LocatedPoints< EntityType, DomainType >                  LocatedPointsType;
+
+  explicit HierarchicalSourceSearch(const SourceGridViewType& source_grid_view)
+    : source_grid_view_(source_grid_view)
+  {}
+
+  /**
+   * \param local_points The points in local coordinates of entity (which belongs to the range grid view).
+   */
+  void locate(const EntityType& entity, const std::vector< DomainType >& local_points, LocatedPointsType& ret) const
+  {
+    ret.clear();
+    // map the origin and the unit vectors into the ancestor, which determines the composed map if it is affine
+    std::array< DomainType, dimDomain + 1 > corners;
+    for (size_t kk = 0; kk <= dimDomain; ++kk) {
+      corners[kk] = DomainType(0);
+      if (kk > 0)
+        corners[kk][kk - 1] = 1;
+    }
+    bool affine = true;
+    const auto& index_set = source_grid_view_.indexSet();
+    EntityType ancestor = entity;
+    while (!index_set.contains(ancestor)) {
+      if (!ancestor.hasFather())
+        DUNE_THROW(Exceptions::prolongation_error,
+                   "The given entity has no ancestor in the source grid view (which has to be coarser than the grid "
+                   << "view of the entity)!");
+      const auto geometry_in_father = ancestor.geometryInFather();
+      affine = affine && geometry_in_father.affine();
+      for (auto& corner : corners)
+        corner = geometry_in_father.global(corner);
+      const auto father_ptr = ancestor.father();
+      ancestor = *father_ptr;
+    }
+    ret.entities.push_back(ancestor);
+    ret.entity_of_point.assign(local_points.size(), 0);
+    ret.local_points.resize(local_points.size());
+    if (affine) {
+      for (size_t kk = 1; kk <= dimDomain; ++kk)
+        corners[kk] -= corners[0];
+      for (size_t pp = 0; pp < local_points.size(); ++pp) {
+        auto& local_point = ret.local_points[pp];
+        local_point = corners[0];
+        for (size_t kk = 0; kk < dimDomain; ++kk)
+          local_point.axpy(local_points[pp][kk], corners[kk + 1]);
+      }
+    } else {
+      // map each point through the whole chain
+      for (size_t pp = 0; pp < local_points.size(); ++pp)
+        ret.local_points[pp] = local_points[pp];
+      EntityType current = entity;
+      while (!index_set.contains(current)) {
+        const auto geometry_in_father = current.geometryInFather();
+        for (auto& local_point : ret.local_points)
+          local_point = geometry_in_father.global(local_point);
+        const auto father_ptr = current.father();
+        current = *father_ptr;
+      }
+    }
+  } // ... locate(...)
+
+private:
+  const SourceGridViewType source_grid_view_;
+}; // class HierarchicalSourceSearch
+
+
+} // namespace Operators
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_OPERATORS_SOURCE_SEARCH_HH
@@ -37,6 +37,7 @@ class EllipticCG
       LocalOperatorType;
   typedef LocalAssembler::Codim0Matrix< LocalOperatorType >
       LocalAssemblerType;
+  typedef typename MatrixImp::ScalarType ScalarType;
 public:
   typedef internal::EllipticCGTraits
       < DiffusionFactorType, MatrixImp, SourceSpaceImp, RangeSpaceImp, GridViewImp, DiffusionTensorType > Traits;
@@ -167,6 +168,21 @@ public:
     AssemblerBaseType::assemble();
   }
 
+  /**
+   * \brief Computes range = A source, where A is the matrix of this operator, without assembling (or touching) the
+   *        matrix.
+   * \note  To apply the operator repeatedly without allocating a matrix at all, use EllipticCGMatrixFree.
+   * \sa    internal::MatrixFreeApplication
+   */
+  template< class S, class R >
+  void apply_matrix_free(const Stuff::LA::VectorInterface< S, ScalarType >& source,
+                         Stuff::LA::VectorInterface< R, ScalarType >& range) const
+  {
+    internal::MatrixFreeApplication< RangeSpaceType, SourceSpaceType, GridViewType >
+        application(this->range_space(), this->source_space(), OperatorBaseType::grid_view());
+    application.apply(local_operator_, source, range);
+  } // ... apply_matrix_free(...)
+
 private:
 
   void setup()
@@ -181,6 +197,85 @@ private:
 }; // class EllipticCG
 
 
+template< class DiffusionFactorType
+        , class SourceSpaceImp
+        , class RangeSpaceImp
+        , class GridViewImp
+        , class DiffusionTensorType >
+class EllipticCGMatrixFree
+{
+  static_assert(Stuff::is_localizable_function< DiffusionFactorType >::value,
+                "DiffusionFactorType has to be derived from Stuff::LocalizableFunctionInterface!");
+  static_assert(Stuff::is_localizable_function< DiffusionTensorType >::value,
+                "DiffusionTensorType has to be derived from Stuff::LocalizableFunctionInterface!");
+  static_assert(is_space< SourceSpaceImp >::value, "SourceSpaceImp has to be derived from SpaceInterface!");
+  static_assert(is_space< RangeSpaceImp >::value,  "RangeSpaceImp has to be derived from SpaceInterface!");
+  typedef LocalOperator::Codim0Integral< LocalEvaluation::Elliptic< DiffusionFactorType, DiffusionTensorType > >
+      LocalOperatorType;
+  typedef internal::MatrixFreeApplication< RangeSpaceImp, SourceSpaceImp, GridViewImp > ApplicationType;
+public:
+  typedef SourceSpaceImp                            SourceSpaceType;
+  typedef RangeSpaceImp                             RangeSpaceType;
+  typedef GridViewImp                               GridViewType;
+  typedef typename RangeSpaceType::RangeFieldType   ScalarType;
+  typedef typename ApplicationType::TraversalType   TraversalType;
+
+  /**
+   * \param traversal If given (has to outlive this operator), its partitions are used to walk the grid in parallel.
+   */
+  EllipticCGMatrixFree(const DiffusionFactorType& diffusion_factor,
+                       const DiffusionTensorType& diffusion_tensor,
+                       const SourceSpaceType& source_space,
+                       const RangeSpaceType& range_space,
+                       const GridViewType& grid_view,
+                       const TraversalType* traversal = nullptr)
+    : source_space_(source_space)
+    , range_space_(range_space)
+    , grid_view_(grid_view)
+    , local_operator_(diffusion_factor, diffusion_tensor)
+    , application_(range_space_, source_space_, grid_view_, traversal)
+  {}
+
+  EllipticCGMatrixFree(const DiffusionFactorType& diffusion_factor,
+                       const DiffusionTensorType& diffusion_tensor,
+                       const SourceSpaceType& source_space,
+                       const TraversalType* traversal = nullptr)
+    : EllipticCGMatrixFree(diffusion_factor, diffusion_tensor, source_space, source_space, source_space.grid_view(),
+                           traversal)
+  {}
+
+  const SourceSpaceType& source_space() const
+  {
+    return source_space_;
+  }
+
+  const RangeSpaceType& range_space() const
+  {
+    return range_space_;
+  }
+
+  const GridViewType& grid_view() const
+  {
+    return grid_view_;
+  }
+
+  /// \brief Computes range = A source, where A is the matrix EllipticCG would assemble.
+  template< class S, class R >
+  void apply(const Stuff::LA::VectorInterface< S, ScalarType >& source,
+             Stuff::LA::VectorInterface< R, ScalarType >& range) const
+  {
+    application_.apply(local_operator_, source, range);
+  }
+
+private:
+  const SourceSpaceType& source_space_;
+  const RangeSpaceType& range_space_;
+  const GridViewType& grid_view_;
+  const LocalOperatorType local_operator_;
+  const ApplicationType application_;
+}; // class EllipticCGMatrixFree
+
+
 template< class M, class DF, class DT, class S >
 std::unique_ptr< EllipticCG< DF, M, S, S, typename S::GridViewType, DT > > make_elliptic_cg(const DF& diffusion_factor,
                                                                                             const DT& diffusion_tensor,
@@ -191,6 +286,15 @@ std::unique_ptr< EllipticCG< DF, M, S, S, typename S::GridViewType, DT > > make_
                                                                                                space);
 } // ... make_elliptic_cg(...)
 
+template< class DF, class DT, class S >
+std::unique_ptr< EllipticCGMatrixFree< DF, S, S, typename S::GridViewType, DT > >
+make_elliptic_cg_matrix_free(const DF& diffusion_factor, const DT& diffusion_tensor, const S& space)
+{
+  return Stuff::Common::make_unique< EllipticCGMatrixFree< DF, S, S, typename S::GridViewType, DT > >(diffusion_factor,
+                                                                                                       diffusion_tensor,
+                                                                                                       space);
+} // ... make_elliptic_cg_matrix_free(...)
+
 } // namespace Operators
 } // namespace GDT
 } // namespace Dune
@@ -19,6 +19,7 @@
 # include <dune/pdelab/constraints/conforming.hh>
 #endif // HAVE_DUNE_PDELAB
 
+#include <dune/stuff/common/memory.hh>
 #include <dune/stuff/common/type_utils.hh>
 #include <dune/stuff/common/unused.hh>
 #include <dune/stuff/la/container/istl.hh>
@@ -125,6 +126,7 @@ public:
 private:
   typedef typename Traits::CommunicationChooserType CommunicationChooserType;
   typedef typename Traits::FEMapType                FEMapType;
+  typedef typename BaseFunctionSetType::PoolType    BaseFunctionSetPoolType;
 public:
   using typename BaseType::CommunicatorType;
 
@@ -133,6 +135,7 @@ public:
     , fe_map_()
     , backend_(grid_view_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(CommunicationChooser<GridViewImp>::create(grid_view_))
     , communicator_prepared_(false)
   {}
@@ -146,6 +149,7 @@ public:
     , fe_map_()
     , backend_(grid_view_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(CommunicationChooser< GridViewImp >::create(grid_view_))
     , communicator_prepared_(false)
   {
@@ -163,6 +167,7 @@ public:
     , fe_map_(source.fe_map_)
     , backend_(source.backend_)
     , mapper_(source.mapper_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(std::move(source.communicator_))
     , communicator_prepared_(source.communicator_prepared_)
   {}
@@ -188,7 +193,7 @@ public:
 
   BaseFunctionSetType base_function_set(const EntityType& entity) const
   {
-    return BaseFunctionSetType(backend_, entity);
+    return BaseFunctionSetType(*base_function_set_pool_, entity);
   }
 
   CommunicatorType& communicator() const
@@ -204,6 +209,7 @@ private:
   const FEMapType fe_map_;
   const BackendType backend_;
   const MapperType mapper_;
+  const std::unique_ptr< BaseFunctionSetPoolType > base_function_set_pool_;
   mutable std::unique_ptr< CommunicatorType > communicator_;
   mutable bool communicator_prepared_;
   mutable std::mutex communicator_mutex_;
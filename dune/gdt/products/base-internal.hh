@@ -16,6 +16,7 @@
 
 #include <dune/gdt/assembler/local/codim0.hh>
 #include <dune/gdt/assembler/local/codim1.hh>
+#include <dune/gdt/assembler/symmetric.hh>
 #include <dune/gdt/localoperator/interface.hh>
 #include <dune/gdt/spaces/interface.hh>
 
@@ -368,7 +369,9 @@ class AssemblableBaseHelper
   template< class LO, bool anthing = false >
   struct Volume
   {
-    Volume(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&) {}
+    Volume(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&, const MatrixStorage) {}
+
+    void add(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&) const {}
   }; // struct Volume< ..., false >
 
   template< class LO >
@@ -380,10 +383,17 @@ class AssemblableBaseHelper
     //                    or your VolumeOperatorType is not derived from LocalOperator::Codim0Interface
     typedef LocalAssembler::Codim0Matrix< LocalOperatorType > LocalAssemblerType;
 
-    Volume(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators)
-      : local_assembler_(local_operators.volume_operator_) // <- if you get an error here you have defined
-    {                                                       //    has_volume_operator to true but do not provide
-                                                            //    volume_operator_
+    Volume(AssemblableBaseType& base,
+           MatrixType& matrix,
+           const LocalOperatorProvider& local_operators,
+           const MatrixStorage storage)
+      : local_assembler_(local_operators.volume_operator_, storage) // <- if you get an error here you have
+    {                                                                // defined has_volume_operator to true but do
+      add(base, matrix, local_operators);                            // not provide volume_operator_
+    }
+
+    void add(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators) const
+    {
       base.add(local_assembler_, matrix, local_operators.entities()); // <- if you get an error here you have defined
     }                                                                 //    has_volume_operator to true but implemented
                                                                       //    the wrong entities()
@@ -394,7 +404,9 @@ class AssemblableBaseHelper
   template< class LO, bool anthing = false >
   struct Coupling
   {
-    Coupling(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&) {}
+    Coupling(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&, const MatrixStorage) {}
+
+    void add(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&) const {}
   }; // struct Coupling< ..., false >
 
   template< class LO >
@@ -406,10 +418,17 @@ class AssemblableBaseHelper
     //                      or your CouplingOperatorType is not derived from LocalOperator::Codim1CouplingInterface
     typedef LocalAssembler::Codim1CouplingMatrix< LocalOperatorType > LocalAssemblerType;
 
-    Coupling(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators)
-      : local_assembler_(local_operators.coupling_operator_) // <- if you get an error here you have defined
-    {                                                        //    has_coupling_operator to true but do not provide
-                                                             //    coupling_operator_
+    Coupling(AssemblableBaseType& base,
+             MatrixType& matrix,
+             const LocalOperatorProvider& local_operators,
+             const MatrixStorage storage)
+      : local_assembler_(local_operators.coupling_operator_, storage) // <- if you get an error here you have
+    {                                                                  // defined has_coupling_operator to true but
+      add(base, matrix, local_operators);                              // do not provide coupling_operator_
+    }
+
+    void add(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators) const
+    {
       base.add(local_assembler_,
                matrix,
                local_operators.coupling_intersections()); // <- if you get an error here you have defined
@@ -422,7 +441,9 @@ class AssemblableBaseHelper
   template< class LO, bool anthing = false >
   struct Boundary
   {
-    Boundary(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&) {}
+    Boundary(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&, const MatrixStorage) {}
+
+    void add(AssemblableBaseType&, MatrixType&, const LocalOperatorProvider&) const {}
   }; // struct Boundary< ..., false >
 
   template< class LO >
@@ -434,10 +455,17 @@ class AssemblableBaseHelper
     //                      or your BoundaryOperatorType is not derived from LocalOperator::Codim1BoundaryInterface
     typedef LocalAssembler::Codim1BoundaryMatrix< LocalOperatorType > LocalAssemblerType;
 
-    Boundary(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators)
-      : local_assembler_(local_operators.boundary_operator_) // <- if you get an error here you have defined
-    {                                                        //    has_boundary_operator to true but do not provide
-                                                             //    boundary_operator_
+    Boundary(AssemblableBaseType& base,
+             MatrixType& matrix,
+             const LocalOperatorProvider& local_operators,
+             const MatrixStorage storage)
+      : local_assembler_(local_operators.boundary_operator_, storage) // <- if you get an error here you have
+    {                                                                  // defined has_boundary_operator to true but
+      add(base, matrix, local_operators);                              // do not provide boundary_operator_
+    }
+
+    void add(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators) const
+    {
       base.add(local_assembler_,
                matrix,
                local_operators.boundary_intersections()); // <- if you get an error here you have defined
@@ -448,12 +476,23 @@ class AssemblableBaseHelper
   }; // struct Boundary< ..., true >
 
 public:
-  AssemblableBaseHelper(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators)
-    : volume_helper_(  base, matrix, local_operators)
-    , coupling_helper_(base, matrix, local_operators)
-    , boundary_helper_(base, matrix, local_operators)
+  AssemblableBaseHelper(AssemblableBaseType& base,
+                        MatrixType& matrix,
+                        const LocalOperatorProvider& local_operators,
+                        const MatrixStorage storage = MatrixStorage::full)
+    : volume_helper_(  base, matrix, local_operators, storage)
+    , coupling_helper_(base, matrix, local_operators, storage)
+    , boundary_helper_(base, matrix, local_operators, storage)
   {}
 
+  /// \brief Registers the local assemblers (which are registered on construction) at base again, e.g. for a reassembly.
+  void add(AssemblableBaseType& base, MatrixType& matrix, const LocalOperatorProvider& local_operators) const
+  {
+    volume_helper_.add(base, matrix, local_operators);
+    coupling_helper_.add(base, matrix, local_operators);
+    boundary_helper_.add(base, matrix, local_operators);
+  }
+
 private:
   Volume<   LocalOperatorProvider, LocalOperatorProvider::has_volume_operator >   volume_helper_;
   Coupling< LocalOperatorProvider, LocalOperatorProvider::has_coupling_operator > coupling_helper_;
@@ -222,7 +222,8 @@ public:
     : MatrixProvider(mtrx)
     , AssemblerBaseType(rng_spc, src_spc, grd_vw)
     , local_operators_(std::forward< Args >(args)...)
-    , helper_(*this, MatrixProvider::storage_access(), local_operators_)
+    , storage_(MatrixStorage::full)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
     , assembled_(false)
   {}
 
@@ -236,7 +237,8 @@ public:
                                      pattern(rng_spc, src_spc, grd_vw)))
     , AssemblerBaseType(rng_spc, src_spc, grd_vw)
     , local_operators_(std::forward< Args >(args)...)
-    , helper_(*this, MatrixProvider::storage_access(), local_operators_)
+    , storage_(MatrixStorage::full)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
     , assembled_(false)
   {}
 
@@ -245,7 +247,8 @@ public:
     : MatrixProvider(mtrx)
     , AssemblerBaseType(rng_spc, grd_vw)
     , local_operators_(std::forward< Args >(args)...)
-    , helper_(*this, MatrixProvider::storage_access(), local_operators_)
+    , storage_(MatrixStorage::full)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
     , assembled_(false)
   {}
 
@@ -254,7 +257,8 @@ public:
     : MatrixProvider(new MatrixType(rng_spc.mapper().size(), rng_spc.mapper().size(), pattern(rng_spc, grd_vw)))
     , AssemblerBaseType(rng_spc, grd_vw)
     , local_operators_(std::forward< Args >(args)...)
-    , helper_(*this, MatrixProvider::storage_access(), local_operators_)
+    , storage_(MatrixStorage::full)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
     , assembled_(false)
   {}
 
@@ -263,7 +267,8 @@ public:
     : MatrixProvider(mtrx)
     , AssemblerBaseType(rng_spc)
     , local_operators_(std::forward< Args >(args)...)
-    , helper_(*this, MatrixProvider::storage_access(), local_operators_)
+    , storage_(MatrixStorage::full)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
     , assembled_(false)
   {}
 
@@ -272,12 +277,56 @@ public:
     : MatrixProvider(new MatrixType(rng_spc.mapper().size(), rng_spc.mapper().size(), pattern(rng_spc)))
     , AssemblerBaseType(rng_spc)
     , local_operators_(std::forward< Args >(args)...)
-    , helper_(*this, MatrixProvider::storage_access(), local_operators_)
+    , storage_(MatrixStorage::full)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
+    , assembled_(false)
+  {}
+
+  /**
+   * \brief Assembles only the upper triangle of the matrix if storage is MatrixStorage::upper_triangle, which requires
+   *        the local operators to be symmetric (\sa LocalOperator::is_symmetric). Since range and source space
+   *        coincide, the matrix is symmetric and only the upper triangle is computed and stored (the given matrix has
+   *        to provide at least the upper_triangular_pattern()). apply2() takes care of the symmetry, all other users
+   *        of matrix() have to.
+   */
+  template< class... Args >
+  AssemblableBase(const MatrixStorage storage,
+                  MatrixType& mtrx,
+                  const RangeSpaceType& rng_spc,
+                  const GridViewType& grd_vw,
+                  Args&& ...args)
+    : MatrixProvider(mtrx)
+    , AssemblerBaseType(rng_spc, grd_vw)
+    , local_operators_(std::forward< Args >(args)...)
+    , storage_(storage)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
+    , assembled_(false)
+  {}
+
+  template< class... Args >
+  AssemblableBase(const MatrixStorage storage,
+                  const RangeSpaceType& rng_spc,
+                  const GridViewType& grd_vw,
+                  Args&& ...args)
+    : MatrixProvider(new MatrixType(rng_spc.mapper().size(),
+                                     rng_spc.mapper().size(),
+                                     storage == MatrixStorage::upper_triangle
+                                     ? upper_triangular_pattern(pattern(rng_spc, grd_vw))
+                                     : pattern(rng_spc, grd_vw)))
+    , AssemblerBaseType(rng_spc, grd_vw)
+    , local_operators_(std::forward< Args >(args)...)
+    , storage_(storage)
+    , helper_(*this, MatrixProvider::storage_access(), local_operators_, storage_)
     , assembled_(false)
   {}
 
   using AssemblerBaseType::grid_view;
 
+  MatrixStorage matrix_storage() const
+  {
+    return storage_;
+  }
+
   const RangeSpaceType& range_space() const
   {
     return AssemblerBaseType::test_space();
@@ -306,8 +355,55 @@ public:
     }
   } // ... assemble()
 
+  /**
+   * \brief Assembles (only once, as assemble() does) using a coloring of the grid view, \sa
+   *        SystemAssembler::assemble_colored().
+   */
+  void assemble_colored()
+  {
+    if (!assembled_) {
+      AssemblerBaseType::assemble_colored();
+      assembled_ = true;
+    }
+  } // ... assemble_colored(...)
+
+  /**
+   * \brief Assembles (only once, as assemble() does) into thread local copies of the matrix, \sa
+   *        SystemAssembler::assemble_with_thread_local_copies().
+   */
+  void assemble_with_thread_local_copies()
+  {
+    if (!assembled_) {
+      AssemblerBaseType::assemble_with_thread_local_copies();
+      assembled_ = true;
+    }
+  } // ... assemble_with_thread_local_copies(...)
+
+  /**
+   * \brief Assembles the matrix again, e.g. after the data functions of the local operators have changed.
+   *
+   *        The pattern of the matrix is kept and its values are set to zero in place. The local matrices are then
+   *        added directly at the positions of their entries in the values of the matrix, which are computed on the
+   *        first reassembly unless given before (\sa SystemAssembler::precompute_scatter_offsets() and
+   *        SystemAssembler::set_scatter_offsets()).
+   */
+  void reassemble(const bool use_tbb = false)
+  {
+    if (!assembled_) {
+      assemble(use_tbb);
+      return;
+    }
+    auto& mtrx = matrix();
+    mtrx.scal(0.0);
+    if (!AssemblerBaseType::scatter_offsets(mtrx))
+      AssemblerBaseType::precompute_scatter_offsets(mtrx, storage_, LocalOperatorProvider::has_coupling_operator);
+    helper_.add(*this, mtrx, local_operators_);
+    AssemblerBaseType::assemble(use_tbb);
+  } // ... reassemble(...)
+
 private:
   const LocalOperatorProvider local_operators_;
+  const MatrixStorage storage_;
   HelperType helper_;
   bool assembled_;
 }; // class AssemblableBase
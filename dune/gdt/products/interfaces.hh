@@ -12,6 +12,7 @@
 #include <dune/stuff/functions/interfaces.hh>
 #include <dune/stuff/la/container/interfaces.hh>
 
+#include <dune/gdt/assembler/symmetric.hh>
 #include <dune/gdt/spaces/interface.hh>
 #include <dune/gdt/discretefunction/default.hh>
 
@@ -222,6 +223,8 @@ public:
     assemble();
     assert(range.size() == matrix().rows());
     assert(source.size() == matrix().cols());
+    if (internal::matrix_storage(this->as_imp(), 0) == MatrixStorage::upper_triangle)
+      return upper_triangular_apply2(matrix(), range, source);
     auto tmp = range.copy();
     matrix().mv(source.as_imp(source), tmp);
     return range.dot(tmp);
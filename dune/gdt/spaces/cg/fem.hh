@@ -183,6 +183,22 @@ class FemBased
 
 } // namespace CG
 } // namespace Spaces
+
+
+#if HAVE_DUNE_FEM
+
+
+template< class GridPartImp, int polynomialOrder, class RangeFieldImp >
+struct fixed_num_dofs< Spaces::CG::FemBased< GridPartImp, polynomialOrder, RangeFieldImp, 1, 1 > >
+  : public std::integral_constant< size_t,
+                                   internal::LagrangeFixedNumDofs< typename GridPartImp::GridType,
+                                                                   polynomialOrder >::value >
+{};
+
+
+#endif // HAVE_DUNE_FEM
+
+
 } // namespace GDT
 } // namespace Dune
 
@@ -18,6 +18,10 @@
 # include <dune/geometry/genericreferenceelements.hh>
 #endif
 
+#include <dune/geometry/genericgeometry/topologytypes.hh>
+
+#include <dune/grid/common/capabilities.hh>
+
 #include <dune/stuff/common/exceptions.hh>
 #include <dune/stuff/common/type_utils.hh>
 
@@ -224,6 +228,40 @@ struct is_cg_space_helper
 }; // class is_cg_space_helper
 
 
+constexpr size_t lagrange_binomial(const size_t nn, const size_t kk)
+{
+  return kk == 0 ? 1 : (lagrange_binomial(nn - 1, kk - 1) * nn) / kk;
+}
+
+
+constexpr size_t lagrange_power(const size_t base, const size_t exponent)
+{
+  return exponent == 0 ? 1 : base * lagrange_power(base, exponent - 1);
+}
+
+
+/**
+ * \brief The number of DoFs of a scalar Lagrange space of order polOrder on each entity of a grid with only
+ *        simplices or only cubes, 0 for all other grids (see fixed_num_dofs).
+ */
+template< class GridType, int polOrder >
+struct LagrangeFixedNumDofs
+{
+private:
+  static const size_t dimDomain = GridType::dimension;
+  static const size_t order = polOrder;
+  typedef Dune::Capabilities::hasSingleGeometryType< GridType > SingleGeometryType;
+  static const bool simplicial = SingleGeometryType::v
+                                 && SingleGeometryType::topologyId
+                                    == GenericGeometry::SimplexTopology< dimDomain >::type::id;
+  static const bool cubic = SingleGeometryType::v
+                            && SingleGeometryType::topologyId == GenericGeometry::CubeTopology< dimDomain >::type::id;
+public:
+  static const size_t value = simplicial ? lagrange_binomial(order + dimDomain, dimDomain)
+                                         : (cubic ? lagrange_power(order + 1, dimDomain) : 0);
+}; // struct LagrangeFixedNumDofs
+
+
 } // namespace internal
 
 
@@ -26,6 +26,7 @@
 # include <dune/pdelab/constraints/conforming.hh>
 #endif // HAVE_DUNE_PDELAB
 
+#include <dune/stuff/common/memory.hh>
 #include <dune/stuff/common/type_utils.hh>
 
 #include <dune/gdt/spaces/parallel.hh>
@@ -134,6 +135,7 @@ public:
 
 private:
   typedef typename Traits::FEMapType FEMapType;
+  typedef typename BaseFunctionSetType::PoolType BaseFunctionSetPoolType;
 
 public:
   typedef typename BaseType::IntersectionType  IntersectionType;
@@ -146,6 +148,7 @@ public:
     , fe_map_(gridView_)
     , backend_(gridView_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(CommunicationChooser< GridViewImp >::create(gridView_))
     , communicator_prepared_(false)
   {}
@@ -159,6 +162,7 @@ public:
     , fe_map_(gridView_)
     , backend_(gridView_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(CommunicationChooser< GridViewImp >::create(gridView_))
     , communicator_prepared_(false)
   {
@@ -176,6 +180,7 @@ public:
     , fe_map_(source.fe_map_)
     , backend_(source.backend_)
     , mapper_(source.mapper_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(std::move(source.communicator_))
     , communicator_prepared_(source.communicator_prepared_)
   {}
@@ -212,7 +217,7 @@ public:
 
   BaseFunctionSetType base_function_set(const EntityType& entity) const
   {
-    return BaseFunctionSetType(backend_, entity);
+    return BaseFunctionSetType(*base_function_set_pool_, entity);
   }
 
   CommunicatorType& communicator() const
@@ -228,6 +233,7 @@ private:
   const FEMapType fe_map_;
   const BackendType backend_;
   const MapperType mapper_;
+  const std::unique_ptr< BaseFunctionSetPoolType > base_function_set_pool_;
   mutable std::unique_ptr<CommunicatorType> communicator_;
   mutable bool communicator_prepared_;
   mutable std::mutex communicator_mutex_;
@@ -249,6 +255,22 @@ class PdelabBased
 
 } // namespace CG
 } // namespace Spaces
+
+
+#if HAVE_DUNE_PDELAB
+
+
+template< class GridViewImp, int polynomialOrder, class RangeFieldImp >
+struct fixed_num_dofs< Spaces::CG::PdelabBased< GridViewImp, polynomialOrder, RangeFieldImp, 1, 1 > >
+  : public std::integral_constant< size_t,
+                                   internal::LagrangeFixedNumDofs< typename GridViewImp::Grid,
+                                                                   polynomialOrder >::value >
+{};
+
+
+#endif // HAVE_DUNE_PDELAB
+
+
 } // namespace GDT
 } // namespace Dune
 
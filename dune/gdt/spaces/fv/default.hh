@@ -148,6 +148,14 @@ FV::Default< GV, R, r, 1 > make_fv(const GV& grid_view)
 
 
 } // namespace Spaces
+
+
+template< class GridViewImp, class RangeFieldImp, size_t rangeDim >
+struct fixed_num_dofs< Spaces::FV::Default< GridViewImp, RangeFieldImp, rangeDim, 1 > >
+  : public std::integral_constant< size_t, rangeDim >
+{};
+
+
 } // namespace GDT
 } // namespace Dune
 
@@ -26,6 +26,7 @@
 #include <dune/stuff/la/container/pattern.hh>
 
 #include "constraints.hh"
+#include "pattern.hh"
 
 namespace Dune {
 namespace GDT {
@@ -112,6 +113,10 @@ public:
 
   static const bool needs_grid_view = Traits::needs_grid_view;
 
+  SpaceInterface()
+    : pattern_cache_(std::make_shared< internal::PatternCache >())
+  {}
+
 public:
   /**
    * \defgroup interface ´´These methods have to be implemented!''
@@ -208,19 +213,19 @@ void local_constraints(const SpaceInterface< S, d, r, rC > >&, const EntityType&
     return compute_pattern(local_grid_view, *this);
   }
 
-  PatternType compute_volume_pattern() const
+  const PatternType& compute_volume_pattern() const
   {
     return compute_volume_pattern(*this);
   }
 
   template< class S, size_t d, size_t r, size_t rC >
-  PatternType compute_volume_pattern(const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  const PatternType& compute_volume_pattern(const SpaceInterface< S, d, r, rC >& ansatz_space) const
   {
     return compute_volume_pattern(grid_view(), ansatz_space);
   }
 
   template< class G >
-  PatternType compute_volume_pattern(const GridView< G >& local_grid_view) const
+  const PatternType& compute_volume_pattern(const GridView< G >& local_grid_view) const
   {
     return compute_volume_pattern(local_grid_view, *this);
   }
@@ -228,43 +233,30 @@ void local_constraints(const SpaceInterface< S, d, r, rC > >&, const EntityType&
   /**
    *  \brief  computes a sparsity pattern, where this space is the test space (rows/outer) and the other space is the
    *          ansatz space (cols/inner)
+   *  \note   The patterns are computed in parallel (see internal::PatternBuilder) and cached for each grid view and
+   *          ansatz space (see internal::PatternCache). The returned pattern is owned by the cache, call
+   *          clear_pattern_cache() after adapting the grid if this does not change its number of entities.
    */
   template< class G, class S, size_t d, size_t r, size_t rC >
-  PatternType compute_volume_pattern(const GridView< G >& local_grid_view,
-                                     const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  const PatternType& compute_volume_pattern(const GridView< G >& local_grid_view,
+                                            const SpaceInterface< S, d, r, rC >& ansatz_space) const
   {
-    PatternType pattern(mapper().size());
-    Dune::DynamicVector< size_t > globalRows(mapper().maxNumDofs(), 0);
-    Dune::DynamicVector< size_t > globalCols(ansatz_space.mapper().maxNumDofs(), 0);
-
-    for (const auto& entity : DSC::entityRange(local_grid_view)) {
-      const auto testBase = base_function_set(entity);
-      const auto ansatzBase = ansatz_space.base_function_set(entity);
-      mapper().globalIndices(entity, globalRows);
-      ansatz_space.mapper().globalIndices(entity, globalCols);
-      for (size_t ii = 0; ii < testBase.size(); ++ii) {
-        for (size_t jj = 0; jj < ansatzBase.size(); ++jj) {
-          pattern.insert(globalRows[ii], globalCols[jj]);
-        }
-      }
-    }
-    pattern.sort();
-    return pattern;
+    return compute_cached_pattern(internal::PatternCache::Kind::volume, local_grid_view, ansatz_space);
   } // ... compute_volume_pattern(...)
 
-  PatternType compute_face_and_volume_pattern() const
+  const PatternType& compute_face_and_volume_pattern() const
   {
     return compute_face_and_volume_pattern(grid_view(), *this);
   }
 
   template< class G >
-  PatternType compute_face_and_volume_pattern(const GridView< G >& local_grid_view) const
+  const PatternType& compute_face_and_volume_pattern(const GridView< G >& local_grid_view) const
   {
     return compute_face_and_volume_pattern(local_grid_view, *this);
   }
 
   template< class S, size_t d, size_t r, size_t rC >
-  PatternType compute_face_and_volume_pattern(const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  const PatternType& compute_face_and_volume_pattern(const SpaceInterface< S, d, r, rC >& ansatz_space) const
   {
     return compute_face_and_volume_pattern(grid_view(), ansatz_space);
   }
@@ -274,105 +266,82 @@ void local_constraints(const SpaceInterface< S, d, r, rC > >&, const EntityType&
    *          ansatz space (cols/inner)
    */
   template< class G, class S, size_t d, size_t r, size_t rC >
-  PatternType compute_face_and_volume_pattern(const GridView< G >& local_grid_view,
-                                              const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  const PatternType& compute_face_and_volume_pattern(const GridView< G >& local_grid_view,
+                                                     const SpaceInterface< S, d, r, rC >& ansatz_space) const
   {
-    // prepare
-    PatternType pattern(mapper().size());
-    Dune::DynamicVector< size_t > global_rows(mapper().maxNumDofs(), 0);
-    Dune::DynamicVector< size_t > global_cols(ansatz_space.mapper().maxNumDofs(), 0);
-    for (const auto& entity : DSC::entityRange(local_grid_view)) {
-      const auto test_base_entity = base_function_set(entity);
-      const auto ansatz_base_entity = ansatz_space.base_function_set(entity);
-      mapper().globalIndices(entity, global_rows);
-      ansatz_space.mapper().globalIndices(entity, global_cols);
-      // compute entity/entity
-      for (size_t ii = 0; ii < test_base_entity.size(); ++ii) {
-        for (size_t jj = 0; jj < ansatz_base_entity.size(); ++jj) {
-          pattern.insert(global_rows[ii], global_cols[jj]);
-        }
-      }
-      // walk the intersections
-      const auto intersection_it_end = local_grid_view.iend(entity);
-      for (auto intersection_it = local_grid_view.ibegin(entity);
-           intersection_it != intersection_it_end;
-           ++intersection_it) {
-        const auto& intersection = *intersection_it;
-        // get the neighbour
-        if (intersection.neighbor() && !intersection.boundary()) {
-          const auto neighbour_ptr = intersection.outside();
-          const auto& neighbour = *neighbour_ptr;
-          // get the basis
-          const auto ansatz_base_neighbour = ansatz_space.base_function_set(neighbour);
-          ansatz_space.mapper().globalIndices(neighbour, global_cols);
-          // compute entity/neighbour
-          for (size_t ii = 0; ii < test_base_entity.size(); ++ii) {
-            for (size_t jj = 0; jj < ansatz_base_neighbour.size(); ++jj) {
-              pattern.insert(global_rows[ii], global_cols[jj]);
-            }
-          }
-        } // get the neighbour
-      } // walk the intersections
-    } // walk the grid view
-    pattern.sort();
-    return pattern;
+    return compute_cached_pattern(internal::PatternCache::Kind::face_and_volume, local_grid_view, ansatz_space);
   } // ... compute_face_and_volume_pattern(...)
 
-  PatternType compute_face_pattern() const
+  const PatternType& compute_face_pattern() const
   {
     return compute_face_pattern(grid_view(), *this);
   }
 
   template< class G >
-  PatternType compute_face_pattern(const GridView< G >& local_grid_view) const
+  const PatternType& compute_face_pattern(const GridView< G >& local_grid_view) const
   {
     return compute_face_pattern(local_grid_view, *this);
   }
 
   template< class S, size_t d, size_t r, size_t rC >
-  PatternType compute_face_pattern(const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  const PatternType& compute_face_pattern(const SpaceInterface< S, d, r, rC >& ansatz_space) const
   {
     return compute_face_pattern(grid_view(), ansatz_space);
   }
 
   template< class G, class S, size_t d, size_t r, size_t rC >
-  PatternType compute_face_pattern(const /*GridView<*/ G /*>*/& local_grid_view,
-                                   const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  const PatternType& compute_face_pattern(const /*GridView<*/ G /*>*/& local_grid_view,
+                                          const SpaceInterface< S, d, r, rC >& ansatz_space) const
   {
-    // prepare
-    PatternType pattern(mapper().size());
-    Dune::DynamicVector< size_t > global_rows(mapper().maxNumDofs(), 0);
-    Dune::DynamicVector< size_t > global_cols(ansatz_space.mapper().maxNumDofs(), 0);
-    for (const auto& entity : DSC::entityRange(local_grid_view)) {
-      const auto test_base_entity = base_function_set(entity);
-      mapper().globalIndices(entity, global_rows);
-      // walk the intersections
-      const auto intersection_it_end = local_grid_view.iend(entity);
-      for (auto intersection_it = local_grid_view.ibegin(entity);
-           intersection_it != intersection_it_end;
-           ++intersection_it) {
-        const auto& intersection = *intersection_it;
-        // get the neighbour
-        if (intersection.neighbor() && !intersection.boundary()) {
-          const auto neighbour_ptr = intersection.outside();
-          const auto& neighbour = *neighbour_ptr;
-          // get the basis
-          const auto ansatz_base_neighbour = ansatz_space.base_function_set(neighbour);
-          ansatz_space.mapper().globalIndices(neighbour, global_cols);
-          // compute entity/neighbour
-          for (size_t ii = 0; ii < test_base_entity.size(); ++ii) {
-            for (size_t jj = 0; jj < ansatz_base_neighbour.size(); ++jj) {
-              pattern.insert(global_rows[ii], global_cols[jj]);
-            }
-          }
-        } // get the neighbour
-      } // walk the intersections
-    } // walk the grid view
-    pattern.sort();
-    return pattern;
+    return compute_cached_pattern(internal::PatternCache::Kind::face, local_grid_view, ansatz_space);
   } // ... compute_face_pattern(...)
 
+  /**
+   * \brief Computes the pattern of compute_volume_pattern() (or of compute_face_and_volume_pattern(), if faces)
+   *        collapsed into blocks of block_size, without computing the scalar pattern, \sa internal::BlockMapper.
+   * \note  The block pattern is not cached.
+   */
+  PatternType compute_block_pattern(const size_t block_size, const bool faces) const
+  {
+    const internal::BlockMapper< MapperType > block_mapper(mapper(), block_size);
+    return internal::PatternBuilder< GridViewType >::build(grid_view(), block_mapper, block_mapper, true, faces);
+  }
+
+  /**
+   * \brief Forgets all patterns computed so far, which invalidates all patterns returned so far.
+   * \sa    compute_volume_pattern()
+   */
+  void clear_pattern_cache() const
+  {
+    pattern_cache_->clear();
+  }
+
 private:
+  template< class T, size_t dd, size_t rr, size_t rrC >
+  friend class SpaceInterface;
+
+  template< class G, class S, size_t d, size_t r, size_t rC >
+  const PatternType& compute_cached_pattern(const internal::PatternCache::Kind kind,
+                                            const G& local_grid_view,
+                                            const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  {
+    typedef internal::PatternBuilder< G > BuilderType;
+    const bool volume = kind != internal::PatternCache::Kind::face;
+    const bool faces = kind != internal::PatternCache::Kind::volume;
+    return pattern_cache_->get(kind,
+                               local_grid_view,
+                               mapper().size(),
+                               ansatz_space.mapper().size(),
+                               ansatz_space.pattern_cache_->id(),
+                               [&]() {
+                                 return BuilderType::build(local_grid_view,
+                                                           mapper(),
+                                                           ansatz_space.mapper(),
+                                                           volume,
+                                                           faces);
+                               });
+  } // ... compute_cached_pattern(...)
+
   class BasisVisualization
     : public Dune::VTKFunction< GridViewType >
   {
@@ -453,6 +422,9 @@ public:
   } // ... visualize(...)
 
   /* @} */
+
+private:
+  std::shared_ptr< internal::PatternCache > pattern_cache_;
 }; // class SpaceInterface
 
 
@@ -502,6 +474,19 @@ struct is_space< S, false >
 {};
 
 
+/**
+ * \brief The number of DoFs of the space S on each entity, if this number is the same for all entities and known at
+ *        compile time, 0 otherwise.
+ *
+ *        Spaces which know this number should specialize this, it allows for statically sized local matrices (see
+ *        LocalAssembler::Codim0Matrix).
+ */
+template< class S >
+struct fixed_num_dofs
+  : public std::integral_constant< size_t, 0 >
+{};
+
+
 } // namespace GDT
 } // namespace Dune
 
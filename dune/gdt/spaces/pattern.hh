@@ -0,0 +1,369 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_SPACES_PATTERN_HH
+#define DUNE_GDT_SPACES_PATTERN_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if HAVE_TBB
+# include <tbb/blocked_range.h>
+# include <tbb/parallel_for.h>
+#endif
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/unused.hh>
+
+#include <dune/stuff/common/parallel/threadmanager.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/la/container/pattern.hh>
+
+namespace Dune {
+namespace GDT {
+namespace internal {
+
+
+/**
+ * \brief Maps the DoFs of mapper to blocks of block_size (DoF ii to block ii / block_size), to build the pattern of the
+ *        blocks directly with the PatternBuilder, \sa SpaceInterface::compute_block_pattern().
+ *
+ *        The result is the collapsed scalar pattern for any mapper, but the work is only reduced by a factor of
+ *        block_size^2 if the DoFs of each entity form contiguous blocks (as for Mapper::FiniteVolume with
+ *        dimRange == block_size).
+ */
+template< class MapperImp >
+class BlockMapper
+{
+public:
+  typedef MapperImp MapperType;
+
+  BlockMapper(const MapperType& mapper, const size_t block_size)
+    : mapper_(mapper)
+    , block_size_(block_size)
+  {
+    assert(block_size_ > 0);
+  }
+
+  size_t size() const
+  {
+    return (mapper_.size() + block_size_ - 1) / block_size_;
+  }
+
+  /**
+   * \brief The number of DoFs (not blocks) of the mapper, which is the required size of global_block_indices().
+   */
+  size_t maxNumDofs() const
+  {
+    return mapper_.maxNumDofs();
+  }
+
+  /**
+   * \brief Writes the blocks of the DoFs of entity (each only once) to the beginning of ret and returns their number.
+   */
+  template< class EntityType >
+  size_t global_block_indices(const EntityType& entity, Dune::DynamicVector< size_t >& ret) const
+  {
+    const size_t num_dofs = mapper_.numDofs(entity);
+    mapper_.globalIndices(entity, ret);
+    size_t num_blocks = 0;
+    for (size_t ii = 0; ii < num_dofs; ++ii) {
+      const size_t block = ret[ii] / block_size_;
+      // contiguous blocks only repeat the last one
+      if (num_blocks > 0 && ret[num_blocks - 1] == block)
+        continue;
+      if (std::find(ret.begin(), ret.begin() + num_blocks, block) == ret.begin() + num_blocks)
+        ret[num_blocks++] = block;
+    }
+    return num_blocks;
+  } // ... global_block_indices(...)
+
+private:
+  const MapperType& mapper_;
+  const size_t block_size_;
+}; // class BlockMapper
+
+
+/**
+ * \brief Computes sparsity patterns row by row, in parallel if TBB is available.
+ *
+ *        The entities of the grid view are split into contiguous partitions. For each entity, each partition records
+ *        the global indices of the test space (rows) and all coupling global indices of the ansatz space (cols: those
+ *        of the entity itself and/or those of its neighbors) in one block, and sorts the rows of the block into
+ *        buckets, one for each contiguous range of rows. Each range of rows is then filled by appending the cols of all
+ *        blocks which touch it, followed by a sort and unique, so there is no per-entry insertion (which requires a
+ *        search of the row) and each row is only written to by a single thread.
+ */
+template< class GridViewType >
+class PatternBuilder
+{
+  typedef typename GridViewType::template Codim< 0 >::Entity::EntitySeed EntitySeedType;
+
+  struct Block
+  {
+    size_t rows_begin;
+    size_t rows_end;
+    size_t cols_begin;
+    size_t cols_end;
+  }; // struct Block
+
+  struct Partition
+  {
+    std::vector< size_t > rows;
+    std::vector< size_t > cols;
+    std::vector< Block > blocks;
+    // buckets[bb] contains (global row, block) for all rows of the bb-th range of rows
+    std::vector< std::vector< std::pair< size_t, size_t > > > buckets;
+  }; // struct Partition
+
+public:
+  typedef Stuff::LA::SparsityPatternDefault PatternType;
+
+  /**
+   * \param volume  Couple the DoFs of each entity with the DoFs of the entity.
+   * \param faces   Couple the DoFs of each entity with the DoFs of each neighbor (inner intersections only).
+   */
+  template< class TestMapperType, class AnsatzMapperType >
+  static PatternType build(const GridViewType& grid_view,
+                           const TestMapperType& test_mapper,
+                           const AnsatzMapperType& ansatz_mapper,
+                           const bool volume,
+                           const bool faces)
+  {
+    std::vector< EntitySeedType > seeds;
+    seeds.reserve(grid_view.indexSet().size(0));
+    for (const auto& entity : DSC::entityRange(grid_view))
+      seeds.push_back(entity.seed());
+    const size_t num_rows = test_mapper.size();
+    const size_t num_partitions = std::max(size_t(1), std::min(num_threads(), seeds.size()));
+    const size_t num_row_ranges = std::max(size_t(1), std::min(num_threads(), num_rows));
+    // collect the couplings of each partition of entities
+    std::vector< Partition > partitions(num_partitions);
+    for_each(num_partitions, [&](const size_t pp) {
+      collect(grid_view,
+              test_mapper,
+              ansatz_mapper,
+              volume,
+              faces,
+              seeds,
+              (pp*seeds.size())/num_partitions,
+              ((pp + 1)*seeds.size())/num_partitions,
+              num_rows,
+              num_row_ranges,
+              partitions[pp]);
+    });
+    // fill each range of rows
+    PatternType pattern(num_rows);
+    for_each(num_row_ranges, [&](const size_t bb) {
+      for (const auto& partition : partitions) {
+        for (const auto& row_and_block : partition.buckets[bb]) {
+          const auto& block = partition.blocks[row_and_block.second];
+          auto& row = pattern.inner(row_and_block.first);
+          row.insert(row.end(), partition.cols.begin() + block.cols_begin, partition.cols.begin() + block.cols_end);
+        }
+      }
+      const size_t rows_begin = (bb*num_rows)/num_row_ranges;
+      const size_t rows_end = ((bb + 1)*num_rows)/num_row_ranges;
+      for (size_t ii = rows_begin; ii < rows_end; ++ii) {
+        auto& row = pattern.inner(ii);
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+      }
+    });
+    return pattern;
+  } // ... build(...)
+
+private:
+  static size_t num_threads()
+  {
+#if HAVE_TBB
+    return std::max(size_t(1), size_t(DS::threadManager().max_threads()));
+#else
+    return 1;
+#endif
+  }
+
+  template< class FunctorType >
+  static void for_each(const size_t size, const FunctorType& functor)
+  {
+#if HAVE_TBB
+    tbb::parallel_for(tbb::blocked_range< size_t >(0, size, 1), [&](const tbb::blocked_range< size_t >& range) {
+      for (size_t ii = range.begin(); ii != range.end(); ++ii)
+        functor(ii);
+    });
+#else // HAVE_TBB
+    for (size_t ii = 0; ii < size; ++ii)
+      functor(ii);
+#endif // HAVE_TBB
+  } // ... for_each(...)
+
+  template< class TestMapperType, class AnsatzMapperType >
+  static void collect(const GridViewType& grid_view,
+                      const TestMapperType& test_mapper,
+                      const AnsatzMapperType& ansatz_mapper,
+                      const bool volume,
+                      const bool faces,
+                      const std::vector< EntitySeedType >& seeds,
+                      const size_t seeds_begin,
+                      const size_t seeds_end,
+                      const size_t num_rows,
+                      const size_t num_row_ranges,
+                      Partition& partition)
+  {
+    Dune::DynamicVector< size_t > global_indices(std::max(test_mapper.maxNumDofs(), ansatz_mapper.maxNumDofs()), 0);
+    partition.buckets.resize(num_row_ranges);
+    partition.blocks.reserve(seeds_end - seeds_begin);
+    for (size_t ss = seeds_begin; ss < seeds_end; ++ss) {
+      const auto entity_ptr = grid_view.grid().entity(seeds[ss]);
+      const auto& entity = *entity_ptr;
+      Block block;
+      block.rows_begin = partition.rows.size();
+      append_global_indices(test_mapper, entity, global_indices, partition.rows);
+      block.rows_end = partition.rows.size();
+      block.cols_begin = partition.cols.size();
+      if (volume)
+        append_global_indices(ansatz_mapper, entity, global_indices, partition.cols);
+      if (faces) {
+        const auto intersection_it_end = grid_view.iend(entity);
+        for (auto intersection_it = grid_view.ibegin(entity);
+             intersection_it != intersection_it_end;
+             ++intersection_it) {
+          const auto& intersection = *intersection_it;
+          if (intersection.neighbor() && !intersection.boundary()) {
+            const auto neighbour_ptr = intersection.outside();
+            append_global_indices(ansatz_mapper, *neighbour_ptr, global_indices, partition.cols);
+          }
+        }
+      }
+      block.cols_end = partition.cols.size();
+      if (block.cols_end == block.cols_begin)
+        continue;
+      const size_t block_index = partition.blocks.size();
+      partition.blocks.push_back(block);
+      for (size_t ii = block.rows_begin; ii < block.rows_end; ++ii) {
+        const size_t global_row = partition.rows[ii];
+        partition.buckets[(global_row*num_row_ranges)/num_rows].emplace_back(global_row, block_index);
+      }
+    }
+  } // ... collect(...)
+
+  template< class MapperType, class EntityType >
+  static void append_global_indices(const MapperType& mapper,
+                                    const EntityType& entity,
+                                    Dune::DynamicVector< size_t >& global_indices,
+                                    std::vector< size_t >& ret)
+  {
+    const size_t num_dofs = mapper.numDofs(entity);
+    mapper.globalIndices(entity, global_indices);
+    ret.insert(ret.end(), global_indices.begin(), global_indices.begin() + num_dofs);
+  }
+
+  template< class MapperType, class EntityType >
+  static void append_global_indices(const BlockMapper< MapperType >& mapper,
+                                    const EntityType& entity,
+                                    Dune::DynamicVector< size_t >& global_indices,
+                                    std::vector< size_t >& ret)
+  {
+    const size_t num_blocks = mapper.global_block_indices(entity, global_indices);
+    ret.insert(ret.end(), global_indices.begin(), global_indices.begin() + num_blocks);
+  }
+}; // class PatternBuilder
+
+
+/**
+ * \brief Caches sparsity patterns of a space, see SpaceInterface::compute_volume_pattern() etc.
+ *
+ *        A pattern is identified by its kind (volume, face, face and volume), by the index set of the grid view and its
+ *        number of entities, by the number of rows and cols and by the id() of the cache of the ansatz space, which is
+ *        unique for each space (and shared by its copies). None of these require a walk over the grid, so an adaptation
+ *        of the grid which keeps the number of entities is not detected and requires a call to clear(). The patterns
+ *        are built outside of the lock, so several threads may build different patterns at once.
+ */
+class PatternCache
+{
+  typedef Stuff::LA::SparsityPatternDefault PatternType;
+  typedef std::tuple< int, const void*, size_t, size_t, size_t, std::uint64_t > KeyType;
+
+public:
+  enum class Kind
+  {
+      volume
+    , face
+    , face_and_volume
+  }; // enum class Kind
+
+  PatternCache()
+    : id_(next_id())
+  {}
+
+  std::uint64_t id() const
+  {
+    return id_;
+  }
+
+  /**
+   * \brief Returns the cached pattern, which is built by builder() if required.
+   * \note  The pattern stays valid until clear() is called or the number of entities of the grid view changes.
+   */
+  template< class GridViewType, class BuilderType >
+  const PatternType& get(const Kind kind,
+                         const GridViewType& grid_view,
+                         const size_t num_rows,
+                         const size_t num_cols,
+                         const std::uint64_t ansatz_id,
+                         const BuilderType& builder)
+  {
+    const KeyType key(int(kind), &grid_view.indexSet(), grid_view.indexSet().size(0), num_rows, num_cols, ansatz_id);
+    {
+      std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+      const auto result = patterns_.find(key);
+      if (result != patterns_.end())
+        return *result->second;
+    }
+    auto pattern = std::make_shared< const PatternType >(builder());
+    std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+    // forget the patterns of this grid view before it was adapted
+    for (auto it = patterns_.begin(); it != patterns_.end();) {
+      if (std::get< 1 >(it->first) == std::get< 1 >(key) && std::get< 2 >(it->first) != std::get< 2 >(key))
+        it = patterns_.erase(it);
+      else
+        ++it;
+    }
+    // another thread might have built the same pattern in the meantime, in which case we use the cached one
+    return *patterns_.emplace(key, std::move(pattern)).first->second;
+  } // ... get(...)
+
+  void clear()
+  {
+    std::lock_guard< std::mutex > DUNE_UNUSED(guard)(mutex_);
+    patterns_.clear();
+  }
+
+private:
+  static std::uint64_t next_id()
+  {
+    static std::atomic< std::uint64_t > counter(0);
+    return counter++;
+  }
+
+  const std::uint64_t id_;
+  std::mutex mutex_;
+  std::map< KeyType, std::shared_ptr< const PatternType > > patterns_;
+}; // class PatternCache
+
+
+} // namespace internal
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_SPACES_PATTERN_HH
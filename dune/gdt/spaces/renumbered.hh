@@ -0,0 +1,205 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_SPACES_RENUMBERED_HH
+#define DUNE_GDT_SPACES_RENUMBERED_HH
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/typetraits.hh>
+
+#include <dune/gdt/mapper/renumbered.hh>
+
+#include "interface.hh"
+
+namespace Dune {
+namespace GDT {
+namespace Spaces {
+
+
+// forward, to be used in the traits
+template< class SpaceImp >
+class Renumbered;
+
+
+namespace internal {
+
+
+template< class SpaceImp >
+class RenumberedTraits
+{
+  static_assert(is_space< SpaceImp >::value, "SpaceImp has to be derived from SpaceInterface!");
+public:
+  typedef Renumbered< SpaceImp >                              derived_type;
+  static const int                                            polOrder = SpaceImp::polOrder;
+  typedef typename SpaceImp::BackendType                      BackendType;
+  typedef Mapper::Renumbered< typename SpaceImp::MapperType > MapperType;
+  typedef typename SpaceImp::BaseFunctionSetType              BaseFunctionSetType;
+  typedef typename SpaceImp::CommunicatorType                 CommunicatorType;
+  typedef typename SpaceImp::GridViewType                     GridViewType;
+  typedef typename SpaceImp::RangeFieldType                   RangeFieldType;
+
+  static const Stuff::Grid::ChoosePartView part_view_type = SpaceImp::part_view_type;
+
+  static const bool needs_grid_view = SpaceImp::needs_grid_view;
+}; // class RenumberedTraits
+
+
+} // namespace internal
+
+
+/**
+ * \brief A space with the base function sets of another space, the DoFs of which are renumbered for cache locality,
+ *        \sa Mapper::Renumbering.
+ *
+ *        Since the mapper is the only source of global indices, the sparsity patterns, the assembled matrices and
+ *        vectors and all discrete functions of this space use the renumbered indices.
+ * \note  The communicator of the underlying space is not renumbered, so this space is meant for sequential runs.
+ */
+template< class SpaceImp >
+class Renumbered
+  : public SpaceInterface< internal::RenumberedTraits< SpaceImp >,
+                           SpaceImp::dimDomain,
+                           SpaceImp::dimRange,
+                           SpaceImp::dimRangeCols >
+{
+  typedef SpaceInterface< internal::RenumberedTraits< SpaceImp >,
+                          SpaceImp::dimDomain,
+                          SpaceImp::dimRange,
+                          SpaceImp::dimRangeCols > BaseType;
+  typedef Renumbered< SpaceImp >                   ThisType;
+public:
+  typedef internal::RenumberedTraits< SpaceImp > Traits;
+  typedef SpaceImp                               SpaceType;
+  using typename BaseType::GridViewType;
+  using typename BaseType::BackendType;
+  using typename BaseType::MapperType;
+  using typename BaseType::EntityType;
+  using typename BaseType::IntersectionType;
+  using typename BaseType::BaseFunctionSetType;
+  using typename BaseType::CommunicatorType;
+  using typename BaseType::PatternType;
+
+  explicit Renumbered(GridViewType grid_view,
+                      const Mapper::Renumbering renumbering = Mapper::Renumbering::reverse_cuthill_mckee)
+    : Renumbered(SpaceType(grid_view), renumbering)
+  {}
+
+  explicit Renumbered(const SpaceType& space,
+                      const Mapper::Renumbering renumbering = Mapper::Renumbering::reverse_cuthill_mckee)
+    : space_(space)
+    , mapper_(space_.mapper(),
+              std::make_shared< const std::vector< size_t > >(
+                Mapper::compute_renumbering(renumbering, space_.grid_view(), space_.mapper())))
+  {}
+
+  /// \brief Copies the space and shares the renumbering.
+  Renumbered(const ThisType& other)
+    : space_(other.space_)
+    , mapper_(space_.mapper(), other.mapper_.new_indices())
+  {}
+
+  Renumbered(ThisType&& source)
+    : space_(std::move(source.space_))
+    , mapper_(space_.mapper(), source.mapper_.new_indices())
+  {}
+
+  ThisType& operator=(const ThisType& other) = delete;
+
+  ThisType& operator=(ThisType&& source) = delete;
+
+  /// \brief The space with the original numbering.
+  const SpaceType& space() const
+  {
+    return space_;
+  }
+
+  const GridViewType& grid_view() const
+  {
+    return space_.grid_view();
+  }
+
+  const BackendType& backend() const
+  {
+    return space_.backend();
+  }
+
+  const MapperType& mapper() const
+  {
+    return mapper_;
+  }
+
+  BaseFunctionSetType base_function_set(const EntityType& entity) const
+  {
+    return space_.base_function_set(entity);
+  }
+
+  CommunicatorType& communicator() const
+  {
+    return space_.communicator();
+  }
+
+  using BaseType::compute_pattern;
+
+  /// \brief The pattern of the underlying space, the rows of which are renumbered.
+  template< class G, class S, size_t d, size_t r, size_t rC >
+  PatternType compute_pattern(const GridView< G >& local_grid_view,
+                              const SpaceInterface< S, d, r, rC >& ansatz_space) const
+  {
+    // the columns are already given by the mapper of ansatz_space
+    const auto original = space_.compute_pattern(local_grid_view, ansatz_space);
+    const auto& new_indices = *mapper_.new_indices();
+    PatternType ret(original.size());
+    for (size_t ii = 0; ii < original.size(); ++ii)
+      ret.inner(new_indices[ii]) = original.inner(ii);
+    return ret;
+  } // ... compute_pattern(...)
+
+  using BaseType::local_constraints;
+
+  template< class S, size_t d, size_t r, size_t rC, class ConstraintsType >
+  void local_constraints(const SpaceInterface< S, d, r, rC >& /*other*/,
+                         const EntityType& /*entity*/,
+                         ConstraintsType& /*ret*/) const
+  {
+    static_assert(AlwaysFalse< S >::value, "Not implemented for these constraints!");
+  }
+
+  /// \note Requires the underlying space to be a CG space.
+  template< class S, size_t d, size_t r, size_t rC >
+  void local_constraints(const SpaceInterface< S, d, r, rC >& /*other*/,
+                         const EntityType& entity,
+                         DirichletConstraints< IntersectionType >& ret) const
+  {
+    const auto local_DoFs = space_.local_dirichlet_DoFs(entity, ret.boundary_info());
+    if (local_DoFs.size() > 0) {
+      const auto global_indices = mapper_.globalIndices(entity);
+      for (const auto& local_DoF : local_DoFs)
+        ret.insert(global_indices[local_DoF]);
+    }
+  } // ... local_constraints(..., Constraints::Dirichlet< ... > ...)
+
+private:
+  const SpaceType space_;
+  const MapperType mapper_;
+}; // class Renumbered
+
+
+} // namespace Spaces
+
+
+template< class S >
+struct fixed_num_dofs< Spaces::Renumbered< S > >
+  : public fixed_num_dofs< S >
+{};
+
+
+} // namespace GDT
+} // namespace Dune
+
+#endif // DUNE_GDT_SPACES_RENUMBERED_HH
@@ -8,6 +8,7 @@
 
 #include <type_traits>
 #include <limits>
+#include <memory>
 #include <mutex>
 
 #include <dune/common/deprecated.hh>
@@ -24,6 +25,7 @@
 
 #include <dune/stuff/common/float_cmp.hh>
 #include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/memory.hh>
 #include <dune/stuff/common/type_utils.hh>
 
 #include <dune/gdt/basefunctionset/pdelab.hh>
@@ -135,6 +137,7 @@ public:
   using typename BaseType::EntityType;
 private:
   typedef typename Traits::FEMapType FEMapType;
+  typedef typename BaseFunctionSetType::PoolType BaseFunctionSetPoolType;
 
 public:
   PdelabBased(GridViewType gV)
@@ -142,6 +145,7 @@ public:
     , fe_map_(grid_view_)
     , backend_(grid_view_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(CommunicationChooser< GridViewType >::create(grid_view_))
     , communicator_prepared_(false)
   {}
@@ -156,6 +160,7 @@ public:
     , fe_map_(grid_view_)
     , backend_(grid_view_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(CommunicationChooser< GridViewType >::create(grid_view_))
     , communicator_prepared_(false)
   {
@@ -174,6 +179,7 @@ public:
     , fe_map_(grid_view_)
     , backend_(grid_view_, fe_map_)
     , mapper_(backend_)
+    , base_function_set_pool_(DSC::make_unique< BaseFunctionSetPoolType >(backend_))
     , communicator_(std::move(source.communicator_))
     , communicator_prepared_(source.communicator_prepared_)
   {}
@@ -199,7 +205,7 @@ public:
 
   BaseFunctionSetType base_function_set(const EntityType& entity) const
   {
-    return BaseFunctionSetType(backend_, entity);
+    return BaseFunctionSetType(*base_function_set_pool_, entity);
   }
 
   CommunicatorType& communicator() const
@@ -238,6 +244,7 @@ private:
   const FEMapType fe_map_;
   const BackendType backend_;
   const MapperType mapper_;
+  const std::unique_ptr< BaseFunctionSetPoolType > base_function_set_pool_;
   mutable std::unique_ptr< CommunicatorType > communicator_;
   mutable bool communicator_prepared_;
   mutable std::mutex communicator_mutex_;
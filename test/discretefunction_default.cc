@@ -0,0 +1,35 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include <dune/stuff/test/main.hxx>
+
+#include "spaces_fv_default.hh"
+#include "spaces_dg_fem.hh"
+#include "discretefunction_default.hh"
+
+
+typedef testing::Types< SPACE_FV_YASPGRID(1, 1)
+                      , SPACE_FV_YASPGRID(2, 1)
+                      , SPACE_FV_YASPGRID(3, 1)
+#if HAVE_DUNE_FEM
+                      , SPACES_DG_FEM(1)
+                      , SPACES_DG_FEM(2)
+#endif // HAVE_DUNE_FEM
+#if HAVE_ALUGRID
+                      , SPACE_FV_ALUCONFORMGRID(2, 1)
+                      , SPACE_FV_ALUCUBEGRID(2, 1)
+# if HAVE_DUNE_FEM
+                      , SPACES_DG_FEM_ALUGRID(1)
+# endif // HAVE_DUNE_FEM
+#endif // HAVE_ALUGRID
+                      > SpaceTypes;
+
+TYPED_TEST_CASE(RebindableLocalDiscreteFunction, SpaceTypes);
+TYPED_TEST(RebindableLocalDiscreteFunction, coincides_with_local_discrete_function) {
+ this->coincides_with_local_discrete_function();
+}
+TYPED_TEST(RebindableLocalDiscreteFunction, survives_a_move) {
+ this->survives_a_move();
+}
@@ -0,0 +1,90 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_TEST_DISCRETEFUNCTION_DEFAULT_HH
+#define DUNE_GDT_TEST_DISCRETEFUNCTION_DEFAULT_HH
+
+#include <utility>
+#include <vector>
+
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/la/container.hh>
+#include <dune/stuff/test/gtest/gtest.h>
+
+#include <dune/gdt/discretefunction/default.hh>
+#include <dune/gdt/spaces/tools.hh>
+
+
+template< class SpaceType >
+class RebindableLocalDiscreteFunction
+  : public ::testing::Test
+{
+protected:
+  typedef typename SpaceType::GridViewType               GridViewType;
+  typedef typename GridViewType::Grid                    GridType;
+  typedef Dune::Stuff::Grid::Providers::Cube< GridType > GridProviderType;
+  typedef typename SpaceType::RangeFieldType             RangeFieldType;
+  typedef typename Dune::Stuff::LA::Container< RangeFieldType, Dune::Stuff::LA::default_backend >::VectorType
+      VectorType;
+  typedef Dune::GDT::ConstDiscreteFunction< SpaceType, VectorType > DiscreteFunctionType;
+
+public:
+  RebindableLocalDiscreteFunction()
+    : grid_provider_(0.0, 1.0, 3u)
+    , space_(Dune::GDT::SpaceTools::GridPartView< SpaceType >::create_leaf(grid_provider_.grid()))
+    , vector_(space_.mapper().size())
+  {
+    // some DoFs which are distinct on each entity
+    for (size_t ii = 0; ii < vector_.size(); ++ii)
+      vector_.set_entry(ii, RangeFieldType(1) + RangeFieldType(ii) / RangeFieldType(vector_.size()));
+  }
+
+  void coincides_with_local_discrete_function(const RangeFieldType& tolerance = 1e-15)
+  {
+    const DiscreteFunctionType discrete_function(space_, vector_);
+    auto rebindable_local_function = discrete_function.rebindable_local_discrete_function();
+    typedef typename decltype(rebindable_local_function)::DomainType        DomainType;
+    typedef typename decltype(rebindable_local_function)::RangeType         RangeType;
+    typedef typename decltype(rebindable_local_function)::JacobianRangeType JacobianRangeType;
+    std::vector< RangeType > values;
+    std::vector< JacobianRangeType > jacobians;
+    for (const auto& entity : Dune::Stuff::Common::entityRange(space_.grid_view())) {
+      const auto& geometry = entity.geometry();
+      const std::vector< DomainType > points = {geometry.local(geometry.center()), geometry.local(geometry.corner(0))};
+      const auto local_function = discrete_function.local_discrete_function(entity);
+      rebindable_local_function.bind(entity);
+      EXPECT_EQ(local_function->vector().size(), rebindable_local_function.size());
+      EXPECT_EQ(local_function->order(), rebindable_local_function.order());
+      rebindable_local_function.evaluate(points, values);
+      rebindable_local_function.jacobian(points, jacobians);
+      for (size_t qq = 0; qq < points.size(); ++qq) {
+        EXPECT_LE((local_function->evaluate(points[qq]) - values[qq]).two_norm(), tolerance);
+        EXPECT_LE((local_function->jacobian(points[qq]) - jacobians[qq]).frobenius_norm(), tolerance);
+      }
+    }
+  } // ... coincides_with_local_discrete_function(...)
+
+  void survives_a_move(const RangeFieldType& tolerance = 1e-15)
+  {
+    const DiscreteFunctionType discrete_function(space_, vector_);
+    const auto entity_it = space_.grid_view().template begin< 0 >();
+    const auto& entity = *entity_it;
+    const auto point = entity.geometry().local(entity.geometry().center());
+    auto bound_local_function = discrete_function.rebindable_local_discrete_function();
+    bound_local_function.bind(entity);
+    const auto expected = bound_local_function.evaluate(point);
+    const auto moved_local_function = std::move(bound_local_function);
+    EXPECT_LE((moved_local_function.evaluate(point) - expected).two_norm(), tolerance);
+  } // ... survives_a_move(...)
+
+protected:
+  GridProviderType grid_provider_;
+  const SpaceType space_;
+  VectorType vector_;
+}; // class RebindableLocalDiscreteFunction
+
+
+#endif // DUNE_GDT_TEST_DISCRETEFUNCTION_DEFAULT_HH
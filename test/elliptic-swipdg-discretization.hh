@@ -351,7 +351,8 @@ public:
         compute_reference_solution();
       timer.reset();
       const auto reference_grid_view = test_.reference_grid_view();
-      const Operators::Prolongation< GridViewType > prolongation_operator(reference_grid_view);
+      const Operators::Prolongation< GridViewType >
+          prolongation_operator(reference_grid_view, Operators::ProlongationSearch::hierarchical);
       assert(reference_discretization_);
       if (!current_solution_vector_)
         current_solution_vector_
@@ -0,0 +1,46 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_ISTL
+
+#include "spaces_fv_default.hh"
+#include "la_istl_block.hh"
+
+
+typedef testing::Types< SPACE_FV_YASPGRID(1, 2)
+                      , SPACE_FV_YASPGRID(2, 2)
+                      , SPACE_FV_YASPGRID(2, 3)
+                      , SPACE_FV_YASPGRID(3, 3)
+                      > VectorValuedSpaces;
+
+TYPED_TEST_CASE(BlockedAssembly, VectorValuedSpaces);
+TYPED_TEST(BlockedAssembly, collapses_the_pattern) {
+  this->collapses_the_pattern();
+}
+TYPED_TEST(BlockedAssembly, scatter_coincides_with_entrywise_scatter) {
+  this->scatter_coincides_with_entrywise_scatter();
+}
+TYPED_TEST(BlockedAssembly, assembled_product_coincides_with_dense_product) {
+  this->assembled_product_coincides_with_dense_product();
+}
+TYPED_TEST(BlockedAssembly, mv_coincides_with_dense_mv) {
+  this->mv_coincides_with_dense_mv();
+}
+TYPED_TEST(BlockedAssembly, backend_can_be_used_natively) {
+  this->backend_can_be_used_natively();
+}
+
+#else // HAVE_DUNE_ISTL
+
+TEST(DISABLED_BlockedAssembly, collapses_the_pattern)                          {}
+TEST(DISABLED_BlockedAssembly, scatter_coincides_with_entrywise_scatter)       {}
+TEST(DISABLED_BlockedAssembly, assembled_product_coincides_with_dense_product) {}
+TEST(DISABLED_BlockedAssembly, mv_coincides_with_dense_mv)                     {}
+TEST(DISABLED_BlockedAssembly, backend_can_be_used_natively)                   {}
+
+#endif // HAVE_DUNE_ISTL
@@ -0,0 +1,202 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_TEST_LA_ISTL_BLOCK_HH
+#define DUNE_GDT_TEST_LA_ISTL_BLOCK_HH
+
+#include <algorithm>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/la/container/common.hh>
+#include <dune/stuff/la/container/istl.hh>
+#include <dune/stuff/test/gtest/gtest.h>
+
+#include <dune/gdt/assembler/local/scatter.hh>
+#include <dune/gdt/la/istl-block.hh>
+#include <dune/gdt/products/l2.hh>
+#include <dune/gdt/spaces/tools.hh>
+
+
+/**
+ * \brief Checks IstlBlockMatrix against a dense matrix, with blocks of the size of the range of an FV space.
+ */
+template< class SpaceType >
+class BlockedAssembly
+  : public ::testing::Test
+{
+protected:
+  typedef typename SpaceType::GridViewType                                          GridViewType;
+  typedef typename GridViewType::Grid                                               GridType;
+  typedef Dune::Stuff::Grid::Providers::Cube< GridType >                            GridProviderType;
+  typedef typename SpaceType::RangeFieldType                                        RangeFieldType;
+  static const size_t                                                               block_size = SpaceType::dimRange;
+  typedef Dune::GDT::LA::IstlBlockMatrix< RangeFieldType, block_size >              BlockMatrixType;
+  typedef Dune::Stuff::LA::CommonDenseMatrix< RangeFieldType >                      DenseMatrixType;
+  typedef Dune::Stuff::LA::IstlDenseVector< RangeFieldType >                        VectorType;
+  typedef Dune::BlockVector< Dune::FieldVector< RangeFieldType, int(block_size) > > BlockVectorType;
+
+public:
+  BlockedAssembly()
+    : grid_provider_(0.0, 1.0, 3u)
+    , space_(Dune::GDT::SpaceTools::GridPartView< SpaceType >::create_leaf(grid_provider_.grid()))
+    , size_(space_.mapper().size())
+    , vector_(size_)
+  {
+    for (size_t ii = 0; ii < size_; ++ii)
+      vector_.set_entry(ii, RangeFieldType(1) + RangeFieldType(ii) / RangeFieldType(size_));
+  }
+
+  void collapses_the_pattern() const
+  {
+    const auto pattern = space_.compute_face_and_volume_pattern();
+    const auto blocks = Dune::GDT::LA::block_pattern(pattern, block_size);
+    ASSERT_EQ(size_ / block_size, blocks.size());
+    size_t num_entries = 0;
+    for (size_t ii = 0; ii < pattern.size(); ++ii) {
+      num_entries += pattern.inner(ii).size();
+      const auto& block_row = blocks.inner(ii / block_size);
+      for (const auto& jj : pattern.inner(ii))
+        EXPECT_TRUE(std::binary_search(block_row.begin(), block_row.end(), jj / block_size));
+    }
+    // the DoFs of each entity form a block
+    size_t num_blocks = 0;
+    for (size_t bb = 0; bb < blocks.size(); ++bb)
+      num_blocks += blocks.inner(bb).size();
+    EXPECT_EQ(num_entries, num_blocks * block_size * block_size);
+    const BlockMatrixType matrix(size_, size_, pattern);
+    EXPECT_EQ(blocks.size(), matrix.backend().N());
+    EXPECT_EQ(num_blocks, matrix.backend().nonzeroes());
+    EXPECT_THROW(BlockMatrixType(size_ + 1, size_, pattern), Dune::Stuff::Exceptions::shapes_do_not_match);
+    // the pattern of the blocks can be computed directly
+    const auto direct_blocks = space_.compute_block_pattern(block_size, true);
+    ASSERT_EQ(blocks.size(), direct_blocks.size());
+    for (size_t bb = 0; bb < blocks.size(); ++bb)
+      EXPECT_EQ(blocks.inner(bb), direct_blocks.inner(bb));
+    const auto volume_blocks = Dune::GDT::LA::block_pattern(space_.compute_volume_pattern(), block_size);
+    const auto direct_volume_blocks = space_.compute_block_pattern(block_size, false);
+    ASSERT_EQ(volume_blocks.size(), direct_volume_blocks.size());
+    for (size_t bb = 0; bb < volume_blocks.size(); ++bb)
+      EXPECT_EQ(volume_blocks.inner(bb), direct_volume_blocks.inner(bb));
+    const auto block_matrix = Dune::GDT::LA::make_block_matrix< block_size >(space_);
+    EXPECT_EQ(num_blocks, block_matrix.backend().nonzeroes());
+    EXPECT_THROW(BlockMatrixType::from_block_pattern(size_ + block_size, size_, blocks),
+                 Dune::Stuff::Exceptions::shapes_do_not_match);
+  } // ... collapses_the_pattern(...)
+
+  void scatter_coincides_with_entrywise_scatter() const
+  {
+    const auto pattern = space_.compute_face_and_volume_pattern();
+    for (const bool upper_triangle : {false, true}) {
+      BlockMatrixType block_matrix(size_, size_, pattern);
+      DenseMatrixType dense_matrix(size_, size_, pattern);
+      Dune::DynamicMatrix< RangeFieldType > local_matrix(block_size, block_size);
+      Dune::DynamicVector< size_t > rows(block_size);
+      Dune::DynamicVector< size_t > cols(block_size);
+      Dune::DynamicVector< size_t > permutation(block_size);
+      for (const auto& entity : Dune::Stuff::Common::entityRange(space_.grid_view())) {
+        space_.mapper().globalIndices(entity, rows);
+        const auto intersection_it_end = space_.grid_view().iend(entity);
+        for (auto intersection_it = space_.grid_view().ibegin(entity);
+             intersection_it != intersection_it_end;
+             ++intersection_it) {
+          const auto& intersection = *intersection_it;
+          if (!intersection.neighbor())
+            continue;
+          const auto neighbor_ptr = intersection.outside();
+          space_.mapper().globalIndices(*neighbor_ptr, cols);
+          for (size_t ii = 0; ii < block_size; ++ii)
+            for (size_t jj = 0; jj < block_size; ++jj)
+              local_matrix[ii][jj] = RangeFieldType(1 + rows[ii]) / RangeFieldType(1 + cols[jj]);
+          Dune::GDT::LocalAssembler::internal::Scatter< BlockMatrixType >::add(
+              local_matrix, rows, block_size, cols, block_size, permutation, block_matrix, upper_triangle);
+          Dune::GDT::LocalAssembler::internal::Scatter< DenseMatrixType >::add(
+              local_matrix, rows, block_size, cols, block_size, permutation, dense_matrix, upper_triangle);
+        }
+      }
+      for (size_t ii = 0; ii < size_; ++ii)
+        for (size_t jj = 0; jj < size_; ++jj)
+          EXPECT_DOUBLE_EQ(dense_matrix.get_entry(ii, jj), block_matrix.get_entry(ii, jj));
+    }
+  } // ... scatter_coincides_with_entrywise_scatter(...)
+
+  void assembled_product_coincides_with_dense_product() const
+  {
+    Dune::GDT::Products::L2Assemblable< DenseMatrixType, SpaceType > dense_product(space_);
+    dense_product.assemble(false);
+    // the product creates the block matrix from the scalar pattern itself
+    Dune::GDT::Products::L2Assemblable< BlockMatrixType, SpaceType > block_product(space_);
+    block_product.assemble(true);
+    const auto& block_matrix = block_product.matrix();
+    EXPECT_EQ(size_t(space_.grid_view().size(0)), block_matrix.backend().nonzeroes());
+    for (size_t ii = 0; ii < size_; ++ii)
+      for (size_t jj = 0; jj < size_; ++jj)
+        EXPECT_DOUBLE_EQ(dense_product.matrix().get_entry(ii, jj), block_matrix.get_entry(ii, jj));
+    EXPECT_DOUBLE_EQ(dense_product.apply2(vector_, vector_), block_product.apply2(vector_, vector_));
+    // the same for an externally provided matrix
+    auto external_matrix = Dune::GDT::LA::make_block_matrix< block_size >(space_);
+    Dune::GDT::Products::L2Assemblable< BlockMatrixType, SpaceType > external_product(external_matrix, space_);
+    external_product.assemble(false);
+    for (size_t ii = 0; ii < size_; ++ii)
+      for (size_t jj = 0; jj < size_; ++jj)
+        EXPECT_DOUBLE_EQ(block_matrix.get_entry(ii, jj), external_matrix.get_entry(ii, jj));
+  } // ... assembled_product_coincides_with_dense_product(...)
+
+  void mv_coincides_with_dense_mv() const
+  {
+    BlockMatrixType block_matrix(size_, size_, space_.compute_face_and_volume_pattern());
+    DenseMatrixType dense_matrix(size_, size_, space_.compute_face_and_volume_pattern());
+    fill(block_matrix, dense_matrix);
+    VectorType block_result(size_);
+    VectorType dense_result(size_);
+    block_matrix.mv(vector_, block_result);
+    dense_matrix.mv(vector_, dense_result);
+    for (size_t ii = 0; ii < size_; ++ii)
+      EXPECT_DOUBLE_EQ(dense_result.get_entry(ii), block_result.get_entry(ii));
+  } // ... mv_coincides_with_dense_mv(...)
+
+  void backend_can_be_used_natively() const
+  {
+    BlockMatrixType block_matrix(size_, size_, space_.compute_face_and_volume_pattern());
+    DenseMatrixType dense_matrix(size_, size_, space_.compute_face_and_volume_pattern());
+    fill(block_matrix, dense_matrix);
+    const BlockVectorType block_source = Dune::GDT::LA::to_block_vector< block_size >(vector_);
+    ASSERT_EQ(size_ / block_size, block_source.size());
+    for (size_t ii = 0; ii < size_; ++ii)
+      EXPECT_EQ(vector_.get_entry(ii), block_source[ii / block_size][ii % block_size]);
+    BlockVectorType block_range(block_source.size());
+    block_matrix.backend().mv(block_source, block_range);
+    VectorType result(size_);
+    Dune::GDT::LA::from_block_vector(block_range, result);
+    VectorType dense_result(size_);
+    dense_matrix.mv(vector_, dense_result);
+    for (size_t ii = 0; ii < size_; ++ii)
+      EXPECT_DOUBLE_EQ(dense_result.get_entry(ii), result.get_entry(ii));
+  } // ... backend_can_be_used_natively(...)
+
+private:
+  void fill(BlockMatrixType& block_matrix, DenseMatrixType& dense_matrix) const
+  {
+    const auto pattern = space_.compute_face_and_volume_pattern();
+    for (size_t ii = 0; ii < pattern.size(); ++ii)
+      for (const auto& jj : pattern.inner(ii)) {
+        const RangeFieldType value = RangeFieldType(1 + ii) / RangeFieldType(2 + jj);
+        block_matrix.set_entry(ii, jj, value);
+        dense_matrix.set_entry(ii, jj, value);
+      }
+  } // ... fill(...)
+
+protected:
+  GridProviderType grid_provider_;
+  const SpaceType space_;
+  const size_t size_;
+  VectorType vector_;
+}; // class BlockedAssembly
+
+
+#endif // DUNE_GDT_TEST_LA_ISTL_BLOCK_HH
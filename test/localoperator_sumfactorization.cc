@@ -0,0 +1,93 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_PDELAB && HAVE_EIGEN
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/functions/constant.hh>
+#include <dune/stuff/la/container/eigen.hh>
+
+#include <dune/gdt/spaces/cg.hh>
+#include <dune/gdt/assembler/system.hh>
+#include <dune/gdt/localevaluation/elliptic.hh>
+#include <dune/gdt/localevaluation/product.hh>
+#include <dune/gdt/localoperator/codim0.hh>
+#include <dune/gdt/localoperator/sumfactorization.hh>
+
+using namespace Dune;
+using namespace Dune::GDT;
+
+
+template< class SpaceType, class EvaluationType, class... Args >
+void check_sum_factorized_integral(const SpaceType& space, Args&& ...args)
+{
+  typedef Stuff::LA::EigenRowMajorSparseMatrix< double > MatrixType;
+  typedef LocalOperator::Codim0Integral< EvaluationType >               LocalOperatorType;
+  typedef LocalOperator::Codim0SumFactorizedIntegral< EvaluationType >  SumFactorizedLocalOperatorType;
+  const LocalOperatorType local_operator(std::forward< Args >(args)...);
+  const SumFactorizedLocalOperatorType sum_factorized_local_operator(std::forward< Args >(args)...);
+  const LocalAssembler::Codim0Matrix< LocalOperatorType > local_assembler(local_operator);
+  const LocalAssembler::Codim0Matrix< SumFactorizedLocalOperatorType >
+      sum_factorized_local_assembler(sum_factorized_local_operator);
+  MatrixType matrix(space.mapper().size(), space.mapper().size(), space.compute_volume_pattern());
+  MatrixType sum_factorized_matrix(space.mapper().size(), space.mapper().size(), space.compute_volume_pattern());
+  SystemAssembler< SpaceType > system_assembler(space);
+  system_assembler.add(local_assembler, matrix);
+  system_assembler.add(sum_factorized_local_assembler, sum_factorized_matrix);
+  system_assembler.assemble();
+  auto difference = matrix.copy();
+  difference.backend() -= sum_factorized_matrix.backend();
+  EXPECT_LE(difference.sup_norm(), 1e-12 * matrix.sup_norm());
+} // ... check_sum_factorized_integral(...)
+
+
+template< size_t d, int p >
+void sum_factorized_integral_coincides_with_integral()
+{
+  typedef YaspGrid< d, EquidistantOffsetCoordinates< double, d > > GridType;
+  typedef typename GridType::template Codim< 0 >::Entity E;
+  auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create();
+  typedef Spaces::CGProvider< GridType, Stuff::Grid::ChooseLayer::leaf, ChooseSpaceBackend::pdelab, p, double, 1 >
+      SpaceProvider;
+  auto space = SpaceProvider::create(*grid_provider);
+  typedef typename SpaceProvider::Type SpaceType;
+  typedef Stuff::Functions::Constant< E, double, d, double, 1 >    ScalarFunctionType;
+  typedef Stuff::Functions::Constant< E, double, d, double, d, d > TensorFunctionType;
+  const ScalarFunctionType factor(17);
+  const TensorFunctionType tensor(42);
+  check_sum_factorized_integral
+      < SpaceType, LocalEvaluation::Elliptic< ScalarFunctionType, TensorFunctionType > >(space, factor, tensor);
+  check_sum_factorized_integral
+      < SpaceType, LocalEvaluation::Product< ScalarFunctionType > >(space, factor);
+} // ... sum_factorized_integral_coincides_with_integral(...)
+
+
+TEST(Codim0SumFactorizedIntegral, coincides_with_Codim0Integral_2d_Q1)
+{
+  sum_factorized_integral_coincides_with_integral< 2, 1 >();
+}
+
+TEST(Codim0SumFactorizedIntegral, coincides_with_Codim0Integral_2d_Q2)
+{
+  sum_factorized_integral_coincides_with_integral< 2, 2 >();
+}
+
+TEST(Codim0SumFactorizedIntegral, coincides_with_Codim0Integral_3d_Q2)
+{
+  sum_factorized_integral_coincides_with_integral< 3, 2 >();
+}
+
+#else // HAVE_DUNE_PDELAB && HAVE_EIGEN
+
+TEST(DISABLED_Codim0SumFactorizedIntegral, coincides_with_Codim0Integral_2d_Q1) {}
+TEST(DISABLED_Codim0SumFactorizedIntegral, coincides_with_Codim0Integral_2d_Q2) {}
+TEST(DISABLED_Codim0SumFactorizedIntegral, coincides_with_Codim0Integral_3d_Q2) {}
+
+#endif // HAVE_DUNE_PDELAB && HAVE_EIGEN
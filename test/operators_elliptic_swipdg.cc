@@ -8,50 +8,20 @@
 
 #if HAVE_DUNE_FEM && HAVE_EIGEN
 
-#include <dune/grid/yaspgrid.hh>
+#include <algorithm>
 
-#include <dune/stuff/grid/provider/cube.hh>
-#include <dune/stuff/functions/constant.hh>
-#include <dune/stuff/la/container.hh>
-#include <dune/stuff/grid/boundaryinfo.hh>
+#include "operators_elliptic_swipdg.hh"
 
-#include <dune/gdt/spaces/dg.hh>
-#include <dune/gdt/playground/operators/elliptic-swipdg.hh>
 
-using namespace Dune;
-using namespace Dune::GDT;
-
-
-TEST(EllipticSWIPDGOperator, is_affinely_decomposable)
+TEST_F(EllipticSWIPDGOperator, is_affinely_decomposable)
 {
-  static const size_t d = 2;
-  typedef YaspGrid< d, EquidistantOffsetCoordinates<double,d>> GridType;
-  typedef GridType::template Codim< 0 >::Entity E;
-  typedef GridType::ctype D;
-  typedef double R;
-  static const size_t r = 1;
-  auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create();
-  typedef Spaces::DiscontinuousLagrangeProvider< GridType,
-                                                 Stuff::Grid::ChooseLayer::leaf,
-                                                 ChooseSpaceBackend::fem,
-                                                 1, R, r > SpaceProvider;
-  typedef SpaceProvider::Type SpaceType;
-  auto space = SpaceProvider::create(*grid_provider);
-
-  typedef typename SpaceType::GridViewType GridViewType;
-  auto boundary_info = Stuff::Grid::BoundaryInfos::AllDirichlet< typename GridViewType::Intersection >::create();
-
-  typedef Stuff::Functions::Constant< E, D, d, R, r >    ScalarFunctionType;
-  typedef Stuff::Functions::Constant< E, D, d, R, d, d > TensorFunctionType;
   ScalarFunctionType one(17);
   TensorFunctionType tensor(42);
 
   auto two = Stuff::Functions::make_sum(one, one);
 
-  typedef Stuff::LA::Container< R >::MatrixType MatrixType;
-
-  auto one_op = Operators::make_elliptic_swipdg(one, tensor, *boundary_info, MatrixType(), space);
-  auto two_op = Operators::make_elliptic_swipdg(*two, tensor, *boundary_info, MatrixType(), space);
+  auto one_op = Operators::make_elliptic_swipdg(one, tensor, *boundary_info_, MatrixType(), space_);
+  auto two_op = Operators::make_elliptic_swipdg(*two, tensor, *boundary_info_, MatrixType(), space_);
 
   one_op->add(*two_op);
   one_op->assemble();
@@ -61,10 +31,135 @@ TEST(EllipticSWIPDGOperator, is_affinely_decomposable)
 
   tmp.backend() -= two_op->matrix().backend();
   EXPECT_EQ(0.0, tmp.sup_norm());
-} // TEST(EllipticSWIPDGOperator, is_affinely_decomposable)
+} // TEST_F(EllipticSWIPDGOperator, is_affinely_decomposable)
+
+
+TEST_F(EllipticSWIPDGOperator, parallel_assembly_coincides_with_serial_assembly)
+{
+  auto serial_op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  auto colored_op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  auto thread_local_op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  serial_op->assemble();
+  colored_op->assemble_colored();
+  // the matrix must not be assembled a second time
+  colored_op->assemble();
+  thread_local_op->assemble_with_thread_local_copies();
+  thread_local_op->assemble();
+
+  auto difference = serial_op->matrix().copy();
+  difference.backend() -= colored_op->matrix().backend();
+  EXPECT_LE(difference.sup_norm(), 1e-13 * serial_op->matrix().sup_norm());
+  difference = serial_op->matrix().copy();
+  difference.backend() -= thread_local_op->matrix().backend();
+  EXPECT_LE(difference.sup_norm(), 1e-13 * serial_op->matrix().sup_norm());
+} // TEST_F(EllipticSWIPDGOperator, parallel_assembly_coincides_with_serial_assembly)
+
+
+TEST_F(EllipticSWIPDGOperator, matrix_free_application_coincides_with_matrix)
+{
+  auto op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  op->assemble();
+  const VectorType source = some_vector();
+  VectorType range(space_.mapper().size());
+  VectorType matrix_free_range(space_.mapper().size());
+  op->matrix().mv(source, range);
+  op->apply_matrix_free(source, matrix_free_range);
+  const R norm = range.sup_norm();
+  range.axpy(-1., matrix_free_range);
+  EXPECT_LE(range.sup_norm(), 1e-13 * norm);
+} // TEST_F(EllipticSWIPDGOperator, matrix_free_application_coincides_with_matrix)
+
+
+TEST_F(EllipticSWIPDGOperator, matrix_free_operator_coincides_with_matrix)
+{
+  const VectorType source = some_vector();
+  VectorType range(space_.mapper().size());
+  VectorType matrix_free_range(space_.mapper().size());
+  // with a diffusion factor and tensor
+  auto op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  op->assemble();
+  op->matrix().mv(source, range);
+  R norm = range.sup_norm();
+  const auto matrix_free_op = Operators::make_elliptic_swipdg_matrix_free(one_, tensor_, *boundary_info_, space_);
+  // the second application reuses the storage of the first one
+  for (size_t ii = 0; ii < 2; ++ii) {
+    matrix_free_op->apply(source, matrix_free_range);
+    matrix_free_range.axpy(-1., range);
+    EXPECT_LE(matrix_free_range.sup_norm(), 1e-13 * norm);
+  }
+  // with a scalar diffusion only, walking the partitions of a traversal
+  auto scalar_op = Operators::make_elliptic_swipdg(one_, *boundary_info_, MatrixType(), space_);
+  scalar_op->assemble();
+  scalar_op->matrix().mv(source, range);
+  norm = range.sup_norm();
+  typedef Operators::EllipticSWIPDGMatrixFree< ScalarFunctionType, SpaceType > MatrixFreeOperatorType;
+  const MatrixFreeOperatorType::TraversalType traversal(space_.grid_view());
+  const MatrixFreeOperatorType matrix_free_scalar_op(one_, *boundary_info_, space_,
+                                                     LocalEvaluation::SIPDG::internal::default_beta(d), &traversal);
+  matrix_free_scalar_op.apply(source, matrix_free_range);
+  matrix_free_range.axpy(-1., range);
+  EXPECT_LE(matrix_free_range.sup_norm(), 1e-13 * norm);
+} // TEST_F(EllipticSWIPDGOperator, matrix_free_operator_coincides_with_matrix)
+
+
+TEST_F(EllipticSWIPDGOperator, reassembly_coincides_with_assembly)
+{
+  auto op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  op->assemble();
+  const auto assembled = op->matrix().copy();
+  // the first reassembly computes the offsets of all volume and face contributions
+  op->reassemble();
+  const auto offsets = op->scatter_offsets(op->matrix());
+  ASSERT_TRUE(bool(offsets));
+  EXPECT_TRUE(offsets->includes_faces());
+  EXPECT_TRUE(offsets->fits(op->matrix()));
+  // the couplings are stored once per pair of neighbors
+  const auto entity_it = space_.grid_view().begin< 0 >();
+  const auto& entity = *entity_it;
+  for (auto intersection_it = space_.grid_view().ibegin(entity);
+       intersection_it != space_.grid_view().iend(entity);
+       ++intersection_it) {
+    if (!intersection_it->neighbor())
+      continue;
+    const auto neighbor_ptr = intersection_it->outside();
+    const auto coupling = offsets->coupling(entity, *neighbor_ptr);
+    const auto reverse_coupling = offsets->coupling(*neighbor_ptr, entity);
+    EXPECT_EQ(coupling.entity_entity, reverse_coupling.neighbor_neighbor);
+    EXPECT_EQ(coupling.entity_neighbor, reverse_coupling.neighbor_entity);
+    EXPECT_EQ(coupling.neighbor_entity, reverse_coupling.entity_neighbor);
+  }
+  // a pattern of the same shape and number of nonzeros does not fit
+  const auto pattern = space_.compute_face_and_volume_pattern();
+  Stuff::LA::SparsityPatternDefault shifted_pattern(pattern.size());
+  for (size_t ii = 0; ii < pattern.size(); ++ii) {
+    auto& row = shifted_pattern.inner(ii);
+    for (const auto& jj : pattern.inner(ii))
+      row.push_back((jj + 1) % pattern.size());
+    std::sort(row.begin(), row.end());
+  }
+  MatrixType shifted(pattern.size(), pattern.size(), shifted_pattern);
+  ASSERT_EQ(op->matrix().backend().nonZeros(), shifted.backend().nonZeros());
+  EXPECT_FALSE(offsets->fits(shifted));
+  auto difference = assembled.copy();
+  difference.backend() -= op->matrix().backend();
+  EXPECT_LE(difference.sup_norm(), 1e-13 * assembled.sup_norm());
+  // the offsets may be shared by other operators with the same pattern
+  auto other_op = Operators::make_elliptic_swipdg(one_, tensor_, *boundary_info_, MatrixType(), space_);
+  other_op->assemble();
+  other_op->set_scatter_offsets(other_op->matrix(), offsets);
+  other_op->reassemble();
+  EXPECT_EQ(offsets, other_op->scatter_offsets(other_op->matrix()));
+  difference = assembled.copy();
+  difference.backend() -= other_op->matrix().backend();
+  EXPECT_LE(difference.sup_norm(), 1e-13 * assembled.sup_norm());
+} // TEST_F(EllipticSWIPDGOperator, reassembly_coincides_with_assembly)
 
 #else // HAVE_DUNE_FEM && HAVE_EIGEN
 
 TEST(DISABLED_EllipticSWIPDGOperator, is_affinely_decomposable) {}
+TEST(DISABLED_EllipticSWIPDGOperator, parallel_assembly_coincides_with_serial_assembly) {}
+TEST(DISABLED_EllipticSWIPDGOperator, matrix_free_application_coincides_with_matrix) {}
+TEST(DISABLED_EllipticSWIPDGOperator, matrix_free_operator_coincides_with_matrix) {}
+TEST(DISABLED_EllipticSWIPDGOperator, reassembly_coincides_with_assembly) {}
 
 #endif
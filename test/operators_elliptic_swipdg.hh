@@ -0,0 +1,77 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_GDT_TEST_OPERATORS_ELLIPTIC_SWIPDG_HH
+#define DUNE_GDT_TEST_OPERATORS_ELLIPTIC_SWIPDG_HH
+
+#include <memory>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/functions/constant.hh>
+#include <dune/stuff/la/container.hh>
+#include <dune/stuff/grid/boundaryinfo.hh>
+#include <dune/stuff/test/gtest/gtest.h>
+
+#include <dune/gdt/spaces/dg.hh>
+#include <dune/gdt/playground/operators/elliptic-swipdg.hh>
+
+using namespace Dune;
+using namespace Dune::GDT;
+
+
+/**
+ * \brief A DG space of piecewise linear functions on a cube grid with Dirichlet boundary, and a constant diffusion
+ *        factor and tensor, for the tests of EllipticSWIPDG.
+ */
+struct EllipticSWIPDGOperator
+  : public ::testing::Test
+{
+  static const size_t d = 2;
+  typedef YaspGrid< d, EquidistantOffsetCoordinates< double, d > > GridType;
+  typedef GridType::Codim< 0 >::Entity                              E;
+  typedef GridType::ctype                                           D;
+  typedef double                                                    R;
+  static const size_t                                               r = 1;
+  typedef Stuff::Grid::Providers::Cube< GridType >                  GridProviderType;
+  typedef Spaces::DiscontinuousLagrangeProvider< GridType,
+                                                 Stuff::Grid::ChooseLayer::leaf,
+                                                 ChooseSpaceBackend::fem,
+                                                 1, R, r >          SpaceProvider;
+  typedef SpaceProvider::Type                                       SpaceType;
+  typedef SpaceType::GridViewType                                   GridViewType;
+  typedef Stuff::Grid::BoundaryInfos::AllDirichlet< GridViewType::Intersection > BoundaryInfoType;
+  typedef Stuff::Functions::Constant< E, D, d, R, r >               ScalarFunctionType;
+  typedef Stuff::Functions::Constant< E, D, d, R, d, d >            TensorFunctionType;
+  typedef Stuff::LA::Container< R >::MatrixType                     MatrixType;
+  typedef Stuff::LA::Container< R >::VectorType                     VectorType;
+
+  EllipticSWIPDGOperator()
+    : grid_provider_(GridProviderType::create())
+    , space_(SpaceProvider::create(*grid_provider_))
+    , boundary_info_(BoundaryInfoType::create())
+    , one_(1)
+    , tensor_(1)
+  {}
+
+  /// \brief A vector of the size of the space with some nonzero entries.
+  VectorType some_vector() const
+  {
+    VectorType ret(space_.mapper().size());
+    for (size_t ii = 0; ii < ret.size(); ++ii)
+      ret.set_entry(ii, R(ii % 7) - 3.);
+    return ret;
+  }
+
+  std::unique_ptr< GridProviderType > grid_provider_;
+  const SpaceType space_;
+  std::unique_ptr< BoundaryInfoType > boundary_info_;
+  const ScalarFunctionType one_;
+  const TensorFunctionType tensor_;
+}; // struct EllipticSWIPDGOperator
+
+
+#endif // DUNE_GDT_TEST_OPERATORS_ELLIPTIC_SWIPDG_HH
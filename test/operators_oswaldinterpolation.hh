@@ -63,6 +63,14 @@ struct Oswald_Interpolation_Operator
     Operators::OswaldInterpolation< typename SpaceType::GridViewType > oswald_operator(space.grid_view());
     oswald_operator.apply(source, range);
     // TODO: test result
+    // applying the operator again (with the cached incidence) has to give the same result
+    VectorType second_range_vector(space.mapper().size(), 1.0);
+    DiscreteFunctionType second_range(space, second_range_vector);
+    oswald_operator.apply(source, second_range);
+    EXPECT_LE((second_range_vector - range_vector).sup_norm(), 1e-15);
+    // the result is continuous and vanishes on the boundary, so the operator has to reproduce it
+    oswald_operator.apply(range, second_range);
+    EXPECT_LE((second_range_vector - range_vector).sup_norm(), 1e-14);
   } // ... produces_correct_results()
 }; // struct Oswald_Interpolation_Operator
 
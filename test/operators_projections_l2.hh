@@ -26,6 +26,24 @@ public:
     Dune::GDT::project_l2(this->function_, this->discrete_function_);
     this->measure_error(tolerance);
   }
+
+  void repeated_and_traversal_wise_projections_coincide(const RangeFieldType& tolerance = 1e-15)
+  {
+    typedef Dune::GDT::Operators::L2Projection< typename SpaceType::GridViewType > L2ProjectionType;
+    const auto& grid_view = this->space_.grid_view();
+    this->vector_ *= 0.0;
+    L2ProjectionType(grid_view).apply(this->function_, this->discrete_function_);
+    const auto expected = this->vector_.copy();
+    // uses the cached local mass matrices of the first projection
+    this->vector_ *= 0.0;
+    L2ProjectionType(grid_view).apply(this->function_, this->discrete_function_);
+    EXPECT_LE((this->vector_ - expected).sup_norm(), tolerance);
+    // walks the partitions of the traversal (in parallel, if possible)
+    const typename L2ProjectionType::TraversalType traversal(grid_view);
+    this->vector_ *= 0.0;
+    L2ProjectionType(grid_view, 0, &traversal).apply(this->function_, this->discrete_function_);
+    EXPECT_LE((this->vector_ - expected).sup_norm(), tolerance);
+  } // ... repeated_and_traversal_wise_projections_coincide(...)
 };
 
 
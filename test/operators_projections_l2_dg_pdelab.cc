@@ -24,6 +24,9 @@ TYPED_TEST(L2ProjectionOperator, produces_correct_results) {
 TYPED_TEST(L2ProjectionOperator, free_project_l2_function_works) {
  this->free_project_l2_function_works();
 }
+TYPED_TEST(L2ProjectionOperator, repeated_and_traversal_wise_projections_coincide) {
+ this->repeated_and_traversal_wise_projections_coincide();
+}
 
 TYPED_TEST_CASE(ProjectionOperator, SpaceTypes);
 TYPED_TEST(ProjectionOperator, produces_correct_results) {
@@ -39,6 +42,7 @@ TYPED_TEST(ProjectionOperator, free_project_function_works) {
 
 TEST(DISABLED_L2ProjectionOperator, produces_correct_results) {}
 TEST(DISABLED_L2ProjectionOperator, free_project_l2_function_works) {}
+TEST(DISABLED_L2ProjectionOperator, repeated_and_traversal_wise_projections_coincide) {}
 TEST(DISABLED_ProjectionOperator, produces_correct_results) {}
 TEST(DISABLED_ProjectionOperator, free_project_function_works) {}
 
@@ -27,6 +27,9 @@ TYPED_TEST(L2ProjectionOperator, produces_correct_results) {
 TYPED_TEST(L2ProjectionOperator, free_project_l2_function_works) {
  this->free_project_l2_function_works(0.096226);
 }
+TYPED_TEST(L2ProjectionOperator, repeated_and_traversal_wise_projections_coincide) {
+ this->repeated_and_traversal_wise_projections_coincide();
+}
 
 TYPED_TEST_CASE(ProjectionOperator, SpaceTypes);
 TYPED_TEST(ProjectionOperator, produces_correct_results) {
@@ -0,0 +1,254 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <vector>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/functions/expression.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/la/container/common.hh>
+
+#include <dune/gdt/discretefunction/default.hh>
+#include <dune/gdt/operators/projections.hh>
+#include <dune/gdt/operators/prolongations.hh>
+#include <dune/gdt/operators/source-search.hh>
+#include <dune/gdt/spaces/cg/pdelab.hh>
+#include <dune/gdt/spaces/fv/default.hh>
+
+
+template< class GridImp >
+struct SourceSearch
+  : public ::testing::Test
+{
+  typedef GridImp                                                          GridType;
+  typedef typename GridType::LeafGridView                                  LeafGridViewType;
+  typedef typename GridType::LevelGridView                                 LevelGridViewType;
+  typedef Dune::GDT::Operators::BoundingBoxSourceSearch< LeafGridViewType > BoundingBoxSearchType;
+  typedef Dune::GDT::Operators::HierarchicalSourceSearch< LevelGridViewType > HierarchicalSearchType;
+  typedef typename BoundingBoxSearchType::DomainType                       DomainType;
+  typedef typename LeafGridViewType::template Codim< 0 >::Entity           EntityType;
+  typedef typename LeafGridViewType::ctype                                 DomainFieldType;
+  static const size_t                                                      dimDomain = LeafGridViewType::dimension;
+  typedef Dune::Stuff::LA::CommonDenseVector< double >                     VectorType;
+  typedef Dune::GDT::Operators::BoundingBoxSourceSearch< LevelGridViewType > LevelBoundingBoxSearchType;
+
+  SourceSearch()
+    : grid_provider_(0.0, 1.0, 3u)
+  {
+    grid_provider_.grid().globalRefine(2);
+  }
+
+  /// The center and the corners (moved slightly inwards) of each entity have to be located in the entity itself.
+  void bounding_box_search_finds_each_entity() const
+  {
+    const auto grid_view = grid_provider_.grid().leafGridView();
+    const BoundingBoxSearchType search(grid_view);
+    typename BoundingBoxSearchType::LocatedPointsType located_points;
+    std::vector< DomainType > local_points;
+    for (const auto& entity : DSC::entityRange(grid_view)) {
+      const auto geometry = entity.geometry();
+      const DomainType center = geometry.local(geometry.center());
+      local_points.assign(1, center);
+      for (int cc = 0; cc < geometry.corners(); ++cc) {
+        DomainType point = geometry.local(geometry.corner(cc));
+        point *= 0.9;
+        point.axpy(0.1, center);
+        local_points.push_back(point);
+      }
+      search.locate(entity, local_points, located_points);
+      ASSERT_EQ(size_t(1), located_points.entities.size());
+      EXPECT_EQ(grid_view.indexSet().index(entity), grid_view.indexSet().index(located_points.entities[0]));
+      ASSERT_EQ(local_points.size(), located_points.local_points.size());
+      for (size_t pp = 0; pp < local_points.size(); ++pp) {
+        EXPECT_EQ(size_t(0), located_points.entity_of_point[pp]);
+        EXPECT_LE((located_points.local_points[pp] - local_points[pp]).two_norm(), 1e-12);
+      }
+    }
+    // points outside of the grid are not found
+    const auto& entity = *grid_view.template begin< 0 >();
+    local_points.assign(1, entity.geometry().local(DomainType(2)));
+    search.locate(entity, local_points, located_points);
+    EXPECT_EQ(size_t(0), located_points.entities.size());
+    EXPECT_EQ(BoundingBoxSearchType::LocatedPointsType::not_found, located_points.entity_of_point[0]);
+  } // ... bounding_box_search_finds_each_entity(...)
+
+  /// On two independent (non-nested) grids, the bounding box search has to locate the center and the corners (moved
+  /// slightly inwards) of each entity of a grid with 5^d entities in the same entity of a grid with 3^d entities as a
+  /// brute force search over all entities of the latter.
+  void bounding_box_search_coincides_with_brute_force_search_on_independent_grids() const
+  {
+    const auto source_grid_view = grid_provider_.grid().levelGridView(0);
+    const Dune::Stuff::Grid::Providers::Cube< GridType > range_grid_provider(0.0, 1.0, 5u);
+    const auto range_grid_view = range_grid_provider.grid().leafGridView();
+    const LevelBoundingBoxSearchType search(source_grid_view);
+    typename LevelBoundingBoxSearchType::LocatedPointsType located_points;
+    std::vector< DomainType > local_points;
+    for (const auto& entity : DSC::entityRange(range_grid_view)) {
+      const auto geometry = entity.geometry();
+      const DomainType center = geometry.local(geometry.center());
+      local_points.assign(1, center);
+      for (int cc = 0; cc < geometry.corners(); ++cc) {
+        DomainType point = geometry.local(geometry.corner(cc));
+        point *= 0.9;
+        point.axpy(0.1, center);
+        local_points.push_back(point);
+      }
+      search.locate(entity, local_points, located_points);
+      ASSERT_EQ(local_points.size(), located_points.entity_of_point.size());
+      for (size_t pp = 0; pp < local_points.size(); ++pp) {
+        const auto global_point = geometry.global(local_points[pp]);
+        size_t found = 0;
+        for (const auto& source_entity : DSC::entityRange(source_grid_view)) {
+          const auto source_geometry = source_entity.geometry();
+          const DomainType source_local_point = source_geometry.local(global_point);
+          const auto& reference_element
+              = Dune::ReferenceElements< DomainFieldType, dimDomain >::general(source_entity.type());
+          if (!reference_element.checkInside(source_local_point))
+            continue;
+          ++found;
+          const size_t position = located_points.entity_of_point[pp];
+          ASSERT_NE(LevelBoundingBoxSearchType::LocatedPointsType::not_found, position);
+          EXPECT_EQ(source_grid_view.indexSet().index(source_entity),
+                    source_grid_view.indexSet().index(located_points.entities[position]));
+          EXPECT_LE((located_points.local_points[pp] - source_local_point).two_norm(), 1e-12);
+        }
+        EXPECT_EQ(size_t(1), found);
+      }
+    }
+  } // ... bounding_box_search_coincides_with_brute_force_search_on_independent_grids(...)
+
+  /// The hierarchical search has to locate the points of each leaf entity in the same entity of level 0 as the
+  /// bounding box search in the level 0 grid view.
+  void hierarchical_search_coincides_with_bounding_box_search() const
+  {
+    const auto& grid = grid_provider_.grid();
+    const auto level_grid_view = grid.levelGridView(0);
+    const HierarchicalSearchType hierarchical_search(level_grid_view);
+    const LevelBoundingBoxSearchType bounding_box_search(level_grid_view);
+    typename HierarchicalSearchType::LocatedPointsType hierarchically_located_points;
+    typename HierarchicalSearchType::LocatedPointsType spatially_located_points;
+    for (const auto& entity : DSC::entityRange(grid.leafGridView())) {
+      const auto geometry = entity.geometry();
+      const std::vector< DomainType > local_points(1, geometry.local(geometry.center()));
+      hierarchical_search.locate(entity, local_points, hierarchically_located_points);
+      bounding_box_search.locate(entity, local_points, spatially_located_points);
+      ASSERT_EQ(size_t(1), hierarchically_located_points.entities.size());
+      ASSERT_EQ(size_t(1), spatially_located_points.entities.size());
+      EXPECT_EQ(level_grid_view.indexSet().index(spatially_located_points.entities[0]),
+                level_grid_view.indexSet().index(hierarchically_located_points.entities[0]));
+      EXPECT_LE((hierarchically_located_points.local_points[0] - spatially_located_points.local_points[0]).two_norm(),
+                1e-12);
+    }
+  } // ... hierarchical_search_coincides_with_bounding_box_search(...)
+
+  /// The L2 prolongation of a piecewise constant function from level 0 onto the leaf grid view has to reproduce it,
+  /// using either search.
+  void l2_prolongation_reproduces_coarse_functions_with_both_searches() const
+  {
+    typedef Dune::GDT::Spaces::FV::Default< LevelGridViewType, double, 1 > CoarseSpaceType;
+    typedef Dune::GDT::Spaces::FV::Default< LeafGridViewType, double, 1 >  FineSpaceType;
+    const auto& grid = grid_provider_.grid();
+    const auto coarse_grid_view = grid.levelGridView(0);
+    const auto fine_grid_view = grid.leafGridView();
+    const CoarseSpaceType coarse_space(coarse_grid_view);
+    const FineSpaceType fine_space(fine_grid_view);
+    VectorType coarse_vector(coarse_space.mapper().size());
+    for (size_t ii = 0; ii < coarse_vector.size(); ++ii)
+      coarse_vector.set_entry(ii, double(ii + 1));
+    const Dune::GDT::ConstDiscreteFunction< CoarseSpaceType, VectorType > coarse_function(coarse_space, coarse_vector);
+    VectorType spatial_vector(fine_space.mapper().size());
+    VectorType hierarchical_vector(fine_space.mapper().size());
+    Dune::GDT::DiscreteFunction< FineSpaceType, VectorType > spatial_function(fine_space, spatial_vector);
+    Dune::GDT::DiscreteFunction< FineSpaceType, VectorType > hierarchical_function(fine_space, hierarchical_vector);
+    const Dune::GDT::Operators::L2Prolongation< LeafGridViewType > prolongation(fine_grid_view);
+    prolongation.apply(coarse_function, spatial_function, LevelBoundingBoxSearchType(coarse_grid_view));
+    prolongation.apply(coarse_function, hierarchical_function, HierarchicalSearchType(coarse_grid_view));
+    // each fine entity has to carry the value of the coarse entity containing it
+    for (const auto& entity : DSC::entityRange(fine_grid_view)) {
+      const auto center = entity.geometry().center();
+      size_t found = 0;
+      for (const auto& coarse_entity : DSC::entityRange(coarse_grid_view)) {
+        const auto& reference_element
+            = Dune::ReferenceElements< DomainFieldType, dimDomain >::general(coarse_entity.type());
+        if (!reference_element.checkInside(coarse_entity.geometry().local(center)))
+          continue;
+        const double expected = double(coarse_grid_view.indexSet().index(coarse_entity) + 1);
+        const size_t DoF = fine_space.mapper().mapToGlobal(entity, 0);
+        EXPECT_LE(std::abs(spatial_vector.get_entry(DoF) - expected), 1e-12 * expected);
+        EXPECT_LE(std::abs(hierarchical_vector.get_entry(DoF) - expected), 1e-12 * expected);
+        ++found;
+      }
+      EXPECT_EQ(size_t(1), found);
+    }
+  } // ... l2_prolongation_reproduces_coarse_functions_with_both_searches(...)
+
+#if HAVE_DUNE_PDELAB
+  /// The Lagrange prolongation of the interpolation of a linear function on level 0 onto the leaf grid view has to
+  /// coincide with the interpolation on the leaf grid view, using either search.
+  void lagrange_prolongation_reproduces_linear_functions_with_both_searches() const
+  {
+    typedef Dune::GDT::Spaces::CG::PdelabBased< LevelGridViewType, 1, double, 1 > CoarseSpaceType;
+    typedef Dune::GDT::Spaces::CG::PdelabBased< LeafGridViewType, 1, double, 1 >  FineSpaceType;
+    typedef Dune::Stuff::Functions::Expression< EntityType, DomainFieldType, dimDomain, double, 1 > FunctionType;
+    const FunctionType function("x", "x[0]", 1, "function");
+    const auto& grid = grid_provider_.grid();
+    const auto coarse_grid_view = grid.levelGridView(0);
+    const auto fine_grid_view = grid.leafGridView();
+    const CoarseSpaceType coarse_space(coarse_grid_view);
+    const FineSpaceType fine_space(fine_grid_view);
+    VectorType coarse_vector(coarse_space.mapper().size());
+    Dune::GDT::DiscreteFunction< CoarseSpaceType, VectorType > coarse_function(coarse_space, coarse_vector);
+    Dune::GDT::Operators::LagrangeProjection< LevelGridViewType >(coarse_grid_view).apply(function, coarse_function);
+    VectorType expected_vector(fine_space.mapper().size());
+    Dune::GDT::DiscreteFunction< FineSpaceType, VectorType > expected_function(fine_space, expected_vector);
+    Dune::GDT::Operators::LagrangeProjection< LeafGridViewType >(fine_grid_view).apply(function, expected_function);
+    VectorType spatial_vector(fine_space.mapper().size());
+    VectorType hierarchical_vector(fine_space.mapper().size());
+    Dune::GDT::DiscreteFunction< FineSpaceType, VectorType > spatial_function(fine_space, spatial_vector);
+    Dune::GDT::DiscreteFunction< FineSpaceType, VectorType > hierarchical_function(fine_space, hierarchical_vector);
+    const Dune::GDT::Operators::LagrangeProlongation< LeafGridViewType > prolongation(fine_grid_view);
+    prolongation.apply(coarse_function, spatial_function, LevelBoundingBoxSearchType(coarse_grid_view));
+    prolongation.apply(coarse_function, hierarchical_function, HierarchicalSearchType(coarse_grid_view));
+    EXPECT_LE((spatial_vector - expected_vector).sup_norm(), 1e-13);
+    EXPECT_LE((hierarchical_vector - expected_vector).sup_norm(), 1e-13);
+  } // ... lagrange_prolongation_reproduces_linear_functions_with_both_searches(...)
+#endif // HAVE_DUNE_PDELAB
+
+  Dune::Stuff::Grid::Providers::Cube< GridType > grid_provider_;
+}; // struct SourceSearch
+
+
+typedef testing::Types< Dune::YaspGrid< 1 >
+                      , Dune::YaspGrid< 2 >
+                      , Dune::YaspGrid< 3 >
+                      > GridTypes;
+
+TYPED_TEST_CASE(SourceSearch, GridTypes);
+TYPED_TEST(SourceSearch, bounding_box_search_finds_each_entity) {
+  this->bounding_box_search_finds_each_entity();
+}
+TYPED_TEST(SourceSearch, bounding_box_search_coincides_with_brute_force_search_on_independent_grids) {
+  this->bounding_box_search_coincides_with_brute_force_search_on_independent_grids();
+}
+TYPED_TEST(SourceSearch, hierarchical_search_coincides_with_bounding_box_search) {
+  this->hierarchical_search_coincides_with_bounding_box_search();
+}
+TYPED_TEST(SourceSearch, l2_prolongation_reproduces_coarse_functions_with_both_searches) {
+  this->l2_prolongation_reproduces_coarse_functions_with_both_searches();
+}
+#if HAVE_DUNE_PDELAB
+TYPED_TEST(SourceSearch, lagrange_prolongation_reproduces_linear_functions_with_both_searches) {
+  this->lagrange_prolongation_reproduces_linear_functions_with_both_searches();
+}
+#else // HAVE_DUNE_PDELAB
+TEST(DISABLED_SourceSearch, lagrange_prolongation_reproduces_linear_functions_with_both_searches) {}
+#endif // HAVE_DUNE_PDELAB
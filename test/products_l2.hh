@@ -6,6 +6,9 @@
 #ifndef DUNE_GDT_TEST_PRODUCTS_L2_HH
 #define DUNE_GDT_TEST_PRODUCTS_L2_HH
 
+#include <dune/stuff/la/container/eigen.hh>
+#include <dune/stuff/la/container/istl.hh>
+
 #include <dune/gdt/products/l2.hh>
 
 #include "products_weightedl2.hh"
@@ -64,6 +67,48 @@ struct L2AssemblableProduct
     product_tbb.assemble(true);
     const auto result_tbb = product_tbb.apply2(discrete_function, discrete_function);
     EXPECT_DOUBLE_EQ(result_tbb, result);
+    // only assemble the upper triangle
+    Product product_upper(MatrixStorage::upper_triangle, this->space_, this->space_.grid_view());
+    product_upper.assemble(false);
+    expect_upper_triangle_of(product.matrix(), product_upper.matrix());
+    EXPECT_DOUBLE_EQ(result, product_upper.apply2(discrete_function, discrete_function));
+    // reassembling reproduces the values
+    product.reassemble(false);
+    EXPECT_DOUBLE_EQ(result, product.apply2(discrete_function, discrete_function));
+#if HAVE_EIGEN
+    // the volume contributions to sparse matrices are added at precomputed offsets
+    typedef Products::L2Assemblable< Dune::Stuff::LA::EigenRowMajorSparseMatrix< RangeFieldType >,
+                                     SpaceType, GridViewType, SpaceType >                         SparseProduct;
+    SparseProduct sparse_product(this->space_);
+    sparse_product.assemble(false);
+    EXPECT_FALSE(bool(sparse_product.scatter_offsets(sparse_product.matrix())));
+    sparse_product.reassemble(false);
+    EXPECT_TRUE(bool(sparse_product.scatter_offsets(sparse_product.matrix())));
+    sparse_product.reassemble(true);
+    const auto& sparse_matrix = sparse_product.matrix();
+    for (size_t ii = 0; ii < sparse_matrix.rows(); ++ii)
+      for (size_t jj = 0; jj < sparse_matrix.cols(); ++jj)
+        EXPECT_DOUBLE_EQ(product.matrix().get_entry(ii, jj), sparse_matrix.get_entry(ii, jj));
+    // the upper triangle of sparse matrices is merged into their rows (and added at precomputed offsets)
+    SparseProduct sparse_product_upper(MatrixStorage::upper_triangle, this->space_, this->space_.grid_view());
+    sparse_product_upper.assemble(false);
+    expect_upper_triangle_of(product.matrix(), sparse_product_upper.matrix());
+    const auto eigen_vector = copy< Dune::Stuff::LA::EigenDenseVector< RangeFieldType > >(discrete_function.vector());
+    EXPECT_DOUBLE_EQ(result, sparse_product_upper.apply2(eigen_vector, eigen_vector));
+    sparse_product_upper.reassemble(true);
+    expect_upper_triangle_of(product.matrix(), sparse_product_upper.matrix());
+#endif // HAVE_EIGEN
+#if HAVE_DUNE_ISTL
+    typedef Products::L2Assemblable< Dune::Stuff::LA::IstlRowMajorSparseMatrix< RangeFieldType >,
+                                     SpaceType, GridViewType, SpaceType >                         IstlProduct;
+    IstlProduct istl_product_upper(MatrixStorage::upper_triangle, this->space_, this->space_.grid_view());
+    istl_product_upper.assemble(true);
+    expect_upper_triangle_of(product.matrix(), istl_product_upper.matrix());
+    const auto istl_vector = copy< Dune::Stuff::LA::IstlDenseVector< RangeFieldType > >(discrete_function.vector());
+    EXPECT_DOUBLE_EQ(result, istl_product_upper.apply2(istl_vector, istl_vector));
+    istl_product_upper.reassemble(false);
+    expect_upper_triangle_of(product.matrix(), istl_product_upper.matrix());
+#endif // HAVE_DUNE_ISTL
     return result;
   } // ... compute(...)
 
@@ -73,6 +118,24 @@ struct L2AssemblableProduct
     ProductType product(this->space_);
     AssemblableProductBase< SpaceType, ProductType, VectorType >::fulfills_interface(product);
   }
+
+private:
+  template< class M >
+  static void expect_upper_triangle_of(const MatrixType& matrix, const M& matrix_upper)
+  {
+    for (size_t ii = 0; ii < matrix_upper.rows(); ++ii)
+      for (size_t jj = 0; jj < matrix_upper.cols(); ++jj)
+        EXPECT_DOUBLE_EQ(jj < ii ? RangeFieldType(0) : matrix.get_entry(ii, jj), matrix_upper.get_entry(ii, jj));
+  }
+
+  template< class V >
+  static V copy(const VectorType& vector)
+  {
+    V ret(vector.size());
+    for (size_t ii = 0; ii < vector.size(); ++ii)
+      ret.set_entry(ii, vector.get_entry(ii));
+    return ret;
+  }
 }; // struct L2AssemblableProduct
 
 
@@ -10,9 +10,12 @@
 #endif
 
 #include <type_traits>
+#include <vector>
 
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <dune/geometry/quadraturerules.hh>
+
 #include <dune/stuff/grid/provider/cube.hh>
 #include <dune/stuff/test/gtest/gtest.h>
 
@@ -173,6 +176,12 @@ public:
     EXPECT_EQ(d_pattern_face, d_pattern_face_other);
     EXPECT_EQ(d_pattern_face, d_pattern_face_view);
     EXPECT_EQ(d_pattern_face, d_pattern_face_view_other);
+    space_.clear_pattern_cache();
+    EXPECT_EQ(d_pattern_volume, space_.compute_volume_pattern());
+    EXPECT_EQ(d_pattern_face_volume, space_.compute_face_and_volume_pattern());
+    EXPECT_EQ(d_pattern_face, space_.compute_face_pattern());
+    // cached patterns are not copied
+    EXPECT_EQ(&space_.compute_volume_pattern(), &space_.compute_volume_pattern(d_grid_view, space_));
     // * as the interface
     const InterfaceType& i_space = static_cast< const InterfaceType& >(space_);
     const I_BackendType& i_backend = i_space.backend();
@@ -289,6 +298,9 @@ public:
       i_mapper.globalIndices(entity, i_globalIndices);
       DynamicVector< size_t > i_globalIndices_return = i_mapper.globalIndices(entity);
       EXPECT_EQ(i_numDofs, d_numDofs);
+      // * the number of DoFs known at compile time (if any) has to be correct
+      if (fixed_num_dofs< SpaceType >::value > 0)
+        EXPECT_EQ(fixed_num_dofs< SpaceType >::value, d_numDofs);
       EXPECT_EQ(i_globalIndices, d_globalIndices);
       EXPECT_EQ(i_globalIndices_return, d_globalIndices_return);
       //   walk the local DoFs
@@ -378,6 +390,30 @@ public:
       EXPECT_EQ(&d_backend, &i_backend);
       size_t i_order = i_base_function_set.order();
       EXPECT_EQ(i_order, d_order);
+      // * the batch evaluation has to coincide with the evaluation at each point
+      const size_t size = i_base_function_set.size();
+      const auto& quadrature = QuadratureRules< D_DomainFieldType, d_dimDomain >::rule(
+                                 entity.type(), boost::numeric_cast< int >(2 * d_order));
+      std::vector< D_RangeType > all_values;
+      std::vector< D_JacobianRangeType > all_jacobians;
+      i_base_function_set.evaluate_all(quadrature, all_values);
+      i_base_function_set.jacobian_all(quadrature, all_jacobians);
+      EXPECT_EQ(all_values.size(), quadrature.size() * size);
+      EXPECT_EQ(all_jacobians.size(), quadrature.size() * size);
+      size_t qq = 0;
+      for (const auto& quadrature_point : quadrature) {
+        const auto values = i_base_function_set.evaluate(quadrature_point.position());
+        const auto jacobians = i_base_function_set.jacobian(quadrature_point.position());
+        for (size_t ii = 0; ii < size; ++ii) {
+          auto value_difference = values[ii];
+          value_difference -= all_values[qq * size + ii];
+          EXPECT_LE(value_difference.infinity_norm(), 1e-15);
+          auto jacobian_difference = jacobians[ii];
+          jacobian_difference -= all_jacobians[qq * size + ii];
+          EXPECT_LE(jacobian_difference.infinity_norm(), 1e-15);
+        }
+        ++qq;
+      }
     } // walk the grid
   } // ... basefunctionset_fulfills_interface()
 
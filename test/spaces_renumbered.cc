@@ -0,0 +1,150 @@
+// This file is part of the dune-gdt project:
+//   http://users.dune-project.org/projects/dune-gdt
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <dune/stuff/la/container/common.hh>
+
+#include <dune/gdt/products/l2.hh>
+#include <dune/gdt/spaces/renumbered.hh>
+
+#include "spaces.hh"
+#include "spaces_fv_default.hh"
+#include "spaces_cg_pdelab.hh"
+
+#define SPACE_RENUMBERED(ss) \
+  Spaces::Renumbered< ss >
+
+
+template< class SpaceType >
+class Renumbered_Space
+  : public SpaceBase< SpaceType >
+{
+public:
+  void renumbering_is_permutation() const
+  {
+    for (const auto renumbering : {Mapper::Renumbering::reverse_cuthill_mckee,
+                                   Mapper::Renumbering::space_filling_curve}) {
+      const SpaceType space(this->space_.space(), renumbering);
+      const auto& new_indices = *space.mapper().new_indices();
+      EXPECT_EQ(space.space().mapper().size(), new_indices.size());
+      std::vector< size_t > sorted(new_indices);
+      std::sort(sorted.begin(), sorted.end());
+      for (size_t ii = 0; ii < sorted.size(); ++ii)
+        EXPECT_EQ(ii, sorted[ii]);
+      for (const auto& entity : DSC::entityRange(space.grid_view())) {
+        const auto original = space.space().mapper().globalIndices(entity);
+        const auto renumbered = space.mapper().globalIndices(entity);
+        for (size_t ii = 0; ii < space.mapper().numDofs(entity); ++ii)
+          EXPECT_EQ(new_indices[original[ii]], renumbered[ii]);
+      }
+    }
+  } // ... renumbering_is_permutation(...)
+
+  void reverse_cuthill_mckee_reduces_bandwidth() const
+  {
+    // scramble the original numbering
+    const auto& original_mapper = this->space_.space().mapper();
+    auto scrambled_indices = std::make_shared< std::vector< size_t > >(original_mapper.size());
+    std::iota(scrambled_indices->begin(), scrambled_indices->end(), 0);
+    std::shuffle(scrambled_indices->begin(), scrambled_indices->end(), std::mt19937(42));
+    const Mapper::Renumbered< typename SpaceType::SpaceType::MapperType > scrambled_mapper(original_mapper,
+                                                                                           scrambled_indices);
+    const auto new_indices = Mapper::compute_renumbering(Mapper::Renumbering::reverse_cuthill_mckee,
+                                                         this->space_.grid_view(),
+                                                         scrambled_mapper);
+    std::vector< size_t > identity(new_indices.size());
+    std::iota(identity.begin(), identity.end(), 0);
+    const size_t scrambled_bandwidth = bandwidth(scrambled_mapper, identity);
+    const size_t renumbered_bandwidth = bandwidth(scrambled_mapper, new_indices);
+    if (original_mapper.maxNumDofs() > 1)
+      EXPECT_LT(renumbered_bandwidth, scrambled_bandwidth);
+    else
+      EXPECT_EQ(size_t(0), renumbered_bandwidth);
+  } // ... reverse_cuthill_mckee_reduces_bandwidth(...)
+
+  void pattern_and_product_are_permuted() const
+  {
+    typedef typename SpaceType::SpaceType                                       OriginalSpaceType;
+    typedef Stuff::LA::CommonDenseMatrix< typename SpaceType::RangeFieldType > MatrixType;
+    const auto& space = this->space_;
+    const auto& new_indices = *space.mapper().new_indices();
+    const auto original_pattern = space.space().compute_pattern();
+    const auto pattern = space.compute_pattern();
+    ASSERT_EQ(original_pattern.size(), pattern.size());
+    for (size_t ii = 0; ii < original_pattern.size(); ++ii) {
+      const auto& row = pattern.inner(new_indices[ii]);
+      EXPECT_EQ(original_pattern.inner(ii).size(), row.size());
+      for (const auto& jj : original_pattern.inner(ii))
+        EXPECT_TRUE(std::find(row.begin(), row.end(), new_indices[jj]) != row.end());
+    }
+    Products::L2Assemblable< MatrixType, OriginalSpaceType > original_product(space.space());
+    original_product.assemble();
+    Products::L2Assemblable< MatrixType, SpaceType > product(space);
+    product.assemble();
+    for (size_t ii = 0; ii < new_indices.size(); ++ii)
+      for (size_t jj = 0; jj < new_indices.size(); ++jj)
+        EXPECT_DOUBLE_EQ(original_product.matrix().get_entry(ii, jj),
+                         product.matrix().get_entry(new_indices[ii], new_indices[jj]));
+  } // ... pattern_and_product_are_permuted(...)
+
+private:
+  /// \brief The largest distance of the renumbered indices new_indices[...] of two DoFs of one entity.
+  template< class MapperType >
+  size_t bandwidth(const MapperType& mapper, const std::vector< size_t >& new_indices) const
+  {
+    size_t ret = 0;
+    for (const auto& entity : DSC::entityRange(this->space_.grid_view())) {
+      const auto global_indices = mapper.globalIndices(entity);
+      for (size_t ii = 0; ii < mapper.numDofs(entity); ++ii)
+        for (size_t jj = 0; jj < mapper.numDofs(entity); ++jj) {
+          const size_t row = new_indices[global_indices[ii]];
+          const size_t col = new_indices[global_indices[jj]];
+          ret = std::max(ret, row > col ? row - col : col - row);
+        }
+    }
+    return ret;
+  } // ... bandwidth(...)
+}; // class Renumbered_Space
+
+
+typedef testing::Types< SPACE_RENUMBERED(SPACE_FV_YASPGRID(1, 1))
+                      , SPACE_RENUMBERED(SPACE_FV_YASPGRID(2, 1))
+                      , SPACE_RENUMBERED(SPACE_FV_YASPGRID(3, 2))
+#if HAVE_DUNE_PDELAB
+                      , SPACE_RENUMBERED(SPACE_CG_PDELAB_YASPGRID(2, 1, 1))
+                      , SPACE_RENUMBERED(SPACE_CG_PDELAB_YASPGRID(3, 1, 1))
+#endif
+                      > Renumbered_Spaces;
+
+TYPED_TEST_CASE(Renumbered_Space, Renumbered_Spaces);
+TYPED_TEST(Renumbered_Space, fulfills_interface) {
+  this->fulfills_interface();
+}
+TYPED_TEST(Renumbered_Space, mapper_fulfills_interface) {
+  this->mapper_fulfills_interface();
+}
+TYPED_TEST(Renumbered_Space, basefunctionset_fulfills_interface) {
+  this->basefunctionset_fulfills_interface();
+}
+TYPED_TEST(Renumbered_Space, check_for_correct_copy) {
+  this->check_for_correct_copy();
+}
+TYPED_TEST(Renumbered_Space, renumbering_is_permutation) {
+  this->renumbering_is_permutation();
+}
+TYPED_TEST(Renumbered_Space, reverse_cuthill_mckee_reduces_bandwidth) {
+  this->reverse_cuthill_mckee_reduces_bandwidth();
+}
+TYPED_TEST(Renumbered_Space, pattern_and_product_are_permuted) {
+  this->pattern_and_product_are_permuted();
+}